@@ -0,0 +1,138 @@
+#include "CompactState.h"
+
+CompactState::CompactState(const juce::Array<juce::AudioProcessorParameter*>& parameters)
+{
+    for (auto* parameter : parameters)
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        jassert(ranged != nullptr);
+
+        if (ranged != nullptr)
+            entries.push_back({ hashParameterID(ranged->getParameterID()), ranged });
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
+
+    // Two IDs with one hash can't both be saved; rename one of them
+    jassert(std::adjacent_find(entries.begin(), entries.end(),
+                               [](const Entry& a, const Entry& b) { return a.hash == b.hash; }) == entries.end());
+}
+
+bool CompactState::isCompactState(const void* data, int sizeInBytes)
+{
+    return data != nullptr && sizeInBytes >= headerSize
+        && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+juce::uint32 CompactState::hashParameterID(const juce::String& parameterID)
+{
+    juce::uint32 hash = 2166136261u;
+
+    for (auto* c = parameterID.toRawUTF8(); *c != 0; ++c)
+    {
+        hash ^= static_cast<juce::uint8>(*c);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+void CompactState::write(juce::MemoryBlock& destData, const std::vector<Record>& extraRecords,
+                         const std::vector<Record>& parameterOverrides) const
+{
+    const auto count = entries.size() + extraRecords.size();
+    destData.setSize(static_cast<size_t>(headerSize) + static_cast<size_t>(recordSize) * count);
+    juce::MemoryOutputStream out(destData, false);
+
+    out.writeInt(static_cast<int>(magic));
+    out.writeShort(static_cast<short>(currentVersion));
+    out.writeShort(static_cast<short>(recordSize));
+    out.writeInt(static_cast<int>(count));
+
+    for (const auto& entry : entries)
+    {
+        float value = entry.parameter->convertFrom0to1(entry.parameter->getValue());
+
+        for (const auto& record : parameterOverrides)
+            if (record.hash == entry.hash)
+                value = record.value;
+
+        out.writeInt(static_cast<int>(entry.hash));
+        out.writeFloat(value);
+    }
+
+    for (const auto& record : extraRecords)
+    {
+        jassert(indexOf(record.hash) < 0);      // Would load as a parameter
+        out.writeInt(static_cast<int>(record.hash));
+        out.writeFloat(record.value);
+    }
+}
+
+bool CompactState::read(const void* data, int sizeInBytes, std::vector<Record>* extraRecords) const
+{
+    if (! isCompactState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+    in.readInt();
+    const int version = static_cast<juce::uint16>(in.readShort());
+    const int savedRecordSize = static_cast<juce::uint16>(in.readShort());
+    const auto count = static_cast<juce::uint32>(in.readInt());
+
+    // Checked in full before anything changes, so a damaged state leaves the plugin as it was
+    if (savedRecordSize < recordSize
+        || static_cast<juce::uint64>(count) * static_cast<juce::uint64>(savedRecordSize)
+               > static_cast<juce::uint64>(sizeInBytes - headerSize))
+        return false;
+
+    std::vector<bool> loaded(entries.size(), false);
+
+    for (juce::uint32 record = 0; record < count; ++record)
+    {
+        auto hash = static_cast<juce::uint32>(in.readInt());
+        auto value = in.readFloat();
+        in.skipNextBytes(savedRecordSize - recordSize);
+
+        if (version < currentVersion)
+            migrate(version, hash, value);
+
+        const int index = indexOf(hash);
+        if (index < 0)
+        {
+            if (extraRecords != nullptr)
+                extraRecords->push_back({ hash, value });
+
+            continue;
+        }
+
+        auto* parameter = entries[static_cast<size_t>(index)].parameter;
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        loaded[static_cast<size_t>(index)] = true;
+    }
+
+    for (size_t i = 0; i < entries.size(); ++i)
+        if (! loaded[i])
+            entries[i].parameter->setValueNotifyingHost(entries[i].parameter->getDefaultValue());
+
+    return true;
+}
+
+void CompactState::migrate(int savedVersion, juce::uint32& hash, float& value)
+{
+    // Version 1 is the first. A version that renames a parameter or changes its units adds
+    // a step here, oldest first, e.g.
+    //   if (savedVersion < 2 && hash == hashParameterID("oldId")) hash = hashParameterID("newId");
+    juce::ignoreUnused(savedVersion, hash, value);
+}
+
+int CompactState::indexOf(juce::uint32 hash) const
+{
+    const auto it = std::lower_bound(entries.begin(), entries.end(), hash,
+                                     [](const Entry& entry, juce::uint32 h) { return entry.hash < h; });
+
+    if (it == entries.end() || it->hash != hash)
+        return -1;
+
+    return static_cast<int>(it - entries.begin());
+}
@@ -0,0 +1,55 @@
+#include "BlockIIR.h"
+
+void BlockIIR::updateBasis(const Kernels::LR4Lanes& lanes)
+{
+    constexpr int length = Kernels::LR4BlockBasis::chunkLength;
+
+    // Lane 0 carries the low-pass coefficients, lane 2 the high-pass ones
+    for (int cascade = 0; cascade < 2; ++cascade)
+    {
+        const int lane = cascade * 2;
+        const float coeffs[5] = { lanes.b0[lane], lanes.b1[lane], lanes.b2[lane], lanes.a1[lane], lanes.a2[lane] };
+
+        if (basisValid && std::equal(std::begin(coeffs), std::end(coeffs), basisCoeffs[cascade]))
+            continue;
+
+        std::copy(std::begin(coeffs), std::end(coeffs), basisCoeffs[cascade]);
+        const double a1 = lanes.a1[lane];
+        const double a2 = lanes.a2[lane];
+
+        // Run the section with no input from each unit state
+        for (int unit = 0; unit < 2; ++unit)
+        {
+            double z1 = unit == 0 ? 1.0 : 0.0;
+            double z2 = unit == 1 ? 1.0 : 0.0;
+            float* response = unit == 0 ? basis.z1Response[cascade] : basis.z2Response[cascade];
+
+            for (int n = 0; n < length; ++n)
+            {
+                const double y = z1;
+                response[n] = std::abs(y) < 1.0e-30 ? 0.0f : static_cast<float>(y);   // No denormals in the kernel
+                z1 = -a1 * y + z2;
+                z2 = -a2 * y;
+            }
+
+            basis.transition[cascade][0][unit] = static_cast<float>(z1);
+            basis.transition[cascade][1][unit] = static_cast<float>(z2);
+        }
+    }
+
+    basisValid = true;
+}
+
+void BlockIIR::process(const Kernels::Table& kernels, Kernels::LR4Lanes& lanes, float* scratch,
+                       const float* inL, const float* inR,
+                       float* lowL, float* lowR, float* highL, float* highR, int numSamples)
+{
+    updateBasis(lanes);
+
+    const int done = kernels.lr4SplitBlock(lanes, basis, scratch, inL, inR,
+                                           lowL, lowR, highL, highR, numSamples);
+
+    if (done < numSamples)
+        kernels.lr4Split(lanes, inL + done, inR + done, lowL + done, lowR + done,
+                         highL + done, highR + done, numSamples - done);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Kernels.h"
+
+// Time-parallel evaluation of the LR4 cascades while the coefficients are constant, for
+// the large blocks of offline renders.
+//
+// Sample by sample, each cascade waits on its own previous output, so lr4Split is bound
+// by the latency of that recurrence rather than by arithmetic. lr4SplitBlock cuts the
+// block into chunks and filters many chunks side by side from zero state, then carries
+// the true state across chunks with the chunk's transition matrix and adds its zero-input
+// response back. This owns the chunk responses (worked out in double whenever the
+// coefficients change). The tiles live in scratch the caller provides, so the crossovers
+// of a processor, which run one after another, share one set. Results match per-sample
+// filtering to within float rounding.
+class BlockIIR
+{
+public:
+    static constexpr int minBlockSize = 2 * Kernels::LR4BlockBasis::groupLength;
+    static constexpr int scratchSize = 4 * Kernels::LR4BlockBasis::groupLength;   // Floats
+
+    // Same contract as lr4Split: state is updated as if run sample by sample and outputs
+    // may alias the inputs. Samples past the last whole group go through lr4Split.
+    void process(const Kernels::Table& kernels, Kernels::LR4Lanes& lanes, float* scratch,
+                 const float* inL, const float* inR,
+                 float* lowL, float* lowR, float* highL, float* highR, int numSamples);
+
+private:
+    void updateBasis(const Kernels::LR4Lanes& lanes);
+
+    Kernels::LR4BlockBasis basis;
+    float basisCoeffs[2][5] {};
+    bool basisValid = false;
+};
@@ -0,0 +1,224 @@
+#include "Crossover.h"
+
+void LR4Crossover::prepare(double sampleRate, float frequencyHz)
+{
+    currentSampleRate = sampleRate;
+    kernels = &Kernels::getBestTable();
+
+    table = DSPUtils::SharedTableCache::get<DSPUtils::CrossoverTable>(sampleRate);
+    minLogFrequency = std::log2(DSPUtils::CrossoverTable::minFrequency);
+    maxLogFrequency = std::log2(table->getMaxFrequency());
+
+    // The smoother only ticks once per control interval
+    logFrequency.reset(sampleRate / controlInterval, 20.0f);
+    logFrequency.setCurrentAndTargetValue(std::clamp(std::log2(frequencyHz), minLogFrequency, maxLogFrequency));
+    samplesUntilUpdate = 0;
+
+    updateCoefficients();
+    reset();
+}
+
+void LR4Crossover::reset()
+{
+    for (int section = 0; section < 2; ++section)
+    {
+        std::fill(std::begin(biquadLanes.z1[section]), std::end(biquadLanes.z1[section]), 0.0f);
+        std::fill(std::begin(biquadLanes.z2[section]), std::end(biquadLanes.z2[section]), 0.0f);
+    }
+
+    for (auto* history : { allpassX1, allpassX2, allpassY1, allpassY2 })
+        std::fill(history, history + 2, 0.0f);
+
+    svfStateL1.reset();
+    svfStateL2.reset();
+    svfStateR1.reset();
+    svfStateR2.reset();
+}
+
+void LR4Crossover::setEngine(Engine newEngine)
+{
+    if (newEngine == engine)
+        return;
+
+    engine = newEngine;
+    reset();
+
+    if (table != nullptr)
+        updateCoefficients();
+}
+
+void LR4Crossover::setFrequency(float frequencyHz)
+{
+    if (table == nullptr)
+        return;
+
+    logFrequency.setTargetValue(std::clamp(std::log2(frequencyHz), minLogFrequency, maxLogFrequency));
+}
+
+void LR4Crossover::snapToTarget()
+{
+    logFrequency.setCurrentAndTargetValue(logFrequency.getTargetValue());
+    samplesUntilUpdate = 0;
+
+    if (table != nullptr)
+        updateCoefficients();
+}
+
+void LR4Crossover::updateCoefficients()
+{
+    if (engine == Engine::StateVariable)
+        svfCoeffs = DSPUtils::calcSVF(currentSampleRate, std::exp2(logFrequency.getCurrentValue()));
+    else
+    {
+        DSPUtils::BiquadCoeffs lp, hp;
+        table->lookup(logFrequency.getCurrentValue(), lp, hp);
+
+        // Lanes: low L, low R, high L, high R
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            const auto& c = lane < 2 ? lp : hp;
+            biquadLanes.b0[lane] = c.b0;
+            biquadLanes.b1[lane] = c.b1;
+            biquadLanes.b2[lane] = c.b2;
+            biquadLanes.a1[lane] = c.a1;
+            biquadLanes.a2[lane] = c.a2;
+        }
+    }
+}
+
+void LR4Crossover::process(const float* inL, const float* inR,
+                           float* lowL, float* lowR, float* highL, float* highR, int numSamples)
+{
+    // Steady frequency: nothing to retune, so the block goes in one run, and a big one
+    // is filtered along time instead of sample by sample
+    if (! logFrequency.isSmoothing())
+    {
+        samplesUntilUpdate = 0;
+
+        if (engine == Engine::StateVariable)
+            processStateVariable(inL, inR, lowL, lowR, highL, highR, 0, numSamples);
+        else if (blockScratch != nullptr && numSamples >= BlockIIR::minBlockSize)
+            blockIIR.process(*kernels, biquadLanes, blockScratch, inL, inR, lowL, lowR, highL, highR, numSamples);
+        else
+            kernels->lr4Split(biquadLanes, inL, inR, lowL, lowR, highL, highR, numSamples);
+
+        return;
+    }
+
+    int i = 0;
+
+    while (i < numSamples)
+    {
+        const int end = i + nextSegment(numSamples - i);
+
+        if (engine == Engine::StateVariable)
+            processStateVariable(inL, inR, lowL, lowR, highL, highR, i, end);
+        else
+            kernels->lr4Split(biquadLanes, inL + i, inR + i, lowL + i, lowR + i, highL + i, highR + i, end - i);
+
+        i = end;
+    }
+}
+
+void LR4Crossover::processAllpass(float* left, float* right, int numSamples)
+{
+    // Steady frequency: one run for the whole block
+    if (! logFrequency.isSmoothing())
+    {
+        samplesUntilUpdate = 0;
+        processAllpassRun(left, right, 0, numSamples);
+        return;
+    }
+
+    for (int i = 0; i < numSamples;)
+    {
+        const int end = i + nextSegment(numSamples - i);
+        processAllpassRun(left, right, i, end);
+        i = end;
+    }
+}
+
+void LR4Crossover::processAllpassRun(float* left, float* right, int begin, int end)
+{
+    if (engine == Engine::StateVariable)
+    {
+        const float allpassGain = 2.0f * svfCoeffs.k;
+
+        for (int j = begin; j < end; ++j)
+        {
+            float bpL, bpR;
+            svfStateL1.process(left[j], svfCoeffs, bpL);
+            svfStateR1.process(right[j], svfCoeffs, bpR);
+
+            left[j] -= allpassGain * bpL;
+            right[j] -= allpassGain * bpR;
+        }
+
+        return;
+    }
+
+    // The Butterworth denominator over its mirror image. Direct form I, so the only
+    // sample-to-sample dependency is through y[n-1]; the history lives in locals
+    // because the output stores could otherwise alias it.
+    const float a1 = biquadLanes.a1[0];
+    const float a2 = biquadLanes.a2[0];
+    float x1L = allpassX1[0], x2L = allpassX2[0], y1L = allpassY1[0], y2L = allpassY2[0];
+    float x1R = allpassX1[1], x2R = allpassX2[1], y1R = allpassY1[1], y2R = allpassY2[1];
+
+    for (int j = begin; j < end; ++j)
+    {
+        const float xL = left[j], xR = right[j];
+        const float yL = (a2 * (xL - y2L) + a1 * x1L + x2L) - a1 * y1L;
+        const float yR = (a2 * (xR - y2R) + a1 * x1R + x2R) - a1 * y1R;
+
+        x2L = x1L;  x1L = xL;  y2L = y1L;  y1L = yL;
+        x2R = x1R;  x1R = xR;  y2R = y1R;  y1R = yR;
+
+        left[j] = yL;
+        right[j] = yR;
+    }
+
+    allpassX1[0] = x1L;  allpassX2[0] = x2L;  allpassY1[0] = y1L;  allpassY2[0] = y2L;
+    allpassX1[1] = x1R;  allpassX2[1] = x2R;  allpassY1[1] = y1R;  allpassY2[1] = y2R;
+}
+
+int LR4Crossover::nextSegment(int numRemaining)
+{
+    // Retune at each control interval boundary while the frequency glides
+    if (samplesUntilUpdate == 0)
+    {
+        if (logFrequency.isSmoothing())
+        {
+            logFrequency.getNextValue();
+            updateCoefficients();
+        }
+
+        samplesUntilUpdate = controlInterval;
+    }
+
+    const int length = std::min(samplesUntilUpdate, numRemaining);
+    samplesUntilUpdate -= length;
+    return length;
+}
+
+void LR4Crossover::processStateVariable(const float* inL, const float* inR,
+                                        float* lowL, float* lowR, float* highL, float* highR, int begin, int end)
+{
+    // Butterworth SVF: allpass = x - 2k*bp, and LR4 low + LR4 high = that allpass
+    const float allpassGain = 2.0f * svfCoeffs.k;
+
+    for (int i = begin; i < end; ++i)
+    {
+        const float left = inL[i];
+        const float right = inR[i];
+        float bpL, bpR, unused;
+
+        const float lowOutL = svfStateL2.process(svfStateL1.process(left, svfCoeffs, bpL), svfCoeffs, unused);
+        const float lowOutR = svfStateR2.process(svfStateR1.process(right, svfCoeffs, bpR), svfCoeffs, unused);
+
+        lowL[i] = lowOutL;
+        lowR[i] = lowOutR;
+        highL[i] = (left - allpassGain * bpL) - lowOutL;
+        highR[i] = (right - allpassGain * bpR) - lowOutR;
+    }
+}
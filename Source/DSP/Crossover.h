@@ -0,0 +1,89 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPUtils.h"
+#include "Kernels.h"
+#include "BlockIIR.h"
+
+// Stereo Linkwitz-Riley 4th order split with a sweepable frequency.
+// The frequency is smoothed in the log domain and the filters are retuned every
+// controlInterval samples, so automation never jumps the coefficients.
+//
+// Two engines produce the same response:
+//  - Biquad: two cascaded 2nd order Butterworth sections per band, coefficients
+//    interpolated from the shared CrossoverTable (no trig on the audio thread).
+//    All four cascades run side by side in the CPU-dispatched lr4Split kernel, or
+//    through BlockIIR for large blocks while the frequency is steady.
+//  - StateVariable: TPT state-variable filters. The low band is two cascaded SVF
+//    low-passes and the high band is the first SVF's allpass minus the low band, so
+//    the bands share state, sum exactly to an allpass and retune with one tan().
+class LR4Crossover
+{
+public:
+    enum class Engine
+    {
+        Biquad = 0,
+        StateVariable
+    };
+
+    static constexpr int controlInterval = 16;  // Samples between retunes while sweeping
+
+    void prepare(double sampleRate, float frequencyHz);
+    void reset();
+
+    // Switching engines clears the filter state
+    void setEngine(Engine newEngine);
+    Engine getEngine() const { return engine; }
+
+    // Time-parallel processing of large steady blocks, in BlockIIR::scratchSize floats of
+    // scratch that the crossovers of a processor can share. Off while there is none.
+    void setBlockScratch(float* scratch) { blockScratch = scratch; }
+
+    // Sets the target frequency; the filters glide there over ~20 ms
+    void setFrequency(float frequencyHz);
+    float getTargetFrequency() const { return std::exp2(logFrequency.getTargetValue()); }
+    bool isSweeping() const { return logFrequency.isSmoothing(); }
+
+    // Ends any glide at the target, for an instance that sat idle while the target moved
+    void snapToTarget();
+
+    // Splits numSamples of left/right into low and high bands. Outputs may alias the inputs.
+    void process(const float* inL, const float* inR,
+                 float* lowL, float* lowR, float* highL, float* highR, int numSamples);
+
+    // Runs only the allpass that low + high sum to, in place, with the same glide.
+    // Used where the low band is made elsewhere (see Multirate.h) and the rest is
+    // allpass minus low; it has its own state, so don't mix it with process().
+    void processAllpass(float* left, float* right, int numSamples);
+
+private:
+    void updateCoefficients();
+    int nextSegment(int numRemaining);
+    void processAllpassRun(float* left, float* right, int begin, int end);
+    void processStateVariable(const float* inL, const float* inR,
+                              float* lowL, float* lowR, float* highL, float* highR, int begin, int end);
+
+    Engine engine = Engine::Biquad;
+    double currentSampleRate = 44100.0;
+
+    std::shared_ptr<const DSPUtils::CrossoverTable> table;
+    DSPUtils::SmoothedValue logFrequency;   // log2(Hz), advanced once per control interval
+    float minLogFrequency = 0.0f;
+    float maxLogFrequency = 0.0f;
+    int samplesUntilUpdate = 0;
+
+    // Biquad engine
+    const Kernels::Table* kernels = nullptr;
+    Kernels::LR4Lanes biquadLanes;
+
+    // Large-block path for the biquad engine
+    BlockIIR blockIIR;
+    float* blockScratch = nullptr;
+
+    // State-variable engine
+    DSPUtils::SVFCoeffs svfCoeffs;
+    DSPUtils::SVFState svfStateL1, svfStateL2, svfStateR1, svfStateR2;
+
+    // processAllpass() state for the biquad engine (the SVF engine reuses its first stages)
+    float allpassX1[2] {}, allpassX2[2] {}, allpassY1[2] {}, allpassY2[2] {};
+};
@@ -2,6 +2,10 @@
 
 #include <cmath>
 #include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace DSPUtils
 {
@@ -122,6 +126,48 @@ namespace DSPUtils
         }
     };
 
+    // Topology-preserving (zero-delay feedback) state-variable filter, after Zavalishin/Simper.
+    // The state is the integrator charge, so it stays meaningful when the cutoff moves and
+    // a frequency change only needs one tan().
+    struct SVFCoeffs
+    {
+        float g = 0.0f, k = 1.4142135623730951f;
+        float a1 = 1.0f, a2 = 0.0f, a3 = 0.0f;
+    };
+
+    inline SVFCoeffs calcSVF(double sampleRate, float freq, float q = 0.7071067811865476f)
+    {
+        SVFCoeffs c;
+        c.g = static_cast<float>(std::tan(3.14159265358979323846 * freq / sampleRate));
+        c.k = 1.0f / q;
+        c.a1 = 1.0f / (1.0f + c.g * (c.g + c.k));
+        c.a2 = c.g * c.a1;
+        c.a3 = c.g * c.a2;
+        return c;
+    }
+
+    struct SVFState
+    {
+        float ic1eq = 0.0f, ic2eq = 0.0f;
+
+        void reset()
+        {
+            ic1eq = ic2eq = 0.0f;
+        }
+
+        // Returns the low-pass output, band-pass through bp (high-pass = x - k*bp - lp)
+        inline float process(float input, const SVFCoeffs& c, float& bp)
+        {
+            float v3 = input - ic2eq;
+            float v1 = c.a1 * ic1eq + c.a2 * v3;
+            float v2 = ic2eq + c.a2 * ic1eq + c.a3 * v3;
+            ic1eq = 2.0f * v1 - ic1eq;
+            ic2eq = 2.0f * v2 - ic2eq;
+            bp = v1;
+            return v2;
+        }
+    };
+
     // Parameter smoothing
     class SmoothedValue
     {
@@ -143,17 +189,175 @@ namespace DSPUtils
 
         float getNextValue()
         {
-            currentValue += coeff * (targetValue - currentValue);
+            const float nextValue = currentValue + coeff * (targetValue - currentValue);
+
+            // At high rates the step can round away in float before the value is within
+            // the threshold, so land on the target instead of stalling just short of it
+            if (nextValue == currentValue || std::abs(nextValue - targetValue) <= settledThreshold)
+                currentValue = targetValue;
+            else
+                currentValue = nextValue;
+
             return currentValue;
         }
 
         float getCurrentValue() const { return currentValue; }
         float getTargetValue() const { return targetValue; }
-        bool isSmoothing() const { return std::abs(currentValue - targetValue) > 0.0001f; }
+        bool isSmoothing() const { return std::abs(currentValue - targetValue) > settledThreshold; }
 
     private:
+        static constexpr float settledThreshold = 0.0001f;
+
         float currentValue = 0.0f;
         float targetValue = 0.0f;
         float coeff = 0.1f;
     };
+
+    //==============================================================================
+    // Process-wide cache of immutable lookup tables shared by every plugin instance.
+    // Tables are keyed by type and sample rate, built on first request (call from
+    // prepare(), never the audio thread) and freed when the last instance lets go.
+    enum class TableType
+    {
+        PanLaw,
+        CrossoverGrid
+    };
+
+    class SharedTableCache
+    {
+    public:
+        template <typename Table>
+        static std::shared_ptr<const Table> get(double sampleRate)
+        {
+            auto& cache = instance();
+            const Key key { Table::type, Table::dependsOnSampleRate ? static_cast<long long>(sampleRate * 1000.0) : 0 };
+
+            std::lock_guard<std::mutex> lock(cache.mutex);
+
+            if (auto existing = std::static_pointer_cast<const Table>(cache.tables[key].lock()))
+                return existing;
+
+            auto table = std::make_shared<const Table>(sampleRate);
+            cache.tables[key] = table;
+            return table;
+        }
+
+    private:
+        using Key = std::pair<TableType, long long>;
+
+        static SharedTableCache& instance()
+        {
+            static SharedTableCache cache;
+            return cache;
+        }
+
+        std::mutex mutex;
+        std::map<Key, std::weak_ptr<const void>> tables;
+    };
+
+    // Constant-power pan gains over pan = -1..+1, linearly interpolated
+    struct PanLawTable
+    {
+        static constexpr TableType type = TableType::PanLaw;
+        static constexpr bool dependsOnSampleRate = false;
+        static constexpr int size = 512;
+
+        explicit PanLawTable(double /*sampleRate*/)
+        {
+            for (int i = 0; i <= size; ++i)
+            {
+                double angle = (static_cast<double>(i) / size) * 0.5 * 3.14159265358979323846; // 0 to pi/2
+                leftGain[i] = static_cast<float>(std::cos(angle));
+                rightGain[i] = static_cast<float>(std::sin(angle));
+            }
+        }
+
+        inline void getGains(float pan, float& left, float& right) const
+        {
+            float position = std::clamp((pan + 1.0f) * 0.5f, 0.0f, 1.0f) * size;
+            int index = std::min(static_cast<int>(position), size - 1);
+            float frac = position - static_cast<float>(index);
+
+            left = leftGain[index] + frac * (leftGain[index + 1] - leftGain[index]);
+            right = rightGain[index] + frac * (rightGain[index + 1] - rightGain[index]);
+        }
+
+        std::array<float, size + 1> leftGain {};
+        std::array<float, size + 1> rightGain {};
+    };
+
+    // Linkwitz-Riley section coefficients on a log-frequency grid for one sample rate.
+    // Lookups interpolate linearly between neighbouring grid points. That is safe for
+    // direct-form coefficients: the biquad stability region in (a1, a2) is convex, so a
+    // blend of two stable sections is stable, and at 1/48 octave spacing the blend is
+    // within a small fraction of a dB of the exact design.
+    struct CrossoverTable
+    {
+        static constexpr TableType type = TableType::CrossoverGrid;
+        static constexpr bool dependsOnSampleRate = true;
+        static constexpr float minFrequency = 10.0f;
+        static constexpr int pointsPerOctave = 48;
+        static constexpr int maxPoints = 12 * pointsPerOctave + 1;     // 10 Hz to ~41 kHz
+
+        explicit CrossoverTable(double sampleRate)
+        {
+            // Stay clear of Nyquist, where the bilinear designs degenerate
+            const double maxFrequency = std::min(0.45 * sampleRate, 40000.0);
+            numPoints = std::min(maxPoints,
+                                 static_cast<int>(std::log2(maxFrequency / minFrequency) * pointsPerOctave) + 1);
+
+            for (int i = 0; i < numPoints; ++i)
+            {
+                double freq = minFrequency * std::exp2(static_cast<double>(i) / pointsPerOctave);
+                double w0 = 2.0 * 3.14159265358979323846 * freq / sampleRate;
+                double cosw0 = std::cos(w0);
+                double alpha = std::sin(w0) / (2.0 * 0.7071067811865476);
+                double a0 = 1.0 + alpha;
+
+                lowPass[i].b0 = static_cast<float>(((1.0 - cosw0) / 2.0) / a0);
+                lowPass[i].b1 = static_cast<float>((1.0 - cosw0) / a0);
+                lowPass[i].b2 = lowPass[i].b0;
+                lowPass[i].a1 = static_cast<float>((-2.0 * cosw0) / a0);
+                lowPass[i].a2 = static_cast<float>((1.0 - alpha) / a0);
+
+                highPass[i].b0 = static_cast<float>(((1.0 + cosw0) / 2.0) / a0);
+                highPass[i].b1 = static_cast<float>((-(1.0 + cosw0)) / a0);
+                highPass[i].b2 = highPass[i].b0;
+                highPass[i].a1 = lowPass[i].a1;
+                highPass[i].a2 = lowPass[i].a2;
+            }
+        }
+
+        float getMaxFrequency() const
+        {
+            return minFrequency * std::exp2(static_cast<float>(numPoints - 1) / pointsPerOctave);
+        }
+
+        // Coefficients for a frequency given as log2(Hz)
+        inline void lookup(float log2Freq, BiquadCoeffs& lp, BiquadCoeffs& hp) const
+        {
+            float position = (log2Freq - std::log2(minFrequency)) * pointsPerOctave;
+            position = std::clamp(position, 0.0f, static_cast<float>(numPoints - 1));
+            int index = std::min(static_cast<int>(position), numPoints - 2);
+            float frac = position - static_cast<float>(index);
+
+            auto blend = [frac](const BiquadCoeffs& a, const BiquadCoeffs& b)
+            {
+                BiquadCoeffs c;
+                c.b0 = a.b0 + frac * (b.b0 - a.b0);
+                c.b1 = a.b1 + frac * (b.b1 - a.b1);
+                c.b2 = a.b2 + frac * (b.b2 - a.b2);
+                c.a1 = a.a1 + frac * (b.a1 - a.a1);
+                c.a2 = a.a2 + frac * (b.a2 - a.a2);
+                return c;
+            };
+
+            lp = blend(lowPass[index], lowPass[index + 1]);
+            hp = blend(highPass[index], highPass[index + 1]);
+        }
+
+        int numPoints = 0;
+        std::array<BiquadCoeffs, maxPoints> lowPass {};
+        std::array<BiquadCoeffs, maxPoints> highPass {};
+    };
 }
@@ -0,0 +1,157 @@
+#include "Decorrelator.h"
+
+void Decorrelator::prepare(double sampleRate, int maxBlockSize)
+{
+    kernels = &Kernels::getBestTable();
+
+    // Sections log-spaced from 250 Hz to 10 kHz, so the phase between D and the mid
+    // keeps turning over the range where width is heard. Alternating Q stops the
+    // group delay piling up at one frequency.
+    constexpr int numSections = Kernels::AllpassLanes::numSections;
+    const double maxFrequency = std::min(10000.0, 0.4 * sampleRate);
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        const double position = static_cast<double>(section) / (numSections - 1);
+        const auto frequency = static_cast<float>(250.0 * std::pow(maxFrequency / 250.0, position));
+        const auto coeffs = DSPUtils::calcAllPass(sampleRate, frequency, section % 2 == 0 ? 0.7f : 1.6f);
+
+        cascade.a1[section] = coeffs.a1;
+        cascade.a2[section] = coeffs.a2;
+    }
+
+    lowCut = DSPUtils::calcHighPassLR(sampleRate, 200.0f);
+
+    for (auto* buffer : { &mid, &side, &decorrelated })
+        buffer->assign(static_cast<size_t>(std::max(1, maxBlockSize)), 0.0f);
+
+    glideSamples = static_cast<float>(0.05 * sampleRate);
+    reset();
+}
+
+void Decorrelator::reset()
+{
+    constexpr int numSections = Kernels::AllpassLanes::numSections;
+    std::fill(cascade.z1, cascade.z1 + numSections, 0.0f);
+    std::fill(cascade.z2, cascade.z2 + numSections, 0.0f);
+
+    for (auto& step : cascade.pipeline)
+        std::fill(std::begin(step), std::end(step), 0.0f);
+
+    cascade.pipelineIndex = 0;
+
+    lowCutState.reset();
+    windowMid = windowSide = windowDecorrelated = windowCross = 0.0f;
+    windowCount = 0;
+    currentGain = targetGain = 0.0f;
+}
+
+void Decorrelator::setTargetCorrelation(float target)
+{
+    targetCorrelation = std::clamp(target, 0.0f, 1.0f);
+}
+
+void Decorrelator::setEnabled(bool shouldDecorrelate)
+{
+    enabled = shouldDecorrelate;
+
+    if (! enabled)
+        targetGain = 0.0f;
+}
+
+void Decorrelator::process(float* left, float* right, int numSamples)
+{
+    jassert(numSamples <= static_cast<int>(mid.size()));
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        mid[(size_t) i] = (left[i] + right[i]) * 0.5f;
+        side[(size_t) i] = (left[i] - right[i]) * 0.5f;
+    }
+
+    kernels->allpassCascade(cascade, mid.data(), decorrelated.data(), numSamples);
+
+    // Low cut, with its state in locals so the stores can't alias it
+    {
+        const auto& c = lowCut;
+        float z1 = lowCutState.z1, z2 = lowCutState.z2;
+        float* data = decorrelated.data();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = data[i];
+            const float y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            data[i] = y;
+        }
+
+        lowCutState.z1 = z1;
+        lowCutState.z2 = z2;
+    }
+
+    // Window energies, in runs that stop at each window boundary
+    for (int i = 0; i < numSamples;)
+    {
+        const int runEnd = std::min(numSamples, i + (windowSize - windowCount));
+
+        float midSums[3] = { 0.0f, windowMid, 0.0f };                    // mid * D, mid^2, D^2
+        float sideSums[3] = { windowCross, windowSide, windowDecorrelated };  // side * D, side^2, D^2
+        kernels->correlationSums(mid.data() + i, decorrelated.data() + i, runEnd - i, midSums);
+        kernels->correlationSums(side.data() + i, decorrelated.data() + i, runEnd - i, sideSums);
+        windowMid = midSums[1];
+        windowCross = sideSums[0];
+        windowSide = sideSums[1];
+        windowDecorrelated = sideSums[2];
+
+        windowCount += runEnd - i;
+        i = runEnd;
+
+        if (windowCount >= windowSize)
+            updateGain();
+    }
+
+    // Complementary: +D left, -D right. The amount glides towards each window's solution
+    // as a ramp per block (one exp per block rather than a smoother step per sample).
+    const float startGain = currentGain;
+    currentGain += (targetGain - currentGain) * (1.0f - std::exp(-static_cast<float>(numSamples) / glideSamples));
+    const float step = (currentGain - startGain) / static_cast<float>(numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float added = (startGain + step * static_cast<float>(i + 1)) * decorrelated[(size_t) i];
+        left[i] += added;
+        right[i] -= added;
+    }
+
+    // Faded out: start clean next time it's switched on
+    if (! enabled && currentGain < 1.0e-4f)
+        reset();
+}
+
+void Decorrelator::updateGain()
+{
+    // With L = M + S', R = M - S' the correlation is (M^2 - S'^2) / (M^2 + S'^2) (the
+    // M * S' terms mostly cancel), so the target needs S'^2 = M^2 (1 - c) / (1 + c).
+    // S' = S + g D, so solve g^2 D^2 + 2g SD + S^2 - needed = 0 for the positive root.
+    const float needed = windowMid * (1.0f - targetCorrelation) / (1.0f + targetCorrelation);
+    const float shortfall = needed - windowSide;
+
+    // Silence keeps the last amount rather than jumping on noise
+    if (enabled && windowDecorrelated > 1.0e-9f)
+    {
+        float newGain = 0.0f;
+
+        if (shortfall > 0.0f)
+        {
+            const float root = std::sqrt(windowCross * windowCross + windowDecorrelated * shortfall);
+            newGain = (root - windowCross) / windowDecorrelated;
+        }
+
+        // D is as loud as the mid at most, more would tip the image out of phase
+        targetGain = std::clamp(newGain, 0.0f, 1.0f);
+    }
+
+    windowMid = windowSide = windowDecorrelated = windowCross = 0.0f;
+    windowCount = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPUtils.h"
+#include "Kernels.h"
+
+// Mono-compatible widening for narrow sources. Width only scales the side signal, so
+// it can't widen what has none; this makes some from the mid instead.
+//
+// The mid runs through a short cascade of second-order allpasses (DSPUtils::calcAllPass,
+// spread over the midrange, evaluated by the allpassCascade kernel), is low-cut, and goes
+// to the side: left gets +D and right -D. The mono sum is untouched, while left and right
+// drift in and out of phase across the spectrum. Once per correlation window (the meter's
+// length) the amount of D is solved from the window's mid, side and D energies so the
+// output lands on the target correlation; sources already wider than that get none.
+class Decorrelator
+{
+public:
+    static constexpr int windowSize = 2048;        // Same as the correlation meter
+
+    Decorrelator() = default;
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // 0 = uncorrelated, 1 = leave the source as it is
+    void setTargetCorrelation(float target);
+
+    // Switching off fades the added signal out; the stage stays active until it has
+    void setEnabled(bool shouldDecorrelate);
+    bool isActive() const { return enabled || currentGain > 0.0f; }
+
+    // In place; numSamples up to the prepared block size
+    void process(float* left, float* right, int numSamples);
+
+private:
+    void updateGain();
+
+    const Kernels::Table* kernels = nullptr;
+    Kernels::AllpassLanes cascade;
+
+    DSPUtils::BiquadCoeffs lowCut;      // Keeps the lows out of the side
+    DSPUtils::BiquadState lowCutState;
+
+    std::vector<float> mid, side, decorrelated;
+
+    // Energies over the current window: mid^2, side^2, D^2, side * D
+    float windowMid = 0.0f, windowSide = 0.0f, windowDecorrelated = 0.0f, windowCross = 0.0f;
+    int windowCount = 0;
+
+    float targetCorrelation = 1.0f;
+    bool enabled = false;
+    float currentGain = 0.0f, targetGain = 0.0f;    // Of D, re-solved every window
+    float glideSamples = 2400.0f;                   // Time constant of the glide (50 ms)
+
+    JUCE_DECLARE_NON_COPYABLE(Decorrelator)
+};
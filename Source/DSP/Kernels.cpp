@@ -0,0 +1,97 @@
+#include <JuceHeader.h>
+#include "Kernels.h"
+
+#ifndef STEREOIMAGER_X86_KERNELS
+ #define STEREOIMAGER_X86_KERNELS 0
+#endif
+
+// Baseline build of the kernels, compiled with the plugin's own flags
+#if JUCE_ARM
+ #define KERNELS_NAME "NEON"
+#else
+ #define KERNELS_NAME "SSE2"
+#endif
+#define KERNELS_NAMESPACE KernelsBaseline
+#include "KernelsImpl.h"
+#undef KERNELS_NAMESPACE
+#undef KERNELS_NAME
+
+#if STEREOIMAGER_X86_KERNELS
+namespace KernelsAVX2   { extern const Kernels::Table table; }
+namespace KernelsAVX512 { extern const Kernels::Table table; }
+#endif
+
+namespace
+{
+    std::atomic<int> forcedLevel { -1 };
+
+    bool isSupported(Kernels::IsaLevel level)
+    {
+        switch (level)
+        {
+            case Kernels::IsaLevel::Baseline:
+                return true;
+
+           #if STEREOIMAGER_X86_KERNELS
+            case Kernels::IsaLevel::AVX2:
+                return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+            case Kernels::IsaLevel::AVX512:
+                return juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX512VL()
+                        && juce::SystemStats::hasFMA3();
+           #endif
+
+            default:
+                return false;
+        }
+    }
+}
+
+namespace Kernels
+{
+    const Table* getTable(IsaLevel level)
+    {
+        if (! isSupported(level))
+            return nullptr;
+
+        switch (level)
+        {
+            case IsaLevel::Baseline:    return &KernelsBaseline::table;
+           #if STEREOIMAGER_X86_KERNELS
+            case IsaLevel::AVX2:        return &KernelsAVX2::table;
+            case IsaLevel::AVX512:      return &KernelsAVX512::table;
+           #endif
+            default:                    return nullptr;
+        }
+    }
+
+    IsaLevel getBestLevel()
+    {
+        const int cap = forcedLevel.load();
+        int best = 0;
+
+        for (int level = 1; level < static_cast<int>(IsaLevel::NumLevels); ++level)
+            if ((cap < 0 || level <= cap) && isSupported(static_cast<IsaLevel>(level)))
+                best = level;
+
+        return static_cast<IsaLevel>(best);
+    }
+
+    const Table& getBestTable()
+    {
+        return *getTable(getBestLevel());
+    }
+
+    void forceLevel(IsaLevel level)   { forcedLevel.store(static_cast<int>(level)); }
+    void clearForcedLevel()           { forcedLevel.store(-1); }
+
+    const char* getLevelName(IsaLevel level)
+    {
+        switch (level)
+        {
+            case IsaLevel::Baseline:    return KernelsBaseline::table.name;
+            case IsaLevel::AVX2:        return "AVX2";
+            case IsaLevel::AVX512:      return "AVX-512";
+            default:                    return "?";
+        }
+    }
+}
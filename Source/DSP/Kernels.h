@@ -0,0 +1,121 @@
+#pragma once
+
+// Hot DSP loops, built several times with different instruction sets and picked at
+// prepare() time from what the CPU supports. The plugin itself still targets baseline
+// x86-64 (or arm64, where NEON is the baseline); only the Kernels*.cpp files get the
+// wider ISA flags.
+//
+// Keep this header and KernelsImpl.h free of JUCE and standard library templates:
+// inline code they pull in would be compiled once per ISA and the linker may keep
+// the AVX copy for everyone.
+namespace Kernels
+{
+    enum class IsaLevel
+    {
+        Baseline = 0,   // SSE2 on x86-64, NEON on arm64
+        AVX2,           // AVX2 + FMA
+        AVX512,         // AVX-512F/VL + FMA
+        NumLevels
+    };
+
+    // Four biquad cascades run side by side: lanes are low L, low R, high L, high R.
+    // Both sections of a cascade share one set of coefficients (LR4 = Butterworth^2).
+    struct LR4Lanes
+    {
+        alignas(16) float b0[4] {}, b1[4] {}, b2[4] {}, a1[4] {}, a2[4] {};
+        alignas(16) float z1[2][4] {}, z2[2][4] {};
+    };
+
+    // Chunk responses for lr4SplitBlock, filled in by BlockIIR for the current coefficients.
+    // Index 0 is the low-pass cascades (lanes 0, 1), index 1 the high-pass ones (lanes 2, 3).
+    struct LR4BlockBasis
+    {
+        static constexpr int chunkLength = 64;
+        static constexpr int chunksPerGroup = 32;
+        static constexpr int groupLength = chunkLength * chunksPerGroup;
+
+        // Zero-input response of one section over a chunk from unit z1 and from unit z2,
+        // and the chunk's state transition: [z1, z2] after = transition * [z1, z2] before
+        alignas(16) float z1Response[2][chunkLength] {}, z2Response[2][chunkLength] {};
+        float transition[2][2][2] {};
+    };
+
+    // Eight second-order allpass sections in series, run as lanes so all eight work side
+    // by side. Section k filters what section k - 1 produced pipelineDepth samples before
+    // (the input too arrives that late), so the cascade's output lags a plain series
+    // cascade by numSections * pipelineDepth samples. Reading a few steps back rather
+    // than one keeps the lane shift off the loop's critical path.
+    // The numerators mirror the denominators (b0 = a2, b1 = a1, b2 = 1).
+    struct AllpassLanes
+    {
+        static constexpr int numSections = 8;
+        static constexpr int pipelineDepth = 4;
+
+        alignas(32) float a1[numSections] {}, a2[numSections] {};
+        alignas(32) float z1[numSections] {}, z2[numSections] {};
+
+        // Per step: the input, then each section's output
+        float pipeline[pipelineDepth][numSections + 1] {};
+        int pipelineIndex = 0;
+    };
+
+    // Direction bins of stereoFieldHistogram, left to right: pure side (L = -R), hard left,
+    // centre, hard right, pure side again. Bins are even steps of x / (|x| + |y|) on the
+    // goniometer (x = side towards R, y = mid, folded into y >= 0), a cheap stand-in for
+    // the angle that keeps hard left/right at 1/4 and 3/4 of the way across.
+    constexpr int stereoFieldBins = 64;
+
+    // L' = ll*L + lr*R, R' = rl*L + rr*R
+    struct StereoMatrix
+    {
+        float ll = 1.0f, lr = 0.0f, rl = 0.0f, rr = 1.0f;
+    };
+
+    struct Table
+    {
+        const char* name;
+
+        // LR4 low/high split of a stereo signal; outputs may alias the inputs
+        void (*lr4Split)(LR4Lanes& lanes, const float* inL, const float* inR,
+                         float* lowL, float* lowR, float* highL, float* highR, int numSamples);
+
+        // lr4Split evaluated in parallel along time for constant coefficients, over whole
+        // groups of LR4BlockBasis::groupLength samples only. Returns the samples processed.
+        // scratch holds 4 * groupLength floats; outputs may alias the inputs.
+        int (*lr4SplitBlock)(LR4Lanes& lanes, const LR4BlockBasis& basis, float* scratch,
+                             const float* inL, const float* inR,
+                             float* lowL, float* lowR, float* highL, float* highR, int numSamples);
+
+        // AllpassLanes cascade over one channel; the output may alias the input
+        void (*allpassCascade)(AllpassLanes& lanes, const float* input, float* output, int numSamples);
+
+        // Constant 2x2 matrix in place (width, balance and pan folded together)
+        void (*stereoMatrix)(float* left, float* right, const StereoMatrix& matrix, int numSamples);
+
+        // Adds sum|L|, sum|R|, sum|M|, sum|S| to sums[0..3] (M, S = (L +/- R) / 2)
+        void (*levelSums)(const float* left, const float* right, int numSamples, float* sums);
+
+        // Adds sum L*R, sum L^2, sum R^2 to sums[0..2]
+        void (*correlationSums)(const float* left, const float* right, int numSamples, float* sums);
+
+        // Adds each sample's energy (L^2 + R^2) to bins[stereoFieldBins] by its direction
+        void (*stereoFieldHistogram)(const float* left, const float* right, int numSamples, float* bins);
+
+        // dest[i] = source[i * step] for i < count
+        void (*decimate)(const float* source, int step, int count, float* dest);
+    };
+
+    // Kernels for a level, or nullptr if not built in or not supported by this CPU
+    const Table* getTable(IsaLevel level);
+
+    // Highest level this CPU supports (or the forced level, see below)
+    IsaLevel getBestLevel();
+    const Table& getBestTable();
+
+    // Caps the level picked by getBestLevel(), for benchmarks and A/B checks.
+    // Takes effect at the next prepare().
+    void forceLevel(IsaLevel level);
+    void clearForcedLevel();
+
+    const char* getLevelName(IsaLevel level);
+}
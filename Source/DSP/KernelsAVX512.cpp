@@ -0,0 +1,12 @@
+// AVX-512 build of the DSP kernels. CMake compiles this file with the matching ISA
+// flags on x86-64; elsewhere (and in Projucer builds) it is empty and the
+// dispatcher never offers this level.
+#ifndef STEREOIMAGER_X86_KERNELS
+ #define STEREOIMAGER_X86_KERNELS 0
+#endif
+
+#if STEREOIMAGER_X86_KERNELS
+ #define KERNELS_NAMESPACE KernelsAVX512
+ #define KERNELS_NAME "AVX-512"
+ #include "KernelsImpl.h"
+#endif
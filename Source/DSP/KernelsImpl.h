@@ -0,0 +1,346 @@
+// Kernel bodies, included once per instruction set by the Kernels*.cpp files with
+// KERNELS_NAMESPACE defined. Plain loops written for the auto-vectoriser: fixed-width
+// lane arrays and split accumulators, no calls out of this namespace.
+
+#include "Kernels.h"
+
+#ifndef KERNELS_NAMESPACE
+ #error "Define KERNELS_NAMESPACE before including KernelsImpl.h"
+#endif
+
+namespace KERNELS_NAMESPACE
+{
+    using Kernels::LR4Lanes;
+    using Kernels::LR4BlockBasis;
+    using Kernels::AllpassLanes;
+    using Kernels::StereoMatrix;
+
+    inline float absolute(float x) { return x < 0.0f ? -x : x; }
+
+    void lr4Split(LR4Lanes& s, const float* inL, const float* inR,
+                  float* lowL, float* lowR, float* highL, float* highR, int numSamples)
+    {
+        float b0[4], b1[4], b2[4], a1[4], a2[4], z1a[4], z2a[4], z1b[4], z2b[4];
+
+        for (int k = 0; k < 4; ++k)
+        {
+            b0[k] = s.b0[k]; b1[k] = s.b1[k]; b2[k] = s.b2[k]; a1[k] = s.a1[k]; a2[k] = s.a2[k];
+            z1a[k] = s.z1[0][k]; z2a[k] = s.z2[0][k]; z1b[k] = s.z1[1][k]; z2b[k] = s.z2[1][k];
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x[4] = { inL[i], inR[i], inL[i], inR[i] };
+            float y[4], out[4];
+
+            for (int k = 0; k < 4; ++k)
+            {
+                y[k] = b0[k] * x[k] + z1a[k];
+                z1a[k] = b1[k] * x[k] - a1[k] * y[k] + z2a[k];
+                z2a[k] = b2[k] * x[k] - a2[k] * y[k];
+            }
+
+            for (int k = 0; k < 4; ++k)
+            {
+                out[k] = b0[k] * y[k] + z1b[k];
+                z1b[k] = b1[k] * y[k] - a1[k] * out[k] + z2b[k];
+                z2b[k] = b2[k] * y[k] - a2[k] * out[k];
+            }
+
+            lowL[i] = out[0];
+            lowR[i] = out[1];
+            highL[i] = out[2];
+            highR[i] = out[3];
+        }
+
+        for (int k = 0; k < 4; ++k)
+        {
+            s.z1[0][k] = z1a[k]; s.z2[0][k] = z2a[k]; s.z1[1][k] = z1b[k]; s.z2[1][k] = z2b[k];
+        }
+    }
+
+    // Both sections of one cascade over a transposed group, tile[position in chunk][chunk],
+    // in place. Each chunk is filtered from zero state with all chunks of the group side by
+    // side, then the real state is carried from chunk to chunk and its response added back.
+    void lr4Tile(float* tile, LR4Lanes& s, int lane, const LR4BlockBasis& basis, int cascade)
+    {
+        constexpr int length = LR4BlockBasis::chunkLength;
+        constexpr int chunks = LR4BlockBasis::chunksPerGroup;
+
+        const float b0 = s.b0[lane], b1 = s.b1[lane], b2 = s.b2[lane], a1 = s.a1[lane], a2 = s.a2[lane];
+        const float* h1 = basis.z1Response[cascade];
+        const float* h2 = basis.z2Response[cascade];
+        const float (&t)[2][2] = basis.transition[cascade];
+
+        for (int section = 0; section < 2; ++section)
+        {
+            float e1[chunks] {}, e2[chunks] {};
+
+            for (int m = 0; m < length; ++m)
+            {
+                float* row = tile + m * chunks;
+
+                for (int k = 0; k < chunks; ++k)
+                {
+                    const float x = row[k];
+                    const float y = b0 * x + e1[k];
+                    e1[k] = b1 * x - a1 * y + e2[k];
+                    e2[k] = b2 * x - a2 * y;
+                    row[k] = y;
+                }
+            }
+
+            // State entering each chunk: s[k + 1] = T * s[k] + zero-state end of chunk k
+            float start1[chunks], start2[chunks];
+            float z1 = s.z1[section][lane], z2 = s.z2[section][lane];
+
+            for (int k = 0; k < chunks; ++k)
+            {
+                start1[k] = z1;
+                start2[k] = z2;
+
+                const float next1 = t[0][0] * z1 + t[0][1] * z2 + e1[k];
+                const float next2 = t[1][0] * z1 + t[1][1] * z2 + e2[k];
+                z1 = next1;
+                z2 = next2;
+            }
+
+            s.z1[section][lane] = z1;
+            s.z2[section][lane] = z2;
+
+            for (int m = 0; m < length; ++m)
+            {
+                float* row = tile + m * chunks;
+
+                for (int k = 0; k < chunks; ++k)
+                    row[k] += h1[m] * start1[k] + h2[m] * start2[k];
+            }
+        }
+    }
+
+    int lr4SplitBlock(LR4Lanes& s, const LR4BlockBasis& basis, float* scratch,
+                      const float* inL, const float* inR,
+                      float* lowL, float* lowR, float* highL, float* highR, int numSamples)
+    {
+        constexpr int length = LR4BlockBasis::chunkLength;
+        constexpr int chunks = LR4BlockBasis::chunksPerGroup;
+        constexpr int groupLength = LR4BlockBasis::groupLength;
+
+        float* tiles[4] = { scratch, scratch + groupLength, scratch + 2 * groupLength, scratch + 3 * groupLength };
+        float* outputs[4] = { lowL, lowR, highL, highR };
+        const int numGroups = numSamples / groupLength;
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            const int base = g * groupLength;
+
+            // Read the whole group before writing any of it, as outputs may alias the inputs
+            for (int m = 0; m < length; ++m)
+            {
+                for (int k = 0; k < chunks; ++k)
+                {
+                    tiles[0][m * chunks + k] = inL[base + k * length + m];
+                    tiles[1][m * chunks + k] = inR[base + k * length + m];
+                }
+            }
+
+            // The high-pass lanes start from the same input tiles
+            for (int i = 0; i < 2 * groupLength; ++i)
+                tiles[2][i] = tiles[0][i];
+
+            for (int lane = 0; lane < 4; ++lane)
+                lr4Tile(tiles[lane], s, lane, basis, lane < 2 ? 0 : 1);
+
+            for (int lane = 0; lane < 4; ++lane)
+                for (int k = 0; k < chunks; ++k)
+                    for (int m = 0; m < length; ++m)
+                        outputs[lane][base + k * length + m] = tiles[lane][m * chunks + k];
+        }
+
+        return numGroups * groupLength;
+    }
+
+    void allpassCascade(AllpassLanes& s, const float* input, float* output, int numSamples)
+    {
+        constexpr int n = AllpassLanes::numSections;
+        constexpr int depth = AllpassLanes::pipelineDepth;
+        float a1[n], a2[n], z1[n], z2[n];
+        int slot = s.pipelineIndex;
+
+        for (int k = 0; k < n; ++k)
+        {
+            a1[k] = s.a1[k]; a2[k] = s.a2[k]; z1[k] = s.z1[k]; z2[k] = s.z2[k];
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // The slot holds the input and section outputs from depth steps ago
+            float* step = s.pipeline[slot];
+            float y[n];
+
+            for (int k = 0; k < n; ++k)
+            {
+                const float x = step[k];
+                y[k] = a2[k] * x + z1[k];
+                z1[k] = a1[k] * (x - y[k]) + z2[k];
+                z2[k] = x - a2[k] * y[k];
+            }
+
+            step[0] = input[i];
+            for (int k = 0; k < n; ++k)
+                step[k + 1] = y[k];
+
+            output[i] = y[n - 1];
+            slot = slot + 1 < depth ? slot + 1 : 0;
+        }
+
+        for (int k = 0; k < n; ++k)
+        {
+            s.z1[k] = z1[k]; s.z2[k] = z2[k];
+        }
+
+        s.pipelineIndex = slot;
+    }
+
+    void stereoMatrix(float* left, float* right, const StereoMatrix& m, int numSamples)
+    {
+        const float ll = m.ll, lr = m.lr, rl = m.rl, rr = m.rr;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float l = left[i];
+            const float r = right[i];
+            left[i] = ll * l + lr * r;
+            right[i] = rl * l + rr * r;
+        }
+    }
+
+    // Eight partial sums per quantity so the reduction vectorises without -ffast-math
+    constexpr int numPartials = 8;
+
+    void levelSums(const float* left, const float* right, int numSamples, float* sums)
+    {
+        float l[numPartials] {}, r[numPartials] {}, mid[numPartials] {}, side[numPartials] {};
+        int i = 0;
+
+        for (; i + numPartials <= numSamples; i += numPartials)
+        {
+            for (int k = 0; k < numPartials; ++k)
+            {
+                const float a = left[i + k];
+                const float b = right[i + k];
+                l[k] += absolute(a);
+                r[k] += absolute(b);
+                mid[k] += absolute((a + b) * 0.5f);
+                side[k] += absolute((a - b) * 0.5f);
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            l[0] += absolute(left[i]);
+            r[0] += absolute(right[i]);
+            mid[0] += absolute((left[i] + right[i]) * 0.5f);
+            side[0] += absolute((left[i] - right[i]) * 0.5f);
+        }
+
+        for (int k = 0; k < numPartials; ++k)
+        {
+            sums[0] += l[k];
+            sums[1] += r[k];
+            sums[2] += mid[k];
+            sums[3] += side[k];
+        }
+    }
+
+    void correlationSums(const float* left, const float* right, int numSamples, float* sums)
+    {
+        float lr[numPartials] {}, ll[numPartials] {}, rr[numPartials] {};
+        int i = 0;
+
+        for (; i + numPartials <= numSamples; i += numPartials)
+        {
+            for (int k = 0; k < numPartials; ++k)
+            {
+                const float a = left[i + k];
+                const float b = right[i + k];
+                lr[k] += a * b;
+                ll[k] += a * a;
+                rr[k] += b * b;
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            lr[0] += left[i] * right[i];
+            ll[0] += left[i] * left[i];
+            rr[0] += right[i] * right[i];
+        }
+
+        for (int k = 0; k < numPartials; ++k)
+        {
+            sums[0] += lr[k];
+            sums[1] += ll[k];
+            sums[2] += rr[k];
+        }
+    }
+
+    void stereoFieldHistogram(const float* left, const float* right, int numSamples, float* bins)
+    {
+        using Kernels::stereoFieldBins;
+        constexpr int tileSize = 64;
+        constexpr int numCopies = 4;
+        int index[tileSize];
+        float energy[tileSize];
+
+        // Neighbouring samples mostly land in the same bin, so the scatter goes round four
+        // copies of the histogram rather than waiting on each add to the last one
+        float partial[numCopies][stereoFieldBins] {};
+
+        // Direction and energy for a tile at a time (vectorises), then the scatter
+        for (int i = 0; i < numSamples; i += tileSize)
+        {
+            const int n = numSamples - i < tileSize ? numSamples - i : tileSize;
+
+            for (int k = 0; k < n; ++k)
+            {
+                const float a = left[i + k];
+                const float b = right[i + k];
+                const float mid = a + b;
+                const float side = b - a;
+                const float x = mid < 0.0f ? -side : side;
+                const float t = x / (absolute(side) + absolute(mid) + 1.0e-30f);
+                const int bin = static_cast<int>((t + 1.0f) * (0.5f * stereoFieldBins));
+
+                index[k] = bin < stereoFieldBins - 1 ? bin : stereoFieldBins - 1;
+                energy[k] = a * a + b * b;
+            }
+
+            for (int k = 0; k < n; ++k)
+                partial[k & (numCopies - 1)][index[k]] += energy[k];
+        }
+
+        for (int bin = 0; bin < stereoFieldBins; ++bin)
+            bins[bin] += (partial[0][bin] + partial[1][bin]) + (partial[2][bin] + partial[3][bin]);
+    }
+
+    void decimate(const float* source, int step, int count, float* dest)
+    {
+        for (int i = 0; i < count; ++i)
+            dest[i] = source[i * step];
+    }
+
+    extern const Kernels::Table table;
+    const Kernels::Table table
+    {
+        KERNELS_NAME,
+        lr4Split,
+        lr4SplitBlock,
+        allpassCascade,
+        stereoMatrix,
+        levelSums,
+        correlationSums,
+        stereoFieldHistogram,
+        decimate
+    };
+}
@@ -0,0 +1,221 @@
+#include "MeterHistory.h"
+
+MeterHistory::MeterHistory() = default;
+
+MeterHistory::~MeterHistory()
+{
+    stopConsolidating();
+}
+
+void MeterHistory::startConsolidating()
+{
+    // A no-op if this history is already on the thread's list
+    sharedThread->addTimeSliceClient(this);
+}
+
+void MeterHistory::stopConsolidating()
+{
+    // Waits for a consolidation that's under way
+    sharedThread->removeTimeSliceClient(this);
+}
+
+void MeterHistory::push(const Frame& frame)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        frames[static_cast<size_t>(start1)] = frame;
+
+    fifo.finishedWrite(size1);
+}
+
+int MeterHistory::useTimeSlice()
+{
+    consolidate();
+    return 50;
+}
+
+void MeterHistory::consolidate()
+{
+    if (clearRequested.exchange(false))
+    {
+        pendingSeconds = 0.0;
+        lastSideToMid = 0.0f;
+
+        const std::lock_guard<std::mutex> guard(lock);
+        clearLevels();
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        addFrame(frames[static_cast<size_t>(start1 + i)]);
+
+    for (int i = 0; i < size2; ++i)
+        addFrame(frames[static_cast<size_t>(start2 + i)]);
+
+    fifo.finishedRead(size1 + size2);
+}
+
+void MeterHistory::addFrame(const Frame& frame)
+{
+    if (frame.seconds <= 0.0f)
+        return;
+
+    // Silence has no side/mid ratio; hold the last one through it
+    if (frame.midLevel + frame.sideLevel > 1.0e-5f)
+    {
+        const float ratio = std::max(frame.sideLevel, 1.0e-6f) / std::max(frame.midLevel, 1.0e-6f);
+        lastSideToMid = juce::jlimit(-60.0f, 20.0f, juce::Decibels::gainToDecibels(ratio, -120.0f));
+    }
+
+    const std::array<float, NumSeries> values {
+        frame.correlation,
+        lastSideToMid,
+        juce::Decibels::gainToDecibels(frame.lowLevel, -60.0f),
+        juce::Decibels::gainToDecibels(frame.midBandLevel, -60.0f),
+        juce::Decibels::gainToDecibels(frame.highLevel, -60.0f)
+    };
+
+    // A long block can fill several level 0 bins
+    for (double remaining = frame.seconds; remaining > 0.0;)
+    {
+        const double take = std::min(remaining, baseBinSeconds - pendingSeconds);
+
+        for (size_t s = 0; s < NumSeries; ++s)
+        {
+            auto& bin = pendingBase[s];
+
+            if (pendingSeconds == 0.0)
+            {
+                bin = { values[s], values[s], 0.0f, true };
+                pendingSums[s] = 0.0;
+            }
+
+            bin.min = std::min(bin.min, values[s]);
+            bin.max = std::max(bin.max, values[s]);
+            pendingSums[s] += values[s] * take;
+        }
+
+        pendingSeconds += take;
+        remaining -= take;
+
+        if (pendingSeconds >= baseBinSeconds - 1.0e-9)
+        {
+            for (size_t s = 0; s < NumSeries; ++s)
+                pendingBase[s].mean = static_cast<float>(pendingSums[s] / pendingSeconds);
+
+            addBaseBin(pendingBase);
+            pendingSeconds = 0.0;
+        }
+    }
+}
+
+void MeterHistory::addBaseBin(const std::array<Column, NumSeries>& bin)
+{
+    const std::lock_guard<std::mutex> guard(lock);
+    auto carry = bin;
+
+    // Every second bin of a level completes a pair, which becomes a bin of the next level
+    for (auto& level : levels)
+    {
+        // A ring only grows (on this thread, never the audio thread) until it first wraps
+        if (level.count < binsPerLevel)
+            level.bins.insert(level.bins.end(), carry.begin(), carry.end());
+        else
+            std::copy(carry.begin(), carry.end(),
+                      level.bins.begin() + static_cast<std::ptrdiff_t>((level.count % binsPerLevel) * NumSeries));
+
+        ++level.count;
+
+        if (! level.hasHalf)
+        {
+            level.half = carry;
+            level.hasHalf = true;
+            break;
+        }
+
+        for (size_t s = 0; s < NumSeries; ++s)
+        {
+            const auto& first = level.half[s];
+            carry[s] = { std::min(first.min, carry[s].min), std::max(first.max, carry[s].max),
+                         0.5f * (first.mean + carry[s].mean), true };
+        }
+
+        level.hasHalf = false;
+    }
+}
+
+void MeterHistory::clearLevels()
+{
+    for (auto& level : levels)
+    {
+        level.bins.clear();
+        level.count = 0;
+        level.hasHalf = false;
+    }
+}
+
+double MeterHistory::getRecordedSeconds() const
+{
+    const std::lock_guard<std::mutex> guard(lock);
+    return static_cast<double>(levels[0].count) * baseBinSeconds;
+}
+
+void MeterHistory::read(Series series, double spanSeconds, int numColumns, Column* columns) const
+{
+    if (numColumns <= 0)
+        return;
+
+    std::fill(columns, columns + numColumns, Column {});
+
+    if (spanSeconds <= 0.0)
+        return;
+
+    // The coarsest level with at least one bin per column
+    const double secondsPerColumn = spanSeconds / numColumns;
+    const int levelIndex = juce::jlimit(0, numLevels - 1, static_cast<int>(std::floor(std::log2(secondsPerColumn / baseBinSeconds))));
+    const double binSeconds = baseBinSeconds * (1 << levelIndex);
+
+    const std::lock_guard<std::mutex> guard(lock);
+    const auto& level = levels[static_cast<size_t>(levelIndex)];
+
+    // The right edge comes from level 0, so the coarse levels don't lag behind it
+    const double end = static_cast<double>(levels[0].count) / (1 << levelIndex);
+    const double binsPerColumn = secondsPerColumn / binSeconds;
+    const double start = end - spanSeconds / binSeconds;
+    const juce::int64 oldest = std::max<juce::int64>(0, level.count - binsPerLevel);
+
+    for (int c = 0; c < numColumns; ++c)
+    {
+        auto first = static_cast<juce::int64>(std::floor(start + c * binsPerColumn));
+        auto last = std::max(first + 1, static_cast<juce::int64>(std::floor(start + (c + 1) * binsPerColumn)));
+
+        first = std::max(first, oldest);
+        last = std::min(last, level.count);
+
+        // The newest bin of a coarse level stands in until the next one completes
+        if (first >= last && last == level.count && level.count > oldest)
+            first = last - 1;
+
+        if (first >= last)
+            continue;
+
+        auto& column = columns[c];
+        double meanSum = 0.0;
+
+        for (auto i = first; i < last; ++i)
+        {
+            const auto& bin = level.bins[static_cast<size_t>((i % binsPerLevel) * NumSeries + series)];
+
+            column.min = column.valid ? std::min(column.min, bin.min) : bin.min;
+            column.max = column.valid ? std::max(column.max, bin.max) : bin.max;
+            column.valid = true;
+            meanSum += bin.mean;
+        }
+
+        column.mean = static_cast<float>(meanSum / static_cast<double>(last - first));
+    }
+}
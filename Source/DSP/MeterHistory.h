@@ -0,0 +1,117 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Scrolling history of the meters, from seconds to days, in bounded memory.
+//
+// The audio thread pushes a frame of meter readings about every 10 ms (every block, for
+// longer blocks) into a lock-free FIFO.
+// A background thread drains it into a pyramid of min/max/mean bins: level 0 bins cover
+// baseBinSeconds of metered audio, each level above merges pairs of the one below, and
+// every level is a ring of binsPerLevel bins. A reader picks the level whose bins are
+// closest to one per column, so drawing costs O(columns) at any zoom.
+//
+// A level's ring grows as its bins arrive, so memory follows the length of the history:
+// all of it (12 x 2048 bins x 5 series x 16 B, ~2 MB) only after the top level has filled.
+//
+// The processor pushes a frame per meter frame and consolidates while it is prepared,
+// editor open or not. History only advances while frames arrive, so time the host
+// spends not processing is skipped rather than left as a gap.
+//
+// Every instance in the process consolidates on the same thread, a TimeSliceThread that
+// visits each prepared history every 50 ms, so a session with hundreds of instances
+// doesn't carry hundreds of mostly idle threads.
+class MeterHistory : private juce::TimeSliceClient
+{
+public:
+    enum Series
+    {
+        Correlation = 0,    // -1 to 1
+        SideToMid,          // Side level over mid level, dB
+        LowBand,            // Band levels, dBFS
+        MidBand,
+        HighBand,
+        NumSeries
+    };
+
+    // One block's meter readings, as the meters report them (linear levels)
+    struct Frame
+    {
+        float correlation = 0.0f;
+        float midLevel = 0.0f, sideLevel = 0.0f;
+        float lowLevel = 0.0f, midBandLevel = 0.0f, highLevel = 0.0f;
+        float seconds = 0.0f;       // Length of the frame
+    };
+
+    struct Column
+    {
+        float min = 0.0f, max = 0.0f, mean = 0.0f;
+        bool valid = false;
+    };
+
+    static constexpr double baseBinSeconds = 0.1;
+    static constexpr int binsPerLevel = 2048;
+    static constexpr int numLevels = 12;        // Top level spans ~116 hours
+
+    MeterHistory();
+    ~MeterHistory() override;
+
+    // Not on the audio thread: the consolidator runs in between (frames pushed while it
+    // is stopped wait in the FIFO, or are dropped once it is full)
+    void startConsolidating();
+    void stopConsolidating();
+
+    // Audio thread: no locks or allocation; the frame is dropped if the FIFO is full
+    void push(const Frame& frame);
+
+    // Any thread but the audio thread: the last spanSeconds of one series, oldest first,
+    // in numColumns columns. Columns before the history starts come back invalid.
+    void read(Series series, double spanSeconds, int numColumns, Column* columns) const;
+
+    double getRecordedSeconds() const;
+    static double getMaxSpanSeconds() { return baseBinSeconds * binsPerLevel * (1 << (numLevels - 1)); }
+
+    // Any thread: empties the history at the next consolidation
+    void requestClear() { clearRequested.store(true); }
+
+private:
+    struct SharedThread : juce::TimeSliceThread
+    {
+        SharedThread() : juce::TimeSliceThread("Meter history") { startThread(); }
+        ~SharedThread() override { stopThread(1000); }
+    };
+
+    juce::SharedResourcePointer<SharedThread> sharedThread;
+
+    int useTimeSlice() override;
+    void consolidate();
+    void addFrame(const Frame& frame);
+    void addBaseBin(const std::array<Column, NumSeries>& bin);
+    void clearLevels();
+
+    // Lock-free hand-over from the audio thread
+    static constexpr int fifoSize = 1024;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Frame, fifoSize> frames;
+
+    // Consolidator-only state: the level 0 bin being filled
+    std::array<Column, NumSeries> pendingBase {};
+    std::array<double, NumSeries> pendingSums {};
+    double pendingSeconds = 0.0;
+    float lastSideToMid = 0.0f;
+    std::atomic<bool> clearRequested { false };
+
+    struct Level
+    {
+        std::vector<Column> bins;               // Up to binsPerLevel * NumSeries, series interleaved
+        juce::int64 count = 0;                  // Bins ever completed
+        std::array<Column, NumSeries> half {};  // First of a pair waiting for its partner
+        bool hasHalf = false;
+    };
+
+    // Levels are shared with readers; the consolidator holds the lock only while it writes
+    mutable std::mutex lock;
+    std::array<Level, numLevels> levels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterHistory)
+};
@@ -1,5 +1,47 @@
 #include "MultibandProcessor.h"
 
+namespace
+{
+    // M/S width on one band, in place, times the mono bass side gains for a band inside
+    // its range (nullptr otherwise). A band settled at 100% is left alone.
+    void applyWidth(float* left, float* right, int numSamples, DSPUtils::SmoothedValue& width, const float* sideGains)
+    {
+        if (sideGains == nullptr && ! width.isSmoothing() && width.getTargetValue() == 1.0f)
+        {
+            width.setCurrentAndTargetValue(1.0f);
+            return;
+        }
+
+        // Settled, the width is a constant and the loop vectorises
+        const bool smoothing = width.isSmoothing();
+        if (! smoothing)
+            width.setCurrentAndTargetValue(width.getTargetValue());
+
+        const float settledWidth = width.getCurrentValue();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float bandWidth = smoothing ? width.getNextValue() : settledWidth;
+            if (sideGains != nullptr)
+                bandWidth *= sideGains[i];
+
+            const float mid = (left[i] + right[i]) * 0.5f;
+            const float side = (left[i] - right[i]) * 0.5f * bandWidth;
+            left[i] = mid + side;
+            right[i] = mid - side;
+        }
+    }
+
+    void addBand(float* left, float* right, const float* bandL, const float* bandR, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            left[i] += bandL[i];
+            right[i] += bandR[i];
+        }
+    }
+}
+
 MultibandProcessor::MultibandProcessor()
 {
 }
@@ -19,50 +61,87 @@ void MultibandProcessor::prepare(double sampleRate, int samplesPerBlock)
     highWidthSmoothed.reset(sampleRate, 20.0f);
     highWidthSmoothed.setCurrentAndTargetValue(1.0f);
 
-    updateCrossoverCoefficients();
+    monoBassSideGain.reset(sampleRate, 20.0f);
+    monoBassSideGain.setCurrentAndTargetValue(monoBassEnabled ? 0.0f : 1.0f);
+
+    levelFrameSamples = std::max(1, static_cast<int>(sampleRate / levelFramesPerSecond));
+
+    chunkSize = std::max(samplesPerBlock, minChunkSize);
+    for (auto* band : { &bandLowL, &bandLowR, &bandMidL, &bandMidR, &bandHighL, &bandHighR,
+                        &bandBassL, &bandBassR, &bassSideGains, &shadowL, &shadowR })
+        band->assign(static_cast<size_t>(chunkSize), 0.0f);
+
+    lowMidSplit.prepare(sampleRate, lowMidFreq);
+    midHighSplit.prepare(sampleRate, midHighFreq);
+    monoBassSplit.prepare(sampleRate, monoBassFreq);
+    monoBassAllpass.prepare(sampleRate, monoBassFreq);
+    neutralMidHigh.prepare(sampleRate, midHighFreq);
+    crossoverTable = DSPUtils::SharedTableCache::get<DSPUtils::CrossoverTable>(sampleRate);
+    meterFilterFreq = 0.0f;         // The table may be for a new rate
+
+    // Block IIR tiles, shared by the splits (they run one after another), only when the
+    // chunks are long enough to use them
+    if (chunkSize >= BlockIIR::minBlockSize)
+        blockScratch.assign(BlockIIR::scratchSize, 0.0f);
+    else
+        std::vector<float>().swap(blockScratch);
+
+    for (auto* split : { &lowMidSplit, &midHighSplit, &monoBassSplit })
+        split->setBlockScratch(blockScratch.empty() ? nullptr : blockScratch.data());
+
     reset();
 }
 
 void MultibandProcessor::reset()
 {
+    std::fill(std::begin(levelAccumulator), std::end(levelAccumulator), 0.0f);
+    levelSampleCount = 0;
+
     // Reset all filter states
-    lowMidLPStateL1.reset();
-    lowMidLPStateL2.reset();
-    lowMidLPStateR1.reset();
-    lowMidLPStateR2.reset();
-    lowMidHPStateL1.reset();
-    lowMidHPStateL2.reset();
-    lowMidHPStateR1.reset();
-    lowMidHPStateR2.reset();
+    lowMidSplit.reset();
+    midHighSplit.reset();
+    monoBassSplit.reset();
 
-    midHighLPStateL1.reset();
-    midHighLPStateL2.reset();
-    midHighLPStateR1.reset();
-    midHighLPStateR2.reset();
-    midHighHPStateL1.reset();
-    midHighHPStateL2.reset();
-    midHighHPStateR1.reset();
-    midHighHPStateR2.reset();
-}
+    monoBassAllpass.reset();
+    neutralMidHigh.reset();
+    for (auto& stage : meterHighL) stage.reset();
+    for (auto& stage : meterHighR) stage.reset();
 
-void MultibandProcessor::updateCrossoverCoefficients()
-{
-    lowMidLP = DSPUtils::calcLowPassLR(currentSampleRate, lowMidFreq);
-    lowMidHP = DSPUtils::calcHighPassLR(currentSampleRate, lowMidFreq);
-    midHighLP = DSPUtils::calcLowPassLR(currentSampleRate, midHighFreq);
-    midHighHP = DSPUtils::calcHighPassLR(currentSampleRate, midHighFreq);
+    bassAllpassActive = false;
+    pathIsFresh = true;
 }
 
 void MultibandProcessor::setLowMidCrossover(float freqHz)
 {
-    lowMidFreq = std::clamp(freqHz, 80.0f, 1000.0f);
-    updateCrossoverCoefficients();
+    float newFreq = std::clamp(freqHz, 80.0f, 1000.0f);
+    if (newFreq == lowMidFreq)
+        return;
+
+    lowMidFreq = newFreq;
+
+    if (traceRecorder != nullptr)
+    {
+        STEREOIMAGER_TRACE_EVENT(*traceRecorder, TraceRecorder::CoefficientUpdate, TraceRecorder::LowMidCrossover, lowMidFreq);
+    }
+
+    lowMidSplit.setFrequency(lowMidFreq);
 }
 
 void MultibandProcessor::setMidHighCrossover(float freqHz)
 {
-    midHighFreq = std::clamp(freqHz, 1000.0f, 10000.0f);
-    updateCrossoverCoefficients();
+    float newFreq = std::clamp(freqHz, 1000.0f, 10000.0f);
+    if (newFreq == midHighFreq)
+        return;
+
+    midHighFreq = newFreq;
+
+    if (traceRecorder != nullptr)
+    {
+        STEREOIMAGER_TRACE_EVENT(*traceRecorder, TraceRecorder::CoefficientUpdate, TraceRecorder::MidHighCrossover, midHighFreq);
+    }
+
+    midHighSplit.setFrequency(midHighFreq);
+    neutralMidHigh.setFrequency(midHighFreq);
 }
 
 void MultibandProcessor::setLowWidth(float widthPercent)
@@ -80,6 +159,30 @@ void MultibandProcessor::setHighWidth(float widthPercent)
     highWidthSmoothed.setTargetValue(widthPercent / 100.0f);
 }
 
+void MultibandProcessor::setCrossoverEngine(LR4Crossover::Engine engine)
+{
+    lowMidSplit.setEngine(engine);
+    midHighSplit.setEngine(engine);
+    monoBassSplit.setEngine(engine);
+
+    for (auto* allpass : { &monoBassAllpass, &neutralMidHigh })
+        allpass->setEngine(engine);
+}
+
+void MultibandProcessor::setMonoBass(bool shouldEnable, float freqHz)
+{
+    monoBassEnabled = shouldEnable;
+    monoBassSideGain.setTargetValue(shouldEnable ? 0.0f : 1.0f);
+
+    float newFreq = std::clamp(freqHz, 20.0f, 500.0f);
+    if (newFreq == monoBassFreq)
+        return;
+
+    monoBassFreq = newFreq;
+    monoBassSplit.setFrequency(monoBassFreq);
+    monoBassAllpass.setFrequency(monoBassFreq);
+}
+
 void MultibandProcessor::setEnabled(bool shouldEnable)
 {
     enabled = shouldEnable;
@@ -92,9 +195,6 @@ void MultibandProcessor::setBypass(bool shouldBypass)
 
 void MultibandProcessor::process(juce::AudioBuffer<float>& buffer)
 {
-    if (bypassed || !enabled)
-        return;
-
     const int numSamples = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
 
@@ -104,70 +204,314 @@ void MultibandProcessor::process(juce::AudioBuffer<float>& buffer)
     float* leftChannel = buffer.getWritePointer(0);
     float* rightChannel = buffer.getWritePointer(1);
 
-    float lowSum = 0.0f;
-    float midSum = 0.0f;
-    float highSum = 0.0f;
+    if (bypassed || !enabled)
+        return;
+
+    const bool bassBand = hasMonoBassBand();
+
+    if (bassBand != monoBassBandActive)
+    {
+        // The split sat idle, don't let its old state ring into the new tree
+        monoBassBandActive = bassBand;
+        monoBassSplit.reset();
+    }
+
+    // Pick the path for this block
+    const bool skipBands = canSkipBands();
+
+    if (pathIsFresh)
+    {
+        // Nothing is ringing yet, so either path can start straight away
+        pathIsFresh = false;
+        bandPath = skipBands ? BandPath::Neutral : BandPath::Full;
+    }
+    else if (bandPath == BandPath::Full && skipBands)
+        beginTransition(BandPath::ToNeutral);
+    else if (bandPath == BandPath::Neutral && ! skipBands)
+        beginTransition(BandPath::ToFull);
+    else if (bandPath == BandPath::ToNeutral && ! skipBands)
+        bandPath = BandPath::Full;          // The audible path never stopped
+    else if (bandPath == BandPath::ToFull && skipBands)
+        bandPath = BandPath::Neutral;
+
+    if (bandPath == BandPath::Neutral && meteringEnabled)
+        updateMeterFilter();
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+        processChunk(leftChannel + start, rightChannel + start, std::min(chunkSize, numSamples - start));
+
+    if ((bandPath == BandPath::ToNeutral || bandPath == BandPath::ToFull) && warmupRemaining <= 0)
+        bandPath = bandPath == BandPath::ToNeutral ? BandPath::Neutral : BandPath::Full;
+
+    // Update level meters once per level frame, however small the blocks
+    if (! meteringEnabled)
+        return;
+
+    levelSampleCount += numSamples;
+    if (levelSampleCount < levelFrameSamples)
+        return;
+
+    const auto count = static_cast<float>(levelSampleCount * 2);
+    lowLevel.store(levelAccumulator[0] / count);
+    midLevel.store(levelAccumulator[1] / count);
+    highLevel.store(levelAccumulator[2] / count);
 
+    std::fill(std::begin(levelAccumulator), std::end(levelAccumulator), 0.0f);
+    levelSampleCount = 0;
+}
+
+bool MultibandProcessor::canSkipBands() const
+{
+    auto isNeutral = [](const DSPUtils::SmoothedValue& width)
+    {
+        return width.getTargetValue() == 1.0f && ! width.isSmoothing();
+    };
+
+    return ! isMonoBassActive()
+        && isNeutral(lowWidthSmoothed) && isNeutral(midWidthSmoothed) && isNeutral(highWidthSmoothed);
+}
+
+void MultibandProcessor::beginTransition(BandPath newPath)
+{
+    // The incoming path's mid-high stage sat idle: clear it and put it where the target is
+    // now. The low-mid split is shared, so it has kept running.
+    if (newPath == BandPath::ToNeutral)
+    {
+        neutralMidHigh.reset();
+        neutralMidHigh.snapToTarget();
+        for (auto& stage : meterHighL) stage.reset();
+        for (auto& stage : meterHighR) stage.reset();
+
+        // Close enough to call it 100%, and from here on the bands are left untouched
+        for (auto* width : { &lowWidthSmoothed, &midWidthSmoothed, &highWidthSmoothed })
+            width->setCurrentAndTargetValue(1.0f);
+    }
+    else
+    {
+        for (auto* split : { &midHighSplit, &monoBassSplit, &monoBassAllpass })
+        {
+            split->reset();
+            split->snapToTarget();
+        }
+
+        bassAllpassActive = false;
+    }
+
+    // Twenty time constants of the mid-high crossover's poles (Q = 0.7071, so tau = sqrt2 / w;
+    // LR4 repeats them, so the tail is t * exp(-t / tau))
+    const double tau = juce::MathConstants<double>::sqrt2 / (juce::MathConstants<double>::twoPi * midHighFreq);
+    warmupLength = std::max(1, static_cast<int>(std::ceil(20.0 * tau * currentSampleRate)));
+
+    // Into the bands, they warm up and then fade in over as long again
+    warmupRemaining = newPath == BandPath::ToFull ? 2 * warmupLength : warmupLength;
+    bandPath = newPath;
+}
+
+void MultibandProcessor::processChunk(float* left, float* right, int numSamples)
+{
+    const bool bandsRun = bandPath != BandPath::Neutral;
+    const bool neutralRuns = bandPath != BandPath::Full;
+    const bool monoBass = isMonoBassActive();
+
+    // Mono bass below the low-mid crossover comes off the input and goes back on, folded
+    // to mono, ahead of the tree: the two-stage chain it replaces, in one place
+    const float* inL = left;
+    const float* inR = right;
+
+    if (bandsRun && monoBass)
+    {
+        // Side gain below the mono bass frequency, gliding after a toggle
+        if (monoBassSideGain.isSmoothing())
+        {
+            for (int i = 0; i < numSamples; ++i)
+                bassSideGains[static_cast<size_t>(i)] = monoBassSideGain.getNextValue();
+        }
+        else
+        {
+            monoBassSideGain.setCurrentAndTargetValue(monoBassSideGain.getTargetValue());
+            std::fill(bassSideGains.begin(), bassSideGains.begin() + numSamples, monoBassSideGain.getTargetValue());
+        }
+
+        if (monoBassBandActive && monoBassFreq < lowMidFreq)
+        {
+            monoBassSplit.process(inL, inR, bandBassL.data(), bandBassR.data(), bandHighL.data(), bandHighR.data(), numSamples);
+            foldBass(numSamples);
+            addBand(bandHighL.data(), bandHighR.data(), bandBassL.data(), bandBassR.data(), numSamples);
+            inL = bandHighL.data();
+            inR = bandHighR.data();
+        }
+    }
+
+    // First split: low vs (mid+high), shared by both paths
+    lowMidSplit.process(inL, inR, bandLowL.data(), bandLowR.data(), bandHighL.data(), bandHighR.data(), numSamples);
+
+    const bool transition = bandPath == BandPath::ToNeutral || bandPath == BandPath::ToFull;
+    float fadeStart = 0.0f, fadeStep = 0.0f;
+
+    if (transition)
+    {
+        // The paths only agree once the mid-high stages hold still, so a glide pauses the
+        // count. Into the bands, the fade starts once they have warmed up.
+        fadeStart = static_cast<float>(warmupLength - warmupRemaining) / static_cast<float>(warmupLength);
+
+        if (! midHighSplit.isSweeping() && ! neutralMidHigh.isSweeping())
+        {
+            fadeStep = 1.0f / static_cast<float>(warmupLength);
+            warmupRemaining = std::max(0, warmupRemaining - numSamples);
+        }
+    }
+
+    if (neutralRuns)
+        processNeutral(bandPath == BandPath::Neutral ? left : shadowL.data(),
+                       bandPath == BandPath::Neutral ? right : shadowR.data(), numSamples);
+
+    if (bandsRun)
+        processBands(left, right, numSamples, monoBass);
+
+    // Into the bands: fade over from the neutral path while the mid-high split warms up
+    if (bandPath == BandPath::ToFull)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto j = static_cast<size_t>(i);
+            const float fade = juce::jlimit(0.0f, 1.0f, fadeStart + fadeStep * static_cast<float>(i + 1));
+            left[i] = shadowL[j] + fade * (left[i] - shadowL[j]);
+            right[i] = shadowR[j] + fade * (right[i] - shadowR[j]);
+        }
+    }
+}
+
+void MultibandProcessor::processNeutral(float* left, float* right, int numSamples)
+{
+    // What the bands sum to at 100%: low + (mid + high), where mid + high is the mid-high
+    // split's allpass of the rest. The rest goes through the allpass in the shadow buffers,
+    // and the sum is written to left/right, which may be those buffers.
+    std::copy(bandHighL.begin(), bandHighL.begin() + numSamples, shadowL.begin());
+    std::copy(bandHighR.begin(), bandHighR.begin() + numSamples, shadowR.begin());
+
+    // Band meters while the bands are skipped: the high band is the split's high-pass of
+    // the rest, and the mid band what the allpass has on top of it (LR4 low + high = allpass)
+    const bool metered = meteringEnabled && bandPath == BandPath::Neutral;
+
+    if (metered)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto j = static_cast<size_t>(i);
+            bandMidL[j] = meterHighL[1].process(meterHighL[0].process(shadowL[j], meterHighCoeffs), meterHighCoeffs);
+            bandMidR[j] = meterHighR[1].process(meterHighR[0].process(shadowR[j], meterHighCoeffs), meterHighCoeffs);
+        }
+    }
+
+    neutralMidHigh.processAllpass(shadowL.data(), shadowR.data(), numSamples);
+
+    if (metered)
+    {
+        float levels[3] = { 0.0f, 0.0f, 0.0f };
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto j = static_cast<size_t>(i);
+            levels[0] += std::abs(bandLowL[j]) + std::abs(bandLowR[j]);
+            levels[1] += std::abs(shadowL[j] - bandMidL[j]) + std::abs(shadowR[j] - bandMidR[j]);
+            levels[2] += std::abs(bandMidL[j]) + std::abs(bandMidR[j]);
+        }
+
+        for (int band = 0; band < 3; ++band)
+            levelAccumulator[band] += levels[band];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto j = static_cast<size_t>(i);
+        left[i] = bandLowL[j] + shadowL[j];
+        right[i] = bandLowR[j] + shadowR[j];
+    }
+}
+
+void MultibandProcessor::updateMeterFilter()
+{
+    if (midHighFreq == meterFilterFreq)
+        return;
+
+    meterFilterFreq = midHighFreq;
+    DSPUtils::BiquadCoeffs lowPass;
+    crossoverTable->lookup(std::log2(midHighFreq), lowPass, meterHighCoeffs);
+}
+
+void MultibandProcessor::foldBass(int numSamples)
+{
+    // Mono bass band: mid only, once the side has faded out
     for (int i = 0; i < numSamples; ++i)
     {
-        float left = leftChannel[i];
-        float right = rightChannel[i];
-
-        // Get smoothed width values
-        float lowWidth = lowWidthSmoothed.getNextValue();
-        float midWidth = midWidthSmoothed.getNextValue();
-        float highWidth = highWidthSmoothed.getNextValue();
-
-        // Split into 3 bands using Linkwitz-Riley crossovers
-        // First split: low vs (mid+high)
-        float lowL = lowMidLPStateL2.process(lowMidLPStateL1.process(left, lowMidLP), lowMidLP);
-        float lowR = lowMidLPStateR2.process(lowMidLPStateR1.process(right, lowMidLP), lowMidLP);
-        float midHighL = lowMidHPStateL2.process(lowMidHPStateL1.process(left, lowMidHP), lowMidHP);
-        float midHighR = lowMidHPStateR2.process(lowMidHPStateR1.process(right, lowMidHP), lowMidHP);
-
-        // Second split: mid vs high (from midHigh signal)
-        float midL = midHighLPStateL2.process(midHighLPStateL1.process(midHighL, midHighLP), midHighLP);
-        float midR = midHighLPStateR2.process(midHighLPStateR1.process(midHighR, midHighLP), midHighLP);
-        float highL = midHighHPStateL2.process(midHighHPStateL1.process(midHighL, midHighHP), midHighHP);
-        float highR = midHighHPStateR2.process(midHighHPStateR1.process(midHighR, midHighHP), midHighHP);
-
-        // Apply width to each band using M/S processing
-        // Low band
-        float lowMid = (lowL + lowR) * 0.5f;
-        float lowSide = (lowL - lowR) * 0.5f;
-        lowSide *= lowWidth;
-        lowL = lowMid + lowSide;
-        lowR = lowMid - lowSide;
-
-        // Mid band
-        float midMid = (midL + midR) * 0.5f;
-        float midSide = (midL - midR) * 0.5f;
-        midSide *= midWidth;
-        midL = midMid + midSide;
-        midR = midMid - midSide;
-
-        // High band
-        float highMid = (highL + highR) * 0.5f;
-        float highSide = (highL - highR) * 0.5f;
-        highSide *= highWidth;
-        highL = highMid + highSide;
-        highR = highMid - highSide;
-
-        // Sum all bands
-        left = lowL + midL + highL;
-        right = lowR + midR + highR;
-
-        // Level metering
-        lowSum += std::abs(lowL) + std::abs(lowR);
-        midSum += std::abs(midL) + std::abs(midR);
-        highSum += std::abs(highL) + std::abs(highR);
-
-        leftChannel[i] = left;
-        rightChannel[i] = right;
-    }
-
-    // Update level meters
-    lowLevel.store(lowSum / (numSamples * 2));
-    midLevel.store(midSum / (numSamples * 2));
-    highLevel.store(highSum / (numSamples * 2));
+        const auto j = static_cast<size_t>(i);
+        const float bassMid = (bandBassL[j] + bandBassR[j]) * 0.5f;
+        const float bassSide = (bandBassL[j] - bandBassR[j]) * 0.5f * bassSideGains[j];
+        bandBassL[j] = bassMid + bassSide;
+        bandBassR[j] = bassMid - bassSide;
+    }
+}
+
+void MultibandProcessor::processBands(float* left, float* right, int numSamples, bool monoBass)
+{
+    // The low band comes from the shared low-mid split. Mono bass at the low-mid frequency
+    // is that band with no side; above it, the mono bass band is the next slice off the rest.
+    const bool bassAboveLow = monoBassBandActive && monoBassFreq > lowMidFreq;
+    const bool lowBandMono = monoBass && monoBassFreq >= lowMidFreq;
+
+    if (bassAboveLow)
+        monoBassSplit.process(bandHighL.data(), bandHighR.data(),
+                              bandBassL.data(), bandBassR.data(), bandHighL.data(), bandHighR.data(), numSamples);
+
+    // Second split: mid vs high (from midHigh signal)
+    midHighSplit.process(bandHighL.data(), bandHighR.data(),
+                         bandMidL.data(), bandMidR.data(), bandHighL.data(), bandHighR.data(), numSamples);
+
+    // Apply width to each band using M/S processing (a low band inside the mono bass
+    // range has its side faded out)
+    applyWidth(bandLowL.data(), bandLowR.data(), numSamples, lowWidthSmoothed, lowBandMono ? bassSideGains.data() : nullptr);
+    applyWidth(bandMidL.data(), bandMidR.data(), numSamples, midWidthSmoothed, nullptr);
+    applyWidth(bandHighL.data(), bandHighR.data(), numSamples, highWidthSmoothed, nullptr);
+
+    if (bassAboveLow)
+        foldBass(numSamples);
+
+    // Level metering (the bass band counts as low)
+    if (meteringEnabled)
+    {
+        auto sumLevels = [numSamples](const std::vector<float>& l, const std::vector<float>& r)
+        {
+            float sum = 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+                sum += std::abs(l[static_cast<size_t>(i)]) + std::abs(r[static_cast<size_t>(i)]);
+            return sum;
+        };
+
+        levelAccumulator[0] += sumLevels(bandLowL, bandLowR) + (bassAboveLow ? sumLevels(bandBassL, bandBassR) : 0.0f);
+        levelAccumulator[1] += sumLevels(bandMidL, bandMidR);
+        levelAccumulator[2] += sumLevels(bandHighL, bandHighR);
+    }
+
+    // A mono bass band above the low band joins it through the mono bass split's allpass,
+    // the phase the rest of the tree picked up from that split
+    if (bassAboveLow != bassAllpassActive)
+    {
+        bassAllpassActive = bassAboveLow;
+        monoBassAllpass.reset();
+        monoBassAllpass.snapToTarget();
+    }
+
+    if (bassAboveLow)
+    {
+        monoBassAllpass.processAllpass(bandLowL.data(), bandLowR.data(), numSamples);
+        addBand(bandLowL.data(), bandLowR.data(), bandBassL.data(), bandBassR.data(), numSamples);
+    }
+
+    // Sum all bands
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto j = static_cast<size_t>(i);
+        left[i] = bandLowL[j] + bandMidL[j] + bandHighL[j];
+        right[i] = bandLowR[j] + bandMidR[j] + bandHighR[j];
+    }
 }
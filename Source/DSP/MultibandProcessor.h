@@ -2,6 +2,8 @@
 
 #include <JuceHeader.h>
 #include "DSPUtils.h"
+#include "Crossover.h"
+#include "TraceRecorder.h"
 
 class MultibandProcessor
 {
@@ -18,48 +20,121 @@ public:
     void setLowWidth(float widthPercent);        // 0-200%
     void setMidWidth(float widthPercent);        // 0-200%
     void setHighWidth(float widthPercent);       // 0-200%
+    void setCrossoverEngine(LR4Crossover::Engine engine);
     void setEnabled(bool shouldEnable);
+
+    // Mono bass as part of the band tree: everything below freqHz gets zero side gain.
+    // At the low-mid crossover frequency that is just the low band, with no extra split;
+    // anywhere else the mono bass crossover joins the tree as a fourth band. Switching it
+    // glides the side gain, and the band stays in the tree until the side is back.
+    //
+    // The tree runs after the stereo processor's balance and pan, so in multiband mode
+    // the lows are folded to mono after panning: they stay centred whatever the pan
+    // (in single-band mode they are panned with the rest). At centre pan and balance the
+    // two orders are the same.
+    void setMonoBass(bool shouldEnable, float freqHz);   // 20-500 Hz
+
     void setBypass(bool shouldBypass);
 
+    // Band meters are skipped while nothing displays them. They don't hold the bands up:
+    // while the bands are skipped (see BandPath), a high-pass alone recovers them.
+    void setMeteringEnabled(bool shouldMeter) { meteringEnabled = shouldMeter; }
+
+    // Optional timeline recorder for crossover coefficient updates
+    void setTraceRecorder(TraceRecorder* recorder) { traceRecorder = recorder; }
+
     // Getters for band levels
     float getLowLevel() const { return lowLevel.load(); }
     float getMidLevel() const { return midLevel.load(); }
     float getHighLevel() const { return highLevel.load(); }
 
 private:
-    void updateCrossoverCoefficients();
-
-    // Crossover filters (Linkwitz-Riley 4th order = 2 cascaded 2nd order Butterworth)
-    // Low-Mid crossover
-    DSPUtils::BiquadCoeffs lowMidLP;
-    DSPUtils::BiquadCoeffs lowMidHP;
-    DSPUtils::BiquadState lowMidLPStateL1, lowMidLPStateL2;
-    DSPUtils::BiquadState lowMidLPStateR1, lowMidLPStateR2;
-    DSPUtils::BiquadState lowMidHPStateL1, lowMidHPStateL2;
-    DSPUtils::BiquadState lowMidHPStateR1, lowMidHPStateR2;
-
-    // Mid-High crossover
-    DSPUtils::BiquadCoeffs midHighLP;
-    DSPUtils::BiquadCoeffs midHighHP;
-    DSPUtils::BiquadState midHighLPStateL1, midHighLPStateL2;
-    DSPUtils::BiquadState midHighLPStateR1, midHighLPStateR2;
-    DSPUtils::BiquadState midHighHPStateL1, midHighHPStateL2;
-    DSPUtils::BiquadState midHighHPStateR1, midHighHPStateR2;
-
-    // Crossover frequencies
+    // Crossover filters (Linkwitz-Riley 4th order = 2 cascaded 2nd order Butterworth),
+    // run a chunk (the prepared block size) at a time into the band buffers
+    static constexpr int minChunkSize = 256;
+    int chunkSize = minChunkSize;
+    LR4Crossover lowMidSplit;
+    LR4Crossover midHighSplit;
+    std::vector<float> bandLowL, bandLowR;
+    std::vector<float> bandMidL, bandMidR;
+    std::vector<float> bandHighL, bandHighR;
+    std::vector<float> blockScratch;    // Shared by the splits' large-block paths
+
+    // One chunk in place: the low-mid split, then the bands, the neutral path or both
+    void processChunk(float* left, float* right, int numSamples);
+
+    // Splits the rest of the low-mid split into the other bands, widens them and sums
+    // them all back
+    void processBands(float* left, float* right, int numSamples, bool monoBass);
+    LR4Crossover monoBassAllpass;       // Phase match for a low band below a mono bass band
+    bool bassAllpassActive = false;
+
+    // Lazy bands: with every width at 100% and no mono bass, the mid and high bands just
+    // sum to the mid-high split's allpass of the rest, so that runs instead (one biquad
+    // per channel instead of four, plus no width stages). The low-mid split is shared and
+    // never stops. Into the neutral path, it warms up alongside and takes over once it
+    // has settled; out of it, the bands warm up alongside and are faded in over that time.
+    enum class BandPath
+    {
+        Full,
+        ToNeutral,      // Full path audible, neutral path warming up
+        Neutral,
+        ToFull          // Fading from the neutral path to the full one as it warms up
+    };
+
+    bool canSkipBands() const;
+    void beginTransition(BandPath newPath);
+    void processNeutral(float* left, float* right, int numSamples);
+
+    BandPath bandPath = BandPath::Full;
+    bool pathIsFresh = true;        // After prepare/reset, start on either path without a warm-up
+    int warmupLength = 1, warmupRemaining = 0;
+    LR4Crossover neutralMidHigh;
+    std::vector<float> shadowL, shadowR;            // The neutral path's rest, and its output in a transition
+    bool meteringEnabled = true;
+
+    // Band meters on the neutral path, from the mid-high split's high-pass alone (the two
+    // sections at the target frequency), redesigned when that frequency moves
+    void updateMeterFilter();
+    float meterFilterFreq = 0.0f;
+    std::shared_ptr<const DSPUtils::CrossoverTable> crossoverTable;
+    DSPUtils::BiquadCoeffs meterHighCoeffs;
+    DSPUtils::BiquadState meterHighL[2], meterHighR[2];
+
+    // Mono bass band, when its crossover isn't the low-mid one. Below the low-mid split it
+    // comes off the input and goes back folded to mono, ahead of the tree; above it, it is
+    // the next slice off the rest.
+    void foldBass(int numSamples);
+    bool isMonoBassActive() const { return monoBassEnabled || monoBassSideGain.getCurrentValue() != 1.0f; }
+    bool hasMonoBassBand() const { return isMonoBassActive() && monoBassFreq != lowMidFreq; }
+    LR4Crossover monoBassSplit;
+    std::vector<float> bandBassL, bandBassR;
+    DSPUtils::SmoothedValue monoBassSideGain;       // 0 with mono bass on, 1 off
+    std::vector<float> bassSideGains;               // Per sample, for the chunk
+    bool monoBassBandActive = false;
+
+    // Crossover frequencies (targets, the filters glide to them)
     float lowMidFreq = 250.0f;
     float midHighFreq = 4000.0f;
+    float monoBassFreq = 120.0f;
+    bool monoBassEnabled = false;
 
     // Width parameters (smoothed)
     DSPUtils::SmoothedValue lowWidthSmoothed;
     DSPUtils::SmoothedValue midWidthSmoothed;
     DSPUtils::SmoothedValue highWidthSmoothed;
 
-    // Band level metering
+    // Band level metering, averaged over a level frame gathered across calls
+    static constexpr double levelFramesPerSecond = 100.0;
+    float levelAccumulator[3] = { 0.0f, 0.0f, 0.0f };     // Low, mid, high
+    int levelSampleCount = 0;
+    int levelFrameSamples = 441;
     std::atomic<float> lowLevel { 0.0f };
     std::atomic<float> midLevel { 0.0f };
     std::atomic<float> highLevel { 0.0f };
 
+    TraceRecorder* traceRecorder = nullptr;
+
     // Runtime info
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
@@ -0,0 +1,361 @@
+#include "Multirate.h"
+
+namespace Multirate
+{
+    //==============================================================================
+    namespace
+    {
+        // Kaiser-windowed sinc with only the odd-distance taps kept, normalised to unity at DC
+        HalfBandCoeffs designHalfBand(int numSideTaps, double beta)
+        {
+            auto besselI0 = [](double x)
+            {
+                double sum = 1.0, term = 1.0;
+                for (int k = 1; k < 32; ++k)
+                {
+                    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                    sum += term;
+                }
+                return sum;
+            };
+
+            HalfBandCoeffs c;
+            c.numSideTaps = numSideTaps;
+            c.centre = 2 * numSideTaps - 1;
+            double total = 0.0;
+
+            for (int j = 0; j < numSideTaps; ++j)
+            {
+                const int offset = 2 * j + 1;
+                const double x = 0.5 * juce::MathConstants<double>::pi * offset;
+                const double ratio = static_cast<double>(offset) / c.centre;
+                const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / besselI0(beta);
+                c.side[j] = static_cast<float>(0.5 * std::sin(x) / x * window);
+                total += c.side[j];
+            }
+
+            // Unity gain at DC: 0.5 + 2 * sum(side) = 1
+            for (int j = 0; j < numSideTaps; ++j)
+                c.side[j] = static_cast<float>(c.side[j] * 0.25 / total);
+
+            return c;
+        }
+    }
+
+    const HalfBandCoeffs& HalfBandCoeffs::getFinalStage()
+    {
+        static const HalfBandCoeffs coeffs = designHalfBand(8, 8.0);
+        return coeffs;
+    }
+
+    const HalfBandCoeffs& HalfBandCoeffs::getEarlyStage()
+    {
+        static const HalfBandCoeffs coeffs = designHalfBand(4, 6.0);
+        return coeffs;
+    }
+
+    //==============================================================================
+    void HalfBandDecimator::prepare(const HalfBandCoeffs& filterCoeffs, int maxInput)
+    {
+        coeffs = &filterCoeffs;
+        buffer.assign(static_cast<size_t>(filterCoeffs.getNumTaps() - 1 + maxInput), 0.0f);
+        sidePhase.assign(static_cast<size_t>(filterCoeffs.getNumTaps() + maxInput / 2), 0.0f);
+        reset();
+    }
+
+    void HalfBandDecimator::reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        numHistory = coeffs != nullptr ? coeffs->getNumTaps() - 2 : 0;
+    }
+
+    int HalfBandDecimator::process(const float* input, float* output, int numInput)
+    {
+        const auto& c = *coeffs;
+        const int base = c.getNumTaps() - 2;
+        const int half = c.numSideTaps;
+        jassert(numHistory + numInput <= static_cast<int>(buffer.size()));
+
+        float* data = buffer.data();
+        std::copy(input, input + numInput, data + numHistory);
+        const int total = numHistory + numInput;
+
+        // Output k completes a pair at data[base + 1 + 2k] and has its centre tap at
+        // centre[2k]. Every side tap falls on the other phase, so that phase is pulled
+        // out once and the side taps run over it contiguously.
+        const int numOutput = (total - base) / 2;
+        const float* centre = data + base + 1 - c.centre;
+        const float* other = centre - (2 * half - 1);
+        float* phase = sidePhase.data();
+
+        for (int m = 0; m < numOutput + 2 * half - 1; ++m)
+            phase[m] = other[2 * m];
+
+        for (int k = 0; k < numOutput; ++k)
+            output[k] = 0.5f * centre[2 * k];
+
+        for (int j = 0; j < half; ++j)
+        {
+            const float tap = c.side[j];
+            const float* later = phase + half + j;
+            const float* earlier = phase + half - 1 - j;
+
+            for (int k = 0; k < numOutput; ++k)
+                output[k] += tap * (later[k] + earlier[k]);
+        }
+
+        // Keep the history, and the first half of a pair still waiting for its second
+        numHistory = base + (total - base) % 2;
+        std::copy(data + total - numHistory, data + total, data);
+        return numOutput;
+    }
+
+    //==============================================================================
+    void HalfBandInterpolator::prepare(const HalfBandCoeffs& filterCoeffs, int maxInput)
+    {
+        coeffs = &filterCoeffs;
+        buffer.assign(static_cast<size_t>(2 * filterCoeffs.numSideTaps - 1 + maxInput), 0.0f);
+        evenPhase.assign(static_cast<size_t>(maxInput), 0.0f);
+    }
+
+    void HalfBandInterpolator::reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+    }
+
+    void HalfBandInterpolator::process(const float* input, float* output, int numInput)
+    {
+        const auto& c = *coeffs;
+        const int half = c.numSideTaps;
+        const int numHistory = 2 * half - 1;
+        jassert(numHistory + numInput <= static_cast<int>(buffer.size()));
+
+        float* data = buffer.data();
+        std::copy(input, input + numInput, data + numHistory);
+        const float* x = data + numHistory;    // x[i] is input i, history at negative indices
+
+        // Zero-stuffed input: even outputs see the side taps, odd outputs only the centre
+        float* even = evenPhase.data();
+        std::fill(even, even + numInput, 0.0f);
+
+        for (int j = 0; j < half; ++j)
+        {
+            const float tap = 2.0f * c.side[j];
+            const float* earlier = x - half - j;
+            const float* later = x - half + 1 + j;
+
+            for (int i = 0; i < numInput; ++i)
+                even[i] += tap * (earlier[i] + later[i]);
+        }
+
+        const float* odd = x - half + 1;
+
+        for (int i = 0; i < numInput; ++i)
+        {
+            output[2 * i] = even[i];
+            output[2 * i + 1] = odd[i];
+        }
+
+        std::copy(data + numInput, data + numInput + numHistory, data);
+    }
+
+    //==============================================================================
+    void DelayLine::prepare(int numChannels, int maxDelaySamples, int maxBlockSize)
+    {
+        // Room for a whole block on top of the delay, so a block is one write then one read
+        ring.setSize(numChannels, maxDelaySamples + juce::jmax(1, maxBlockSize));
+        maxDelay = maxDelaySamples;
+        delay = juce::jmin(delay, maxDelay);
+        reset();
+    }
+
+    void DelayLine::reset()
+    {
+        ring.clear();
+        writeIndex = 0;
+    }
+
+    void DelayLine::setDelay(int delaySamples)
+    {
+        delay = juce::jlimit(0, maxDelay, delaySamples);
+    }
+
+    void DelayLine::process(float* const* channels, int numChannels, int numSamples)
+    {
+        if (delay == 0)
+            return;
+
+        const int size = ring.getNumSamples();
+        const int maxPiece = size - delay;
+        numChannels = juce::jmin(numChannels, ring.getNumChannels());
+
+        // Copies between a linear block and the ring, in at most two runs
+        auto toRing = [size](float* stored, int index, const float* data, int count)
+        {
+            const int first = juce::jmin(count, size - index);
+            std::copy(data, data + first, stored + index);
+            std::copy(data + first, data + count, stored);
+        };
+
+        auto fromRing = [size](const float* stored, int index, float* data, int count)
+        {
+            const int first = juce::jmin(count, size - index);
+            std::copy(stored + index, stored + index + first, data);
+            std::copy(stored, stored + (count - first), data + first);
+        };
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int count = juce::jmin(maxPiece, numSamples - done);
+            const int readIndex = (writeIndex - delay + size) % size;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float* stored = ring.getWritePointer(ch);
+                toRing(stored, writeIndex, channels[ch] + done, count);
+                fromRing(stored, readIndex, channels[ch] + done, count);
+            }
+
+            writeIndex = (writeIndex + count) % size;
+            done += count;
+        }
+    }
+
+    //==============================================================================
+    int LowBandResampler::getFactorFor(double sampleRate)
+    {
+        int factor = 1;
+        while (factor < (1 << maxStages) && sampleRate / (factor * 2) >= minReducedRate)
+            factor *= 2;
+
+        // A single halving only saves half the work, not worth the delay
+        return factor >= 4 ? factor : 1;
+    }
+
+    int LowBandResampler::getLatencyFor(double sampleRate)
+    {
+        const int factor = getFactorFor(sampleRate);
+        int stages = 0;
+        while ((1 << stages) < factor)
+            ++stages;
+
+        // Stage s runs at 1 / 2^s of the full rate and delays by its centre on the way down
+        // and again on the way up. The decimator's output lands one input late (it needs
+        // the pair) and the FIFO frames whole low-rate samples, which adds factor - 1.
+        int total = factor - 1;
+        for (int stage = 0; stage < stages; ++stage)
+            total += (2 * getStageCoeffs(stage, stages).centre - 1) << stage;
+
+        return total;
+    }
+
+    const HalfBandCoeffs& LowBandResampler::getStageCoeffs(int stage, int numStagesInUse)
+    {
+        // Only the last stage has to be sharp
+        return stage == numStagesInUse - 1 ? HalfBandCoeffs::getFinalStage() : HalfBandCoeffs::getEarlyStage();
+    }
+
+    void LowBandResampler::prepare(double sampleRate, int maxBlockSize, int numInputChannels, int numOutputChannels)
+    {
+        fullRate = sampleRate;
+        numStages = 0;
+        while ((1 << numStages) < getFactorFor(sampleRate))
+            ++numStages;
+
+        numInputs = numInputChannels;
+        numOutputs = numOutputChannels;
+        decimators.resize(static_cast<size_t>(numInputs));
+        interpolators.resize(static_cast<size_t>(numOutputs));
+
+        const int factor = getFactor();
+        const int maxReduced = maxBlockSize / factor + 2;
+        reducedInputs.setSize(numInputs, maxReduced);
+        reducedOutputs.setSize(numOutputs, maxReduced);
+        stageA.setSize(juce::jmax(numInputs, numOutputs), maxBlockSize / 2 + factor);
+        stageB.setSize(juce::jmax(numInputs, numOutputs), maxBlockSize / 2 + factor);
+        outputFifo.setSize(numOutputs, maxBlockSize + 2 * factor);
+
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            const auto& coeffs = getStageCoeffs(stage, numStages);
+            const int maxStageInput = (maxBlockSize >> stage) + factor;
+
+            for (auto& channel : decimators)
+                channel[(size_t) stage].prepare(coeffs, maxStageInput);
+
+            for (auto& channel : interpolators)
+                channel[(size_t) stage].prepare(coeffs, maxStageInput);
+        }
+
+        latency = getLatencyFor(sampleRate);
+
+        reset();
+    }
+
+    void LowBandResampler::reset()
+    {
+        for (auto& channel : decimators)
+            for (auto& stage : channel)
+                stage.reset();
+
+        for (auto& channel : interpolators)
+            for (auto& stage : channel)
+                stage.reset();
+
+        outputFifo.clear();
+        fifoCount = isActive() ? getFactor() - 1 : 0;
+    }
+
+    int LowBandResampler::decimate(const float* const* inputs, int numSamples)
+    {
+        int numReduced = 0;
+
+        for (int ch = 0; ch < numInputs; ++ch)
+        {
+            const float* source = inputs[ch];
+            int count = numSamples;
+
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                float* dest = stage == numStages - 1 ? reducedInputs.getWritePointer(ch)
+                                                     : (stage % 2 == 0 ? stageA : stageB).getWritePointer(ch);
+                count = decimators[(size_t) ch][(size_t) stage].process(source, dest, count);
+                source = dest;
+            }
+
+            numReduced = count;     // Same for every channel, their phases move together
+        }
+
+        return numReduced;
+    }
+
+    void LowBandResampler::interpolate(int numReduced, float* const* outputs, int numSamples)
+    {
+        const int numNew = numReduced << numStages;
+
+        for (int ch = 0; ch < numOutputs; ++ch)
+        {
+            const float* source = reducedOutputs.getReadPointer(ch);
+            int count = numReduced;
+
+            for (int stage = numStages - 1; stage >= 0; --stage)
+            {
+                float* dest = stage == 0 ? outputFifo.getWritePointer(ch, fifoCount)
+                                         : (stage % 2 == 0 ? stageA : stageB).getWritePointer(ch);
+                interpolators[(size_t) ch][(size_t) stage].process(source, dest, count);
+                count *= 2;
+                source = dest;
+            }
+
+            // Hand out this block and keep the rest (less than one low-rate sample's worth)
+            float* fifo = outputFifo.getWritePointer(ch);
+            const int available = fifoCount + numNew;
+            jassert(available >= numSamples);
+
+            std::copy(fifo, fifo + numSamples, outputs[ch]);
+            std::copy(fifo + numSamples, fifo + available, fifo);
+        }
+
+        fifoCount += numNew - numSamples;
+    }
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Reduced-rate processing for the mono bass filter at high sample rates.
+//
+// The lows it takes out of the side never need more than a few kHz of bandwidth, so at
+// 88.2 kHz and above the side is decimated by 2 per stage with polyphase half-band FIRs
+// down to 22-24 kHz, filtered there, and interpolated back through the same filters. The
+// filters are linear phase, so the round trip is a pure delay (getLatencySamples()). The
+// full-rate remainder is then the delayed crossover allpass minus the interpolated low
+// band (LR4Crossover::processAllpass()), which is one biquad per channel instead of four.
+namespace Multirate
+{
+    // Linear-phase half-band lowpass. Apart from the centre tap (0.5), only taps at odd
+    // distances from the centre are non-zero, so halving or doubling the rate costs
+    // numSideTaps symmetric multiply-adds per low-rate sample.
+    struct HalfBandCoeffs
+    {
+        static constexpr int maxSideTaps = 8;
+
+        int numSideTaps = 0;
+        int centre = 0;                 // Group delay, in high-rate samples (2 * numSideTaps - 1)
+        float side[maxSideTaps] {};     // side[j] = h[centre +/- (2j + 1)]
+
+        int getNumTaps() const { return 2 * centre + 1; }
+
+        // Into the reduced rate: 31 taps, flat to ~0.17 fs, ~80 dB stopband from ~0.34 fs
+        static const HalfBandCoeffs& getFinalStage();
+
+        // Stages above that only have to keep the final stage's passband (at most
+        // ~0.08 fs of their own rate) and reject around Nyquist: 15 taps, ~60 dB
+        static const HalfBandCoeffs& getEarlyStage();
+    };
+
+    // Halves the rate of one channel, streaming: any number of input samples, one output per
+    // pair. The block is appended to the filter history so the taps run over whole blocks.
+    class HalfBandDecimator
+    {
+    public:
+        void prepare(const HalfBandCoeffs& filterCoeffs, int maxInput);
+        void reset();
+
+        // Returns the number of outputs written (numInput / 2, give or take the odd sample)
+        int process(const float* input, float* output, int numInput);
+
+    private:
+        const HalfBandCoeffs* coeffs = nullptr;
+        std::vector<float> buffer;      // History, then the block
+        std::vector<float> sidePhase;   // The samples the side taps see, de-interleaved
+        int numHistory = 0;             // numTaps - 2, plus the first of an incomplete pair
+    };
+
+    // Doubles the rate of one channel: two outputs per input
+    class HalfBandInterpolator
+    {
+    public:
+        void prepare(const HalfBandCoeffs& filterCoeffs, int maxInput);
+        void reset();
+        void process(const float* input, float* output, int numInput);
+
+    private:
+        const HalfBandCoeffs* coeffs = nullptr;
+        std::vector<float> buffer;      // 2 * numSideTaps - 1 samples of history, then the block
+        std::vector<float> evenPhase;   // Side-tap outputs before interleaving
+    };
+
+    // Fixed delay for the full-rate path, so it lines up with the resampled low band
+    class DelayLine
+    {
+    public:
+        void prepare(int numChannels, int maxDelaySamples, int maxBlockSize);
+        void reset();
+
+        void setDelay(int delaySamples);    // Up to the prepared maximum
+        int getDelay() const { return delay; }
+
+        void process(float* const* channels, int numChannels, int numSamples);
+
+    private:
+        juce::AudioBuffer<float> ring;
+        int writeIndex = 0;
+        int delay = 0, maxDelay = 0;
+    };
+
+    // Decimates some full-rate channels, hands them to the caller at the reduced rate and
+    // interpolates the caller's reduced-rate results back to full rate:
+    //
+    //     const int numReduced = resampler.decimate(inputs, numSamples);
+    //     ... read getReducedInput(), write getReducedOutput(), numReduced samples ...
+    //     resampler.interpolate(numReduced, outputs, numSamples);
+    //
+    // The number of reduced samples varies from block to block; the full-rate output
+    // always matches the input and is delayed by getLatencySamples().
+    class LowBandResampler
+    {
+    public:
+        static constexpr int maxStages = 4;                 // Down to 1/16 (384 kHz -> 24 kHz)
+        static constexpr double minReducedRate = 22050.0;
+
+        // Rate change for a sample rate: 1 below 88.2 kHz, where it isn't worth the latency
+        static int getFactorFor(double sampleRate);
+
+        // Round-trip delay at a sample rate, in full-rate samples (0 when inactive)
+        static int getLatencyFor(double sampleRate);
+
+        void prepare(double sampleRate, int maxBlockSize, int numInputChannels, int numOutputChannels);
+        void reset();
+
+        bool isActive() const { return numStages > 0; }
+        int getFactor() const { return 1 << numStages; }
+        double getReducedRate() const { return fullRate / getFactor(); }
+        int getLatencySamples() const { return latency; }
+
+        int decimate(const float* const* inputs, int numSamples);
+        const float* getReducedInput(int channel) const { return reducedInputs.getReadPointer(channel); }
+        float* getReducedOutput(int channel) { return reducedOutputs.getWritePointer(channel); }
+
+        void interpolate(int numReduced, float* const* outputs, int numSamples);
+
+    private:
+        static const HalfBandCoeffs& getStageCoeffs(int stage, int numStagesInUse);
+
+        double fullRate = 44100.0;
+        int numStages = 0;
+        int latency = 0;
+        int numInputs = 0, numOutputs = 0;
+
+        std::vector<std::array<HalfBandDecimator, maxStages>> decimators;       // [channel][stage]
+        std::vector<std::array<HalfBandInterpolator, maxStages>> interpolators;
+
+        juce::AudioBuffer<float> reducedInputs, reducedOutputs;
+        juce::AudioBuffer<float> stageA, stageB;   // Ping-pong between stages
+
+        // Interpolated samples not yet handed out, primed with the framing delay
+        juce::AudioBuffer<float> outputFifo;
+        int fifoCount = 0;
+    };
+}
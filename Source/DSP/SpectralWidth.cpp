@@ -0,0 +1,299 @@
+#include "SpectralWidth.h"
+
+SpectralWidth::SpectralWidth()
+{
+    // Log-spaced from 60 Hz to 12 kHz, all at 100%
+    for (int i = 0; i < numNodes; ++i)
+    {
+        const float position = static_cast<float>(i) / (numNodes - 1);
+        nodes[(size_t) i].logFrequency = std::log2(60.0f) + position * std::log2(12000.0f / 60.0f);
+    }
+}
+
+void SpectralWidth::prepare(double sampleRate, int maxBlockSize)
+{
+    const std::lock_guard<std::mutex> lock(buildLock);
+
+    currentSampleRate = sampleRate;
+    preparedBlockSize = std::max(1, maxBlockSize);
+    built = false;
+
+    if (allocated.load(std::memory_order_relaxed))
+    {
+        build();
+        built = true;
+    }
+
+    reset();
+}
+
+void SpectralWidth::allocate()
+{
+    const std::lock_guard<std::mutex> lock(buildLock);
+
+    if (allocated.load(std::memory_order_relaxed) || preparedBlockSize == 0)
+        return;
+
+    // The audio thread doesn't touch the buffers until it sees the flag
+    build();
+    allocated.store(true, std::memory_order_release);
+}
+
+void SpectralWidth::build()
+{
+    const int maxSize = 1 << maxOrder;
+
+    for (int order = minOrder; order <= maxOrder; ++order)
+    {
+        const auto index = static_cast<size_t>(order - minOrder);
+        const int size = 1 << order;
+        ffts[index] = std::make_unique<juce::dsp::FFT>(order);
+
+        // Periodic Hann in and out: at a quarter-frame hop the squared windows sum to 1.5,
+        // so each side carries sqrt(1 / 1.5)
+        auto& window = windows[index];
+        window.resize(static_cast<size_t>(size));
+        const float scale = std::sqrt(1.0f / 1.5f);
+
+        for (int i = 0; i < size; ++i)
+            window[(size_t) i] = scale * (0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / size));
+    }
+
+    binLogFrequencies.resize(static_cast<size_t>(maxSize / 2 + 1));
+    for (int k = 0; k <= maxSize / 2; ++k)
+    {
+        // DC gets half a bin, so it sits below every node rather than at -inf
+        const double frequency = std::max(0.5, static_cast<double>(k)) * currentSampleRate / maxSize;
+        binLogFrequencies[(size_t) k] = static_cast<float>(std::log2(frequency));
+    }
+
+    targetGains.assign(static_cast<size_t>(maxSize + 2), 1.0f);
+    gains.assign(targetGains.size(), 1.0f);
+
+    inputFrame.assign(static_cast<size_t>(maxSize), 0.0f);
+    fftBuffer.assign(static_cast<size_t>(2 * maxSize), 0.0f);
+    outputSum.assign(static_cast<size_t>(maxSize), 0.0f);
+    outputHop.assign(static_cast<size_t>(maxSize / overlap), 0.0f);
+
+    mid.assign(static_cast<size_t>(preparedBlockSize), 0.0f);
+    side.assign(static_cast<size_t>(preparedBlockSize), 0.0f);
+    midDelay.prepare(1, getMaxLatencySamples(), preparedBlockSize);
+}
+
+void SpectralWidth::reset()
+{
+    // Nothing to glide from
+    snapGains = true;
+    curveChanged = true;
+    hopPosition = 0;
+
+    if (! built)
+        return;
+
+    midDelay.setDelay(getFftSize());
+    midDelay.reset();
+    std::fill(inputFrame.begin(), inputFrame.end(), 0.0f);
+    std::fill(outputSum.begin(), outputSum.end(), 0.0f);
+    std::fill(outputHop.begin(), outputHop.end(), 0.0f);
+}
+
+void SpectralWidth::setEnabled(bool shouldEnable)
+{
+    if (shouldEnable == enabled)
+        return;
+
+    enabled = shouldEnable;
+
+    // Start from silence in the frames rather than whatever was there when it was switched off
+    if (enabled)
+        reset();
+}
+
+void SpectralWidth::setFftOrder(int order)
+{
+    order = juce::jlimit(minOrder, maxOrder, order);
+    if (order == fftOrder)
+        return;
+
+    fftOrder = order;
+    reset();
+}
+
+void SpectralWidth::setNode(int index, float frequencyHz, float widthPercent)
+{
+    jassert(index >= 0 && index < numNodes);
+
+    const float logFrequency = std::log2(std::clamp(frequencyHz, 20.0f, 20000.0f));
+    const float width = std::clamp(widthPercent, 0.0f, 200.0f) / 100.0f;
+    auto& node = nodes[(size_t) index];
+
+    if (logFrequency == node.logFrequency && width == node.width)
+        return;
+
+    node.logFrequency = logFrequency;
+    node.width = width;
+    curveChanged = true;
+}
+
+void SpectralWidth::updateTargetGains()
+{
+    // Nodes in frequency order, whatever order they were set in
+    auto sorted = nodes;
+    std::sort(sorted.begin(), sorted.end(), [](const Node& a, const Node& b) { return a.logFrequency < b.logFrequency; });
+
+    const int numBins = getFftSize() / 2 + 1;
+    const int stride = 1 << (maxOrder - fftOrder);
+    int segment = 0;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const float logFrequency = binLogFrequencies[(size_t) (k * stride)];
+        float width;
+
+        if (logFrequency <= sorted.front().logFrequency)
+        {
+            width = sorted.front().width;
+        }
+        else if (logFrequency >= sorted.back().logFrequency)
+        {
+            width = sorted.back().width;
+        }
+        else
+        {
+            // Bins only go up, so the segment only moves forward
+            while (logFrequency > sorted[(size_t) segment + 1].logFrequency)
+                ++segment;
+
+            const auto& a = sorted[(size_t) segment];
+            const auto& b = sorted[(size_t) segment + 1];
+            const float t = (logFrequency - a.logFrequency) / (b.logFrequency - a.logFrequency);
+            width = a.width + (b.width - a.width) * t * t * (3.0f - 2.0f * t);
+        }
+
+        targetGains[(size_t) (2 * k)] = width;
+        targetGains[(size_t) (2 * k + 1)] = width;
+    }
+
+    gainsSettled = false;
+}
+
+void SpectralWidth::process(juce::AudioBuffer<float>& buffer)
+{
+    if (! enabled || buffer.getNumChannels() < 2)
+        return;
+
+    // First block since the STFT was allocated
+    if (! built)
+    {
+        if (! isAllocated())
+            return;
+
+        built = true;
+        reset();
+    }
+
+    if (curveChanged)
+    {
+        updateTargetGains();
+        curveChanged = false;
+    }
+
+    if (snapGains)
+    {
+        std::copy(targetGains.begin(), targetGains.end(), gains.begin());
+        gainsSettled = true;
+        snapGains = false;
+    }
+
+    float* left = buffer.getWritePointer(0);
+    float* right = buffer.getWritePointer(1);
+    const int numSamples = buffer.getNumSamples();
+    const int maxChunk = static_cast<int>(mid.size());
+    const int hop = getFftSize() / overlap;
+
+    for (int start = 0; start < numSamples; start += maxChunk)
+    {
+        const int count = std::min(maxChunk, numSamples - start);
+        float* l = left + start;
+        float* r = right + start;
+
+        for (int i = 0; i < count; ++i)
+        {
+            mid[(size_t) i] = (l[i] + r[i]) * 0.5f;
+            side[(size_t) i] = (l[i] - r[i]) * 0.5f;
+        }
+
+        float* midChannel[1] = { mid.data() };
+        midDelay.process(midChannel, 1, count);
+
+        // Side in, a hop at a time; each completed hop swaps in the next finished one
+        const int fill = getFftSize() - hop;
+
+        for (int done = 0; done < count;)
+        {
+            const int run = std::min(hop - hopPosition, count - done);
+            std::copy_n(side.data() + done, run, inputFrame.data() + fill + hopPosition);
+            std::copy_n(outputHop.data() + hopPosition, run, side.data() + done);
+
+            hopPosition += run;
+            done += run;
+
+            if (hopPosition == hop)
+            {
+                processFrame();
+                hopPosition = 0;
+            }
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            l[i] = mid[(size_t) i] + side[(size_t) i];
+            r[i] = mid[(size_t) i] - side[(size_t) i];
+        }
+    }
+}
+
+void SpectralWidth::processFrame()
+{
+    const int size = getFftSize();
+    const int hop = size / overlap;
+    const auto index = static_cast<size_t>(fftOrder - minOrder);
+    const float* window = windows[index].data();
+    float* data = fftBuffer.data();
+
+    juce::FloatVectorOperations::multiply(data, inputFrame.data(), window, size);
+    juce::FloatVectorOperations::clear(data + size, size);
+    ffts[index]->performRealOnlyForwardTransform(data, true);
+
+    // Glide the bin gains (~20 ms) until they reach the curve
+    if (! gainsSettled)
+    {
+        const auto glide = static_cast<float>(1.0 - std::exp(-hop / (0.02 * currentSampleRate)));
+        float largestStep = 0.0f;
+
+        for (int k = 0; k < size + 2; ++k)
+        {
+            const float step = (targetGains[(size_t) k] - gains[(size_t) k]) * glide;
+            gains[(size_t) k] += step;
+            largestStep = std::max(largestStep, std::abs(step));
+        }
+
+        if (largestStep < 1.0e-5f)
+        {
+            std::copy(targetGains.begin(), targetGains.end(), gains.begin());
+            gainsSettled = true;
+        }
+    }
+
+    // Real gains on interleaved (re, im): one multiply over the non-negative bins
+    juce::FloatVectorOperations::multiply(data, gains.data(), size + 2);
+    ffts[index]->performRealOnlyInverseTransform(data);
+
+    juce::FloatVectorOperations::addWithMultiply(outputSum.data(), data, window, size);
+
+    // Hand out the finished hop, then move both frames along by one
+    std::copy_n(outputSum.data(), hop, outputHop.data());
+    std::copy(outputSum.begin() + hop, outputSum.begin() + size, outputSum.begin());
+    std::fill(outputSum.begin() + (size - hop), outputSum.begin() + size, 0.0f);
+    std::copy(inputFrame.begin() + hop, inputFrame.begin() + size, inputFrame.begin());
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Multirate.h"
+
+// Width as a continuous curve over frequency instead of three bands.
+//
+// Only the side signal goes through the STFT: each frame is Hann-windowed, transformed,
+// every bin scaled by the curve's side gain, transformed back and overlap-added (hop =
+// fftSize / 4, Hann on the way out too). The mid takes a plain delay of the same length,
+// which is all an STFT at unity gain would do to it. The curve is a handful of
+// (frequency, width) nodes joined by smoothstep in log frequency, so it is flat at each
+// node and never overshoots between them; bin gains glide towards it frame by frame.
+//
+// The FFT size sets the trade: latency is fftSize samples, while frequency resolution
+// (and so how sharp the curve can act at the bottom) is sampleRate / fftSize.
+//
+// Nothing is allocated until the mode is first wanted: allocate() then builds every FFT
+// size and buffer (a couple of hundred kB) off the audio thread, and until it has, process() leaves the
+// audio alone and no latency is reported.
+class SpectralWidth
+{
+public:
+    static constexpr int numNodes = 5;
+    static constexpr int minOrder = 9;          // 512
+    static constexpr int maxOrder = 12;         // 4096
+    static constexpr int overlap = 4;
+
+    SpectralWidth();
+
+    // Rebuilds the STFT for the new rate and block size once allocate() has been called
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // Not on the audio thread: builds the STFT for the last prepare() the first time the
+    // mode is turned on; a no-op after that, and before the first prepare()
+    void allocate();
+    bool isAllocated() const { return allocated.load(std::memory_order_acquire); }
+
+    void setEnabled(bool shouldEnable);
+    bool isEnabled() const { return enabled; }
+
+    // FFT size as a power of two, minOrder to maxOrder. Every size is built together, so
+    // switching only clears the state (and changes the latency).
+    void setFftOrder(int order);
+    int getFftSize() const { return 1 << fftOrder; }
+
+    // fftSize while enabled (and allocated), 0 otherwise
+    int getLatencySamples() const { return enabled && isAllocated() ? getFftSize() : 0; }
+    static int getMaxLatencySamples() { return 1 << maxOrder; }
+
+    void setNode(int index, float frequencyHz, float widthPercent);    // 20-20000 Hz, 0-200%
+
+    void process(juce::AudioBuffer<float>& buffer);
+
+private:
+    void build();
+    void processFrame();
+    void updateTargetGains();
+
+    struct Node
+    {
+        float logFrequency = 0.0f;
+        float width = 1.0f;
+    };
+
+    double currentSampleRate = 44100.0;
+    int preparedBlockSize = 0;
+    bool enabled = false;
+
+    std::mutex buildLock;               // prepare() against allocate(), neither on the audio thread
+    std::atomic<bool> allocated { false };
+    bool built = false;                 // Audio thread: has picked up the allocation
+    int fftOrder = 11;
+
+    std::array<std::unique_ptr<juce::dsp::FFT>, maxOrder - minOrder + 1> ffts;
+    std::array<std::vector<float>, maxOrder - minOrder + 1> windows;     // Hann, scaled for the OLA on the way out
+
+    std::array<Node, numNodes> nodes;
+    bool curveChanged = true;
+
+    // log2 of each bin's frequency at the largest size; bin k of a smaller size is bin
+    // k << (maxOrder - order) of this
+    std::vector<float> binLogFrequencies;
+
+    // Interleaved (re, im) like the FFT's output, so a frame is one straight multiply
+    std::vector<float> targetGains, gains;
+    bool gainsSettled = false;
+    bool snapGains = true;      // After a reset: start on the curve instead of gliding to it
+
+    // STFT state, all sized for the largest FFT
+    std::vector<float> inputFrame;      // The last fftSize side samples
+    std::vector<float> fftBuffer;       // 2 * fftSize, as the FFT wants
+    std::vector<float> outputSum;       // Overlap-add accumulator
+    std::vector<float> outputHop;       // The finished hop being handed out
+    int hopPosition = 0;
+
+    std::vector<float> mid, side;
+    Multirate::DelayLine midDelay;
+
+    JUCE_DECLARE_NON_COPYABLE(SpectralWidth)
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Compile-time switch for the audio-thread profiler. CMake turns it on for Debug
+// builds (or when STEREOIMAGER_PROFILING is set); release builds compile it out.
+#ifndef STEREOIMAGER_PROFILING
+ #define STEREOIMAGER_PROFILING 0
+#endif
+
+// Lightweight per-stage timing for processBlock.
+// The audio thread is the only writer: stage times are accumulated per block and
+// committed into log-scale histograms of relaxed atomics, so the editor can read
+// percentiles at any time without locking.
+class StageProfiler
+{
+public:
+    enum Stage
+    {
+        Gain = 0,
+        Stereo,
+        Multiband,
+        Spectral,
+        Metering,
+        Block,
+        NumStages
+    };
+
+    struct StageStats
+    {
+        double p50Us = 0.0;
+        double p99Us = 0.0;
+        double maxUs = 0.0;
+        double p50Budget = 0.0;     // Fraction of the block budget (samplesPerBlock / sampleRate)
+        double p99Budget = 0.0;
+        juce::uint32 count = 0;
+    };
+
+    static const char* getStageName(Stage stage)
+    {
+        switch (stage)
+        {
+            case Gain:      return "Gain";
+            case Stereo:    return "Stereo";
+            case Multiband: return "Multiband";
+            case Spectral:  return "Spectral";
+            case Metering:  return "Metering";
+            case Block:     return "Block";
+            default:        return "";
+        }
+    }
+
+    void prepare(double sampleRate, int samplesPerBlock)
+    {
+        ticksPerMicrosecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) * 1.0e-6;
+        budgetUs.store(1.0e6 * samplesPerBlock / sampleRate);
+        requestReset();
+    }
+
+    void requestReset() { resetRequested.store(true); }
+
+    // Audio thread: add time spent in a stage during the current block
+    void addTicks(Stage stage, juce::int64 ticks)
+    {
+        pendingTicks[stage] += ticks;
+    }
+
+    // Audio thread: commit the current block's stage times into the histograms
+    void endBlock()
+    {
+        if (resetRequested.exchange(false))
+        {
+            for (auto& stage : histograms)
+            {
+                for (auto& bucket : stage.buckets)
+                    bucket.store(0, std::memory_order_relaxed);
+                stage.maxTicks.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        for (int s = 0; s < NumStages; ++s)
+        {
+            auto& h = histograms[s];
+            const auto ticks = pendingTicks[s];
+            pendingTicks[s] = 0;
+
+            h.buckets[bucketForTicks(ticks)].fetch_add(1, std::memory_order_relaxed);
+
+            if (ticks > h.maxTicks.load(std::memory_order_relaxed))
+                h.maxTicks.store(ticks, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread: percentile summary of a stage
+    StageStats getStats(Stage stage) const
+    {
+        StageStats stats;
+        const auto& h = histograms[stage];
+
+        std::array<juce::uint32, numBuckets> counts;
+        for (int b = 0; b < numBuckets; ++b)
+        {
+            counts[b] = h.buckets[b].load(std::memory_order_relaxed);
+            stats.count += counts[b];
+        }
+
+        if (stats.count == 0 || ticksPerMicrosecond <= 0.0)
+            return stats;
+
+        auto percentile = [&](double fraction)
+        {
+            const auto target = static_cast<juce::uint32>(std::ceil(fraction * stats.count));
+            juce::uint32 seen = 0;
+            for (int b = 0; b < numBuckets; ++b)
+            {
+                seen += counts[b];
+                if (seen >= target)
+                    return ticksForBucket(b) / ticksPerMicrosecond;
+            }
+            return ticksForBucket(numBuckets - 1) / ticksPerMicrosecond;
+        };
+
+        stats.p50Us = percentile(0.5);
+        stats.p99Us = percentile(0.99);
+        stats.maxUs = h.maxTicks.load(std::memory_order_relaxed) / ticksPerMicrosecond;
+
+        const double budget = budgetUs.load();
+        if (budget > 0.0)
+        {
+            stats.p50Budget = stats.p50Us / budget;
+            stats.p99Budget = stats.p99Us / budget;
+        }
+
+        return stats;
+    }
+
+    // Times the enclosing scope and adds it to a stage of the current block
+    class ScopedStage
+    {
+    public:
+        ScopedStage(StageProfiler& p, Stage s)
+            : profiler(p), stage(s), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedStage()
+        {
+            profiler.addTicks(stage, juce::Time::getHighResolutionTicks() - start);
+        }
+
+    private:
+        StageProfiler& profiler;
+        Stage stage;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+
+    // Times a whole processBlock call and commits the block's stage times on exit
+    class ScopedBlock
+    {
+    public:
+        explicit ScopedBlock(StageProfiler& p)
+            : profiler(p), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedBlock()
+        {
+            profiler.addTicks(Block, juce::Time::getHighResolutionTicks() - start);
+            profiler.endBlock();
+        }
+
+    private:
+        StageProfiler& profiler;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+private:
+    // Log-scale buckets: 4 per octave of ticks, covering well beyond any sane block time
+    static constexpr int subBucketBits = 2;
+    static constexpr int numBuckets = 160;
+
+    static int bucketForTicks(juce::int64 ticks)
+    {
+        if (ticks <= 1)
+            return 0;
+
+        int exponent = 0;
+        while ((ticks >> exponent) > 1)
+            ++exponent;
+
+        const int shift = exponent - subBucketBits;
+        const auto mantissa = static_cast<int>((shift >= 0 ? (ticks >> shift) : (ticks << -shift))
+                                               & ((1 << subBucketBits) - 1));
+        return juce::jmin(numBuckets - 1, (exponent << subBucketBits) + mantissa);
+    }
+
+    // Upper edge of a bucket, so percentiles never under-report
+    static double ticksForBucket(int bucket)
+    {
+        const int exponent = bucket >> subBucketBits;
+        const int mantissa = bucket & ((1 << subBucketBits) - 1);
+        return std::ldexp(1.0 + (mantissa + 1) / static_cast<double>(1 << subBucketBits), exponent);
+    }
+
+    struct Histogram
+    {
+        std::array<std::atomic<juce::uint32>, numBuckets> buckets {};
+        std::atomic<juce::int64> maxTicks { 0 };
+    };
+
+    std::array<Histogram, NumStages> histograms;
+    std::array<juce::int64, NumStages> pendingTicks {};
+    std::atomic<bool> resetRequested { true };
+    std::atomic<double> budgetUs { 0.0 };
+    double ticksPerMicrosecond = 0.0;
+};
+
+#if STEREOIMAGER_PROFILING
+ #define STEREOIMAGER_PROFILE_BLOCK(profiler) \
+     StageProfiler::ScopedBlock profiledBlock ((profiler))
+ #define STEREOIMAGER_PROFILE_STAGE(profiler, stage) \
+     StageProfiler::ScopedStage JUCE_JOIN_MACRO(profiledStage_, __LINE__) ((profiler), StageProfiler::stage)
+#else
+ #define STEREOIMAGER_PROFILE_BLOCK(profiler)
+ #define STEREOIMAGER_PROFILE_STAGE(profiler, stage)
+#endif
@@ -20,9 +20,41 @@ void StereoProcessor::prepare(double sampleRate, int samplesPerBlock)
     balanceSmoothed.reset(sampleRate, 20.0f);
     balanceSmoothed.setCurrentAndTargetValue(0.0f);
 
+    kernels = &Kernels::getBestTable();
+    fieldFrameSamples = std::max(1, static_cast<int>(sampleRate / fieldFramesPerSecond));
+    levelFrameSamples = std::max(1, static_cast<int>(sampleRate / levelFramesPerSecond));
+
+    // Shared lookup tables (built on first use by any instance)
+    panLaw = DSPUtils::SharedTableCache::get<DSPUtils::PanLawTable>(sampleRate);
+    matrixIsCurrent = false;
+
     // Initialize mono bass filter
-    monoBassLPCoeffs = DSPUtils::calcLowPassLR(sampleRate, monoBassFreq);
-    monoBassHPCoeffs = DSPUtils::calcHighPassLR(sampleRate, monoBassFreq);
+    chunkSize = std::max(samplesPerBlock, minChunkSize);
+    for (auto* band : { &bandLowL, &bandLowR, &bandHighL, &bandHighR })
+        band->assign(static_cast<size_t>(chunkSize), 0.0f);
+
+    monoBassSplit.prepare(sampleRate, monoBassFreq);
+    decorrelator.prepare(sampleRate, chunkSize);
+
+    // Block IIR tiles, only when the chunks are long enough to use them
+    if (chunkSize >= BlockIIR::minBlockSize)
+        blockScratch.assign(BlockIIR::scratchSize, 0.0f);
+    else
+        std::vector<float>().swap(blockScratch);
+
+    for (auto* split : { &monoBassSplit, &reducedMonoBassSplit })
+        split->setBlockScratch(blockScratch.empty() ? nullptr : blockScratch.data());
+
+    // Reduced-rate mono bass, ready for when multirate is switched on
+    monoBassResampler.prepare(sampleRate, chunkSize, 1, 1);
+    monoBassDelay.prepare(2, monoBassResampler.getLatencySamples(), chunkSize);
+    monoBassDelay.setDelay(monoBassResampler.getLatencySamples());
+
+    if (monoBassResampler.isActive())
+    {
+        reducedScratch.assign(static_cast<size_t>(chunkSize / monoBassResampler.getFactor() + 2), 0.0f);
+        reducedMonoBassSplit.prepare(monoBassResampler.getReducedRate(), monoBassFreq);
+    }
 
     reset();
 }
@@ -30,14 +62,11 @@ void StereoProcessor::prepare(double sampleRate, int samplesPerBlock)
 void StereoProcessor::reset()
 {
     // Reset filter states
-    monoBassLPStateL1.reset();
-    monoBassLPStateL2.reset();
-    monoBassLPStateR1.reset();
-    monoBassLPStateR2.reset();
-    monoBassHPStateL1.reset();
-    monoBassHPStateL2.reset();
-    monoBassHPStateR1.reset();
-    monoBassHPStateR2.reset();
+    monoBassSplit.reset();
+    reducedMonoBassSplit.reset();
+    monoBassResampler.reset();
+    monoBassDelay.reset();
+    decorrelator.reset();
 
     // Reset correlation
     corrSum = 0.0f;
@@ -45,33 +74,69 @@ void StereoProcessor::reset()
     rightSqSum = 0.0f;
     corrSampleCount = 0;
 
+    // Reset level frame
+    levelAccumulator = {};
+    levelSampleCount = 0;
+    pendingMeterSamples = 0;
+
     // Reset vectorscope buffer
-    std::lock_guard<std::mutex> lock(vectorscopeMutex);
-    std::fill(vectorscopeBuffer.begin(), vectorscopeBuffer.end(), std::make_pair(0.0f, 0.0f));
-    vectorscopeWriteIndex = 0;
+    {
+        std::lock_guard<std::mutex> lock(vectorscopeMutex);
+        std::fill(vectorscopeBuffer.begin(), vectorscopeBuffer.end(), std::make_pair(0.0f, 0.0f));
+        vectorscopeRingL.fill(0.0f);
+        vectorscopeRingR.fill(0.0f);
+        vectorscopeWriteIndex = 0;
+        vectorscopeSkip = 0;
+    }
+
+    // Reset stereo field
+    std::lock_guard<std::mutex> lock(stereoFieldMutex);
+    fieldAccumulator.fill(0.0f);
+    fieldSampleCount = 0;
+    stereoField.fill(0.0f);
 }
 
 void StereoProcessor::setWidth(float widthPercent)
 {
     // Convert 0-200% to 0-2 multiplier
-    widthSmoothed.setTargetValue(widthPercent / 100.0f);
+    setTarget(widthSmoothed, widthPercent / 100.0f);
 }
 
 void StereoProcessor::setPan(float panValue)
 {
-    panSmoothed.setTargetValue(std::clamp(panValue, -1.0f, 1.0f));
+    setTarget(panSmoothed, std::clamp(panValue, -1.0f, 1.0f));
 }
 
 void StereoProcessor::setBalance(float balanceValue)
 {
-    balanceSmoothed.setTargetValue(std::clamp(balanceValue, -1.0f, 1.0f));
+    setTarget(balanceSmoothed, std::clamp(balanceValue, -1.0f, 1.0f));
+}
+
+void StereoProcessor::setTarget(DSPUtils::SmoothedValue& value, float target)
+{
+    if (target == value.getTargetValue())
+        return;
+
+    value.setTargetValue(target);
+    matrixIsCurrent = false;
 }
 
 void StereoProcessor::setMonoBassFreq(float freqHz)
 {
-    monoBassFreq = std::clamp(freqHz, 20.0f, 500.0f);
-    monoBassLPCoeffs = DSPUtils::calcLowPassLR(currentSampleRate, monoBassFreq);
-    monoBassHPCoeffs = DSPUtils::calcHighPassLR(currentSampleRate, monoBassFreq);
+    float newFreq = std::clamp(freqHz, 20.0f, 500.0f);
+    if (newFreq == monoBassFreq)
+        return;
+
+    monoBassFreq = newFreq;
+
+    if (traceRecorder != nullptr)
+    {
+        STEREOIMAGER_TRACE_EVENT(*traceRecorder, TraceRecorder::CoefficientUpdate, TraceRecorder::MonoBass, monoBassFreq);
+    }
+
+    // Glides to the new frequency, no coefficient jump
+    monoBassSplit.setFrequency(monoBassFreq);
+    reducedMonoBassSplit.setFrequency(monoBassFreq);
 }
 
 void StereoProcessor::setMonoBassEnabled(bool enabled)
@@ -79,6 +144,41 @@ void StereoProcessor::setMonoBassEnabled(bool enabled)
     monoBassEnabled = enabled;
 }
 
+void StereoProcessor::setDecorrelationEnabled(bool enabled)
+{
+    decorrelator.setEnabled(enabled);
+}
+
+void StereoProcessor::setDecorrelationTarget(float targetCorrelation)
+{
+    decorrelator.setTargetCorrelation(targetCorrelation);
+}
+
+void StereoProcessor::setCrossoverEngine(LR4Crossover::Engine engine)
+{
+    monoBassSplit.setEngine(engine);
+    reducedMonoBassSplit.setEngine(engine);
+}
+
+void StereoProcessor::setMultirateEnabled(bool shouldUseMultirate)
+{
+    if (shouldUseMultirate == multirateEnabled)
+        return;
+
+    multirateEnabled = shouldUseMultirate;
+
+    // Start the newly used path clean
+    monoBassResampler.reset();
+    monoBassDelay.reset();
+    reducedMonoBassSplit.reset();
+    monoBassSplit.reset();
+}
+
+int StereoProcessor::getLatencySamples() const
+{
+    return isMonoBassReducedRate() ? monoBassResampler.getLatencySamples() : 0;
+}
+
 void StereoProcessor::setBypass(bool shouldBypass)
 {
     bypassed = shouldBypass;
@@ -96,6 +196,73 @@ void StereoProcessor::decodeMS(float mid, float side, float& left, float& right)
     right = mid - side;
 }
 
+int StereoProcessor::chooseFeatures()
+{
+    // A parameter that has stopped gliding is snapped to its target and held constant
+    auto isMoving = [](DSPUtils::SmoothedValue& value)
+    {
+        if (value.isSmoothing())
+            return true;
+
+        value.setCurrentAndTargetValue(value.getTargetValue());
+        return false;
+    };
+
+    int features = 0;
+
+    if (monoBassEnabled)
+        features |= MonoBass;
+
+    if (decorrelator.isActive())
+        features |= Decorrelate;
+
+    // Nothing has moved since the matrix was built (the usual case for runs of small blocks)
+    if (matrixIsCurrent)
+        return features;
+
+    if (isMoving(widthSmoothed))
+        features |= WidthMoving;
+    else
+        settledWidth = widthSmoothed.getCurrentValue();
+
+    if (isMoving(balanceSmoothed))
+    {
+        features |= BalanceMoving;
+    }
+    else
+    {
+        float balance = balanceSmoothed.getCurrentValue();
+        settledBalanceL = std::min(1.0f, 1.0f - balance);
+        settledBalanceR = std::min(1.0f, 1.0f + balance);
+    }
+
+    if (isMoving(panSmoothed))
+        features |= PanMoving;
+    else
+        panLaw->getGains(panSmoothed.getCurrentValue(), settledPanL, settledPanR);
+
+    if ((features & (WidthMoving | BalanceMoving | PanMoving)) == 0)
+    {
+        // Width, then balance, then pan, as one matrix
+        const float same = (1.0f + settledWidth) * 0.5f;
+        const float cross = (1.0f - settledWidth) * 0.5f;
+
+        const float panLL = (1.0f + settledPanL) * 0.5f, panLR = (1.0f - settledPanL) * 0.5f;
+        const float panRL = (1.0f - settledPanR) * 0.5f, panRR = (1.0f + settledPanR) * 0.5f;
+
+        const float widthBalLL = settledBalanceL * same, widthBalLR = settledBalanceL * cross;
+        const float widthBalRL = settledBalanceR * cross, widthBalRR = settledBalanceR * same;
+
+        settledMatrix.ll = panLL * widthBalLL + panLR * widthBalRL;
+        settledMatrix.lr = panLL * widthBalLR + panLR * widthBalRR;
+        settledMatrix.rl = panRL * widthBalLL + panRR * widthBalRL;
+        settledMatrix.rr = panRL * widthBalLR + panRR * widthBalRR;
+        matrixIsCurrent = true;
+    }
+
+    return features;
+}
+
 void StereoProcessor::process(juce::AudioBuffer<float>& buffer)
 {
     if (bypassed)
@@ -104,81 +271,220 @@ void StereoProcessor::process(juce::AudioBuffer<float>& buffer)
     const int numSamples = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
 
-    if (numChannels < 2)
-        return; // Need stereo
+    if (numChannels < 2 || panLaw == nullptr)
+        return; // Need stereo (and prepare() to have run)
 
     float* leftChannel = buffer.getWritePointer(0);
     float* rightChannel = buffer.getWritePointer(1);
 
-    // Level accumulators for metering
-    float leftSum = 0.0f;
-    float rightSum = 0.0f;
-    float midSum = 0.0f;
-    float sideSum = 0.0f;
+    const int features = chooseFeatures();
+    const auto processVariant = chunkProcessors[static_cast<size_t>(features)];
 
-    for (int i = 0; i < numSamples; ++i)
+    for (int start = 0; start < numSamples; start += chunkSize)
+        (this->*processVariant)(leftChannel, rightChannel, start, std::min(chunkSize, numSamples - start), levelAccumulator);
+
+    // Update level meters (RMS-ish average) once per level frame, however small the blocks
+    if (levelSampleCount >= levelFrameSamples)
+    {
+        const auto count = static_cast<float>(levelSampleCount);
+        leftLevel.store(levelAccumulator[0] / count);
+        rightLevel.store(levelAccumulator[1] / count);
+        midLevel.store(levelAccumulator[2] / count);
+        sideLevel.store(levelAccumulator[3] / count);
+
+        levelAccumulator = {};
+        levelSampleCount = 0;
+
+        if (visualsEnabled)
+            publishVectorscope();
+    }
+
+    if (! visualsEnabled && fieldSampleCount > 0)
+    {
+        // Start the next displayed frame clean
+        fieldAccumulator.fill(0.0f);
+        fieldSampleCount = 0;
+    }
+    else if (visualsEnabled && fieldSampleCount >= fieldFrameSamples)
     {
-        float left = leftChannel[i];
-        float right = rightChannel[i];
+        publishStereoField();
+    }
+}
 
-        // Get smoothed parameter values
-        float width = widthSmoothed.getNextValue();
-        float pan = panSmoothed.getNextValue();
-        float balance = balanceSmoothed.getNextValue();
+template <int features>
+void StereoProcessor::processChunk(float* leftChannel, float* rightChannel, int start, int numSamples, LevelSums& sums)
+{
+    const int end = start + numSamples;
 
-        // Mono bass processing
-        if (monoBassEnabled)
+    if constexpr ((features & Decorrelate) != 0)
+        decorrelator.process(leftChannel + start, rightChannel + start, numSamples);
+
+    // Mono bass processing
+    if constexpr ((features & MonoBass) != 0)
+    {
+        if (isMonoBassReducedRate())
+        {
+            processMonoBassReducedRate(leftChannel + start, rightChannel + start, numSamples);
+        }
+        else
         {
             // Split into low and high bands using Linkwitz-Riley (cascade of 2 Butterworth)
-            float lowL = monoBassLPStateL2.process(monoBassLPStateL1.process(left, monoBassLPCoeffs), monoBassLPCoeffs);
-            float lowR = monoBassLPStateR2.process(monoBassLPStateR1.process(right, monoBassLPCoeffs), monoBassLPCoeffs);
-            float highL = monoBassHPStateL2.process(monoBassHPStateL1.process(left, monoBassHPCoeffs), monoBassHPCoeffs);
-            float highR = monoBassHPStateR2.process(monoBassHPStateR1.process(right, monoBassHPCoeffs), monoBassHPCoeffs);
-
-            // Sum low frequencies to mono
-            float lowMono = (lowL + lowR) * 0.5f;
+            monoBassSplit.process(leftChannel + start, rightChannel + start,
+                                  bandLowL.data(), bandLowR.data(), bandHighL.data(), bandHighR.data(), numSamples);
+
+            for (int j = 0; j < numSamples; ++j)
+            {
+                // Recombine: lows summed to mono + stereo highs
+                float lowMono = (bandLowL[(size_t) j] + bandLowR[(size_t) j]) * 0.5f;
+                leftChannel[start + j] = lowMono + bandHighL[(size_t) j];
+                rightChannel[start + j] = lowMono + bandHighR[(size_t) j];
+            }
+        }
+    }
+    else if (isMonoBassReducedRate())
+    {
+        // Keep the reported latency while mono bass is off
+        float* channels[2] = { leftChannel + start, rightChannel + start };
+        monoBassDelay.process(channels, 2, numSamples);
+    }
 
-            // Recombine: mono lows + stereo highs
-            left = lowMono + highL;
-            right = lowMono + highR;
+    if constexpr ((features & (WidthMoving | BalanceMoving | PanMoving)) == 0)
+    {
+        kernels->stereoMatrix(leftChannel + start, rightChannel + start, settledMatrix, numSamples);
+    }
+    else
+    {
+        for (int i = start; i < end; ++i)
+        {
+            float left = leftChannel[i];
+            float right = rightChannel[i];
+
+            // Scale the side signal in M/S
+            float width = settledWidth;
+            if constexpr ((features & WidthMoving) != 0)
+                width = widthSmoothed.getNextValue();
+
+            float mid, side;
+            encodeMS(left, right, mid, side);
+            side *= width;
+            decodeMS(mid, side, left, right);
+
+            // Relative L/R level: left heavy reduces right, right heavy reduces left
+            float balanceL = settledBalanceL, balanceR = settledBalanceR;
+            if constexpr ((features & BalanceMoving) != 0)
+            {
+                float balance = balanceSmoothed.getNextValue();
+                balanceL = std::min(1.0f, 1.0f - balance);
+                balanceR = std::min(1.0f, 1.0f + balance);
+            }
+
+            left *= balanceL;
+            right *= balanceR;
+
+            // Constant power panning
+            float panL = settledPanL, panR = settledPanR;
+            if constexpr ((features & PanMoving) != 0)
+                panLaw->getGains(panSmoothed.getNextValue(), panL, panR);
+
+            float monoMix = (left + right) * 0.5f;
+            left = left * panL + monoMix * (1.0f - panL);
+            right = right * panR + monoMix * (1.0f - panR);
+
+            leftChannel[i] = left;
+            rightChannel[i] = right;
         }
+    }
+
+    gatherMeters(leftChannel, rightChannel, start, end, sums);
+}
 
-        // Convert to M/S
-        float mid, side;
-        encodeMS(left, right, mid, side);
+void StereoProcessor::processMonoBassReducedRate(float* left, float* right, int numSamples)
+{
+    // Mono lows = crossover allpass of the input minus the low-passed side:
+    // L -= lowSide, R += lowSide
+    for (int i = 0; i < numSamples; ++i)
+        bandLowL[(size_t) i] = (left[i] - right[i]) * 0.5f;
 
-        // Apply width (scale side signal)
-        side *= width;
+    const float* inputs[1] = { bandLowL.data() };
+    const int numReduced = monoBassResampler.decimate(inputs, numSamples);
+    const float* side = monoBassResampler.getReducedInput(0);
 
-        // Convert back to L/R
-        decodeMS(mid, side, left, right);
+    // Only the low output of the first lane is used
+    float* scratch = reducedScratch.data();
+    reducedMonoBassSplit.process(side, side, monoBassResampler.getReducedOutput(0), scratch, scratch, scratch, numReduced);
 
-        // Apply balance (relative L/R level)
-        if (balance < 0.0f)
-        {
-            // Left heavy - reduce right
-            right *= (1.0f + balance);
-        }
-        else if (balance > 0.0f)
+    float* outputs[1] = { bandLowR.data() };
+    monoBassResampler.interpolate(numReduced, outputs, numSamples);
+
+    monoBassSplit.processAllpass(left, right, numSamples);
+
+    float* channels[2] = { left, right };
+    monoBassDelay.process(channels, 2, numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        left[i] -= bandLowR[(size_t) i];
+        right[i] += bandLowR[(size_t) i];
+    }
+}
+
+template <size_t... variants>
+StereoProcessor::ChunkProcessorTable StereoProcessor::makeChunkProcessors(std::index_sequence<variants...>)
+{
+    return { &StereoProcessor::processChunk<static_cast<int>(variants)>... };
+}
+
+const StereoProcessor::ChunkProcessorTable StereoProcessor::chunkProcessors =
+    makeChunkProcessors(std::make_index_sequence<NumVariants>());
+
+void StereoProcessor::gatherMeters(const float* leftChannel, const float* rightChannel, int start, int end, LevelSums& sums)
+{
+    // Short runs wait for a full meterRunSize, so the meter kernels start up once per run
+    // rather than once per tiny host block
+    auto hold = [this, leftChannel, rightChannel](int from, int count)
+    {
+        for (int i = 0; i < count; ++i)
         {
-            // Right heavy - reduce left
-            left *= (1.0f - balance);
+            pendingMeterL[static_cast<size_t>(pendingMeterSamples + i)] = leftChannel[from + i];
+            pendingMeterR[static_cast<size_t>(pendingMeterSamples + i)] = rightChannel[from + i];
         }
+        pendingMeterSamples += count;
+    };
 
-        // Apply pan (constant power panning)
-        float panAngle = (pan + 1.0f) * 0.25f * 3.14159265358979323846f; // 0 to pi/2
-        float panL = std::cos(panAngle);
-        float panR = std::sin(panAngle);
+    if (pendingMeterSamples > 0)
+    {
+        const int count = std::min(end - start, meterRunSize - pendingMeterSamples);
+        hold(start, count);
+        start += count;
 
-        float monoMix = (left + right) * 0.5f;
-        left = left * panL + monoMix * (1.0f - panL);
-        right = right * panR + monoMix * (1.0f - panR);
+        if (pendingMeterSamples < meterRunSize)
+            return;
 
-        // Correlation calculation
-        corrSum += left * right;
-        leftSqSum += left * left;
-        rightSqSum += right * right;
-        corrSampleCount++;
+        accumulateMeters(pendingMeterL.data(), pendingMeterR.data(), 0, meterRunSize, sums);
+        pendingMeterSamples = 0;
+    }
+
+    if (end - start >= meterRunSize)
+        accumulateMeters(leftChannel, rightChannel, start, end, sums);
+    else
+        hold(start, end - start);
+}
+
+void StereoProcessor::accumulateMeters(const float* leftChannel, const float* rightChannel, int start, int end, LevelSums& sums)
+{
+    // Correlation, in runs that stop at each window boundary
+    for (int i = start; i < end;)
+    {
+        const int runEnd = std::min(end, i + (corrWindowSize - corrSampleCount));
+
+        float corrSums[3] = { corrSum, leftSqSum, rightSqSum };
+        kernels->correlationSums(leftChannel + i, rightChannel + i, runEnd - i, corrSums);
+        corrSum = corrSums[0];
+        leftSqSum = corrSums[1];
+        rightSqSum = corrSums[2];
+
+        corrSampleCount += runEnd - i;
+        i = runEnd;
 
         if (corrSampleCount >= corrWindowSize)
         {
@@ -193,34 +499,56 @@ void StereoProcessor::process(juce::AudioBuffer<float>& buffer)
             rightSqSum = 0.0f;
             corrSampleCount = 0;
         }
+    }
 
-        // Store for vectorscope (downsample)
-        if (i % 4 == 0)
-        {
-            std::lock_guard<std::mutex> lock(vectorscopeMutex);
-            vectorscopeBuffer[vectorscopeWriteIndex] = { left, right };
-            vectorscopeWriteIndex = (vectorscopeWriteIndex + 1) % vectorscopeBufferSize;
-        }
+    // Levels
+    kernels->levelSums(leftChannel + start, rightChannel + start, end - start, sums.data());
+    levelSampleCount += end - start;
+
+    if (! visualsEnabled)
+        return;
 
-        // Accumulate levels
-        leftSum += std::abs(left);
-        rightSum += std::abs(right);
+    // Stereo field, every sample
+    kernels->stereoFieldHistogram(leftChannel + start, rightChannel + start, end - start, fieldAccumulator.data());
+    fieldSampleCount += end - start;
 
-        float m, s;
-        encodeMS(left, right, m, s);
-        midSum += std::abs(m);
-        sideSum += std::abs(s);
+    // Store for vectorscope (every 4th sample, counted across calls), wrapping around the ring
+    int first = start + vectorscopeSkip;
+    int remaining = first < end ? (end - first + 3) / 4 : 0;
+    vectorscopeSkip = first + remaining * 4 - end;
+
+    while (remaining > 0)
+    {
+        const int count = std::min(remaining, vectorscopeBufferSize - vectorscopeWriteIndex);
+        kernels->decimate(leftChannel + first, 4, count, vectorscopeRingL.data() + vectorscopeWriteIndex);
+        kernels->decimate(rightChannel + first, 4, count, vectorscopeRingR.data() + vectorscopeWriteIndex);
 
-        // Write output
-        leftChannel[i] = left;
-        rightChannel[i] = right;
+        vectorscopeWriteIndex = (vectorscopeWriteIndex + count) % vectorscopeBufferSize;
+        first += count * 4;
+        remaining -= count;
     }
+}
+
+void StereoProcessor::publishVectorscope()
+{
+    std::unique_lock<std::mutex> lock(vectorscopeMutex, std::try_to_lock);
 
-    // Update level meters (RMS-ish average)
-    leftLevel.store(leftSum / numSamples);
-    rightLevel.store(rightSum / numSamples);
-    midLevel.store(midSum / numSamples);
-    sideLevel.store(sideSum / numSamples);
+    if (! lock.owns_lock())
+    {
+        // Editor is copying - keep the points and publish them next frame
+        if (traceRecorder != nullptr)
+        {
+            STEREOIMAGER_TRACE_EVENT(*traceRecorder, TraceRecorder::VectorscopeContended);
+        }
+        return;
+    }
+
+    // Publish oldest-first so the display can fade by age
+    for (int i = 0; i < vectorscopeBufferSize; ++i)
+    {
+        const auto index = static_cast<size_t>((vectorscopeWriteIndex + i) % vectorscopeBufferSize);
+        vectorscopeBuffer[static_cast<size_t>(i)] = { vectorscopeRingL[index], vectorscopeRingR[index] };
+    }
 }
 
 void StereoProcessor::getStereoSamples(std::vector<std::pair<float, float>>& samples) const
@@ -228,3 +556,26 @@ void StereoProcessor::getStereoSamples(std::vector<std::pair<float, float>>& sam
     std::lock_guard<std::mutex> lock(vectorscopeMutex);
     samples = vectorscopeBuffer;
 }
+
+void StereoProcessor::publishStereoField()
+{
+    std::unique_lock<std::mutex> lock(stereoFieldMutex, std::try_to_lock);
+
+    // Editor is copying - keep accumulating into a longer frame
+    if (! lock.owns_lock())
+        return;
+
+    const float scale = 1.0f / static_cast<float>(fieldSampleCount);
+
+    for (size_t bin = 0; bin < stereoField.size(); ++bin)
+        stereoField[bin] = fieldAccumulator[bin] * scale;
+
+    fieldAccumulator.fill(0.0f);
+    fieldSampleCount = 0;
+}
+
+void StereoProcessor::getStereoField(StereoField& field) const
+{
+    std::lock_guard<std::mutex> lock(stereoFieldMutex);
+    field = stereoField;
+}
@@ -2,6 +2,11 @@
 
 #include <JuceHeader.h>
 #include "DSPUtils.h"
+#include "Crossover.h"
+#include "Decorrelator.h"
+#include "Kernels.h"
+#include "Multirate.h"
+#include "TraceRecorder.h"
 
 class StereoProcessor
 {
@@ -18,8 +23,25 @@ public:
     void setBalance(float balanceValue);         // -1 to +1
     void setMonoBassFreq(float freqHz);          // Frequency below which is mono
     void setMonoBassEnabled(bool enabled);
+    void setCrossoverEngine(LR4Crossover::Engine engine);
     void setBypass(bool shouldBypass);
 
+    // Allpass decorrelation ahead of the width stage (see Decorrelator.h)
+    void setDecorrelationEnabled(bool enabled);
+    void setDecorrelationTarget(float targetCorrelation);   // 0 to 1
+
+    // Runs the mono bass filter at a reduced rate at 88.2 kHz and above (see Multirate.h).
+    // The output is then delayed by getLatencySamples(), also while mono bass is off.
+    void setMultirateEnabled(bool shouldUseMultirate);
+    int getLatencySamples() const;
+
+    // Levels and correlation are always measured (they are cheap, and the meter history
+    // records them); the vectorscope and stereo field only while something displays them
+    void setVisualsEnabled(bool shouldCapture) { visualsEnabled = shouldCapture; }
+
+    // Optional timeline recorder for coefficient updates and vectorscope lock waits
+    void setTraceRecorder(TraceRecorder* recorder) { traceRecorder = recorder; }
+
     // Getters for metering
     float getCorrelation() const { return correlation.load(); }
     float getLeftLevel() const { return leftLevel.load(); }
@@ -30,25 +52,101 @@ public:
     // For vectorscope/goniometer
     void getStereoSamples(std::vector<std::pair<float, float>>& samples) const;
 
+    // Energy per sample in each direction bin (see Kernels::stereoFieldBins), averaged
+    // over the last field frame (about one UI frame). All samples count, not just the
+    // vectorscope's every fourth.
+    using StereoField = std::array<float, Kernels::stereoFieldBins>;
+    void getStereoField(StereoField& field) const;
+
 private:
     // M/S encoding
     void encodeMS(float left, float right, float& mid, float& side);
     void decodeMS(float mid, float side, float& left, float& right);
 
+    // Work a block actually needs. Each combination has its own instantiation of
+    // processChunk, picked once per block, so the inner loops carry no per-sample
+    // branches and no dead arithmetic. Settled width, balance and pan are folded into
+    // one 2x2 matrix per block; only parameters still gliding are evaluated per sample.
+    // (Pan always applies: centre is a -3 dB partial mono mix.)
+    enum Feature
+    {
+        MonoBass      = 1 << 0,
+        WidthMoving   = 1 << 1,
+        BalanceMoving = 1 << 2,
+        PanMoving     = 1 << 3,
+        Decorrelate   = 1 << 4,
+        NumVariants   = 1 << 5
+    };
+
+    using LevelSums = std::array<float, 4>;     // sum |L|, |R|, |M|, |S|
+
+    int chooseFeatures();
+
+    template <int features>
+    void processChunk(float* left, float* right, int start, int numSamples, LevelSums& sums);
+
+    void gatherMeters(const float* left, const float* right, int start, int end, LevelSums& sums);
+    void accumulateMeters(const float* left, const float* right, int start, int end, LevelSums& sums);
+
+    using ChunkProcessor = void (StereoProcessor::*)(float*, float*, int, int, LevelSums&);
+    using ChunkProcessorTable = std::array<ChunkProcessor, NumVariants>;
+
+    template <size_t... variants>
+    static ChunkProcessorTable makeChunkProcessors(std::index_sequence<variants...>);
+
+    static const ChunkProcessorTable chunkProcessors;
+
+    // Copies the audio thread's vectorscope ring to the shared buffer if the editor isn't reading it
+    void publishVectorscope();
+
+    // Hands the accumulated histogram to the editor once a field frame is full
+    void publishStereoField();
+
+    // Sets a width, balance or pan target, marking the matrix stale if it changed
+    void setTarget(DSPUtils::SmoothedValue& value, float target);
+
     // Parameters (smoothed)
     DSPUtils::SmoothedValue widthSmoothed;
     DSPUtils::SmoothedValue panSmoothed;
     DSPUtils::SmoothedValue balanceSmoothed;
 
-    // Mono bass filter
-    DSPUtils::BiquadCoeffs monoBassLPCoeffs;
-    DSPUtils::BiquadCoeffs monoBassHPCoeffs;
-    DSPUtils::BiquadState monoBassLPStateL1, monoBassLPStateL2;
-    DSPUtils::BiquadState monoBassLPStateR1, monoBassLPStateR2;
-    DSPUtils::BiquadState monoBassHPStateL1, monoBassHPStateL2;
-    DSPUtils::BiquadState monoBassHPStateR1, monoBassHPStateR2;
+    // Shared constant-power pan law (one copy per process)
+    std::shared_ptr<const DSPUtils::PanLawTable> panLaw;
+
+    // Values of the parameters that have stopped gliding, rebuilt when a target changes
+    float settledWidth = 1.0f;
+    float settledBalanceL = 1.0f, settledBalanceR = 1.0f;
+    float settledPanL = 1.0f, settledPanR = 1.0f;
+    Kernels::StereoMatrix settledMatrix;
+    bool matrixIsCurrent = false;               // Built from settled targets; a new target clears it
+
+    // Hot loops for this CPU, picked in prepare()
+    const Kernels::Table* kernels = nullptr;
+
+    // Mono bass filter, split a chunk at a time into the band buffers. Chunks are the
+    // prepared block size, so large offline blocks reach the crossover whole.
+    static constexpr int minChunkSize = 256;
+    int chunkSize = minChunkSize;
+    LR4Crossover monoBassSplit;
+    std::vector<float> bandLowL, bandLowR, bandHighL, bandHighR;
+    std::vector<float> blockScratch;    // Shared by the mono bass splits' large-block paths
     float monoBassFreq = 120.0f;
     bool monoBassEnabled = true;
+    bool visualsEnabled = true;
+
+    // Runs before mono bass, so the lows it adds to the side are folded back to mono
+    Decorrelator decorrelator;
+
+    // Multirate mono bass: only the side of the lows is removed, so just the side signal
+    // is filtered at the reduced rate and subtracted from monoBassSplit's delayed allpass
+    bool isMonoBassReducedRate() const { return multirateEnabled && monoBassResampler.isActive(); }
+    void processMonoBassReducedRate(float* left, float* right, int numSamples);
+
+    bool multirateEnabled = false;
+    Multirate::LowBandResampler monoBassResampler;  // In: side. Out: low side
+    Multirate::DelayLine monoBassDelay;
+    LR4Crossover reducedMonoBassSplit;
+    std::vector<float> reducedScratch;
 
     // Metering
     std::atomic<float> correlation { 0.0f };
@@ -64,11 +162,37 @@ private:
     int corrSampleCount = 0;
     static constexpr int corrWindowSize = 2048;
 
+    // Level sums, averaged over a level frame (gathered across calls, so tiny host
+    // blocks don't make the meters jitter)
+    static constexpr double levelFramesPerSecond = 100.0;
+    LevelSums levelAccumulator {};
+    int levelSampleCount = 0;
+    int levelFrameSamples = 441;
+
+    // Metered samples from calls shorter than a run, held until there's a run's worth
+    static constexpr int meterRunSize = 64;
+    std::array<float, meterRunSize> pendingMeterL {}, pendingMeterR {};
+    int pendingMeterSamples = 0;
+
     // Vectorscope buffer (circular buffer for display)
+    // The audio thread fills its own ring and only try-locks once per level frame to
+    // publish it, so processing never blocks on the editor.
+    static constexpr int vectorscopeBufferSize = 512;
     mutable std::mutex vectorscopeMutex;
     std::vector<std::pair<float, float>> vectorscopeBuffer;
+    std::array<float, vectorscopeBufferSize> vectorscopeRingL {}, vectorscopeRingR {};
     int vectorscopeWriteIndex = 0;
-    static constexpr int vectorscopeBufferSize = 512;
+    int vectorscopeSkip = 0;        // Samples before the next one the ring keeps
+
+    // Stereo field histogram: accumulated on the audio thread, published like the vectorscope
+    static constexpr double fieldFramesPerSecond = 30.0;
+    StereoField fieldAccumulator {};
+    int fieldSampleCount = 0;
+    int fieldFrameSamples = 1470;
+    mutable std::mutex stereoFieldMutex;
+    StereoField stereoField {};
+
+    TraceRecorder* traceRecorder = nullptr;
 
     // Runtime info
     double currentSampleRate = 44100.0;
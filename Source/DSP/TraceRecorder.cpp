@@ -0,0 +1,102 @@
+#include "TraceRecorder.h"
+
+void TraceRecorder::setEnabled(bool shouldRecord)
+{
+    // The ring is kept once allocated, so a later disable can't free it under record()
+    if (shouldRecord && events.empty())
+        events.resize(capacity);
+
+    enabled.store(shouldRecord, std::memory_order_release);
+}
+
+bool TraceRecorder::writeChromeTrace(const juce::File& file)
+{
+    // Stop the audio thread from writing while the ring is copied. A record() call that
+    // already passed the pause check can still land in the slot after the last published
+    // event, so the oldest slot (which it would overwrite) is skipped.
+    paused.store(true);
+    const auto end = writeIndex.load(std::memory_order_acquire);
+    const auto begin = end > static_cast<juce::uint64>(capacity - 1) ? end - (capacity - 1) : 0;
+
+    std::vector<Event> snapshot;
+    snapshot.reserve(static_cast<size_t>(end - begin));
+    for (auto i = begin; i < end; ++i)
+        snapshot.push_back(events[static_cast<size_t>(i & (capacity - 1))]);
+
+    paused.store(false);
+
+    if (snapshot.empty())
+        return false;
+
+    const double ticksToMicros = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    const auto origin = snapshot.front().ticks;
+
+    juce::MemoryOutputStream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Audio\"}}";
+
+    auto writeEvent = [&](const char* name, char phase, const Event& e, const juce::String& args)
+    {
+        json << ",\n{\"name\":\"" << name << "\",\"ph\":\"" << juce::String::charToString(phase)
+             << "\",\"pid\":1,\"tid\":1,\"ts\":" << juce::String((e.ticks - origin) * ticksToMicros, 3);
+
+        if (phase == 'i')
+            json << ",\"s\":\"t\"";
+
+        if (args.isNotEmpty())
+            json << ",\"args\":{" << args << "}";
+
+        json << "}";
+    };
+
+    auto coefficientName = [](juce::uint8 id)
+    {
+        switch (id)
+        {
+            case MonoBass:          return "Mono Bass Coefficients";
+            case LowMidCrossover:   return "Low-Mid Crossover Coefficients";
+            case MidHighCrossover:  return "Mid-High Crossover Coefficients";
+            default:                return "Coefficients";
+        }
+    };
+
+    // Events from a block that was cut off by the ring wrapping would leave unmatched
+    // end events; skip forward to the first block start.
+    size_t first = 0;
+    while (first < snapshot.size() && snapshot[first].type != BlockBegin)
+        ++first;
+
+    for (size_t i = first; i < snapshot.size(); ++i)
+    {
+        const auto& e = snapshot[i];
+        const auto stageName = StageProfiler::getStageName(static_cast<StageProfiler::Stage>(e.id));
+
+        switch (e.type)
+        {
+            case BlockBegin:
+                writeEvent("processBlock", 'B', e, "\"samples\":" + juce::String(e.numSamples));
+                break;
+            case BlockEnd:
+                writeEvent("processBlock", 'E', e, {});
+                break;
+            case StageBegin:
+                writeEvent(stageName, 'B', e, {});
+                break;
+            case StageEnd:
+                writeEvent(stageName, 'E', e, {});
+                break;
+            case CoefficientUpdate:
+                writeEvent(coefficientName(e.id), 'i', e, "\"frequency\":" + juce::String(e.value, 2));
+                break;
+            case VectorscopeContended:
+                writeEvent("Vectorscope Lock Contended", 'i', e, {});
+                break;
+            default:
+                break;
+        }
+    }
+
+    json << "\n]}\n";
+
+    return file.replaceWithData(json.getData(), json.getDataSize());
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "StageProfiler.h"
+
+// Compile-time switch for the audio-thread trace recorder. On by default; only
+// records at runtime once enabled (the processor enables it in the Standalone build).
+// The ring is allocated on first enable, so plugin instances never pay for it.
+#ifndef STEREOIMAGER_TRACING
+ #define STEREOIMAGER_TRACING 1
+#endif
+
+// Timeline recorder for audio-thread activity.
+// The audio thread writes fixed-size binary events into a preallocated ring with no
+// allocation, locking or I/O. The message thread pauses recording, copies the ring
+// and writes it out as Chrome Trace Event JSON (loads in chrome://tracing and Perfetto).
+class TraceRecorder
+{
+public:
+    enum EventType : juce::uint8
+    {
+        BlockBegin = 0,
+        BlockEnd,
+        StageBegin,
+        StageEnd,
+        CoefficientUpdate,      // id = Coefficients, value = new frequency
+        VectorscopeContended    // Editor held the buffer, points kept for the next block
+    };
+
+    enum Coefficients : juce::uint8
+    {
+        MonoBass = 0,
+        LowMidCrossover,
+        MidHighCrossover
+    };
+
+    struct Event
+    {
+        juce::int64 ticks = 0;
+        EventType type = BlockBegin;
+        juce::uint8 id = 0;
+        juce::uint16 numSamples = 0;
+        float value = 0.0f;
+    };
+
+    static constexpr int capacity = 1 << 16;   // Power of two, ~1 MB of events
+
+    TraceRecorder() = default;
+
+    // Not on the audio thread: the first enable allocates the ring
+    void setEnabled(bool shouldRecord);
+    bool isEnabled() const { return enabled.load(); }
+
+    // Audio thread
+    void record(EventType type, juce::uint8 id = 0, float value = 0.0f, int numSamples = 0)
+    {
+        if (! enabled.load(std::memory_order_acquire) || paused.load(std::memory_order_acquire))
+            return;
+
+        const auto index = writeIndex.load(std::memory_order_relaxed);
+        auto& e = events[static_cast<size_t>(index & (capacity - 1))];
+        e.ticks = juce::Time::getHighResolutionTicks();
+        e.type = type;
+        e.id = id;
+        e.numSamples = static_cast<juce::uint16>(juce::jmin(numSamples, 0xffff));
+        e.value = value;
+        writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    // Message thread: dump the current ring contents as Chrome Trace Event JSON
+    bool writeChromeTrace(const juce::File& file);
+
+    // Records begin/end events for a processBlock call. Whether the block is recorded is
+    // decided once here, so its stages cost a flag test while recording is off.
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(TraceRecorder& r, int numSamples) : recorder(r)
+        {
+            recorder.recordingBlock = recorder.enabled.load(std::memory_order_acquire);
+
+            if (recorder.recordingBlock)
+                recorder.record(BlockBegin, 0, 0.0f, numSamples);
+        }
+
+        ~ScopedBlock()
+        {
+            if (recorder.recordingBlock)
+                recorder.record(BlockEnd);
+
+            recorder.recordingBlock = false;
+        }
+
+    private:
+        TraceRecorder& recorder;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    // Records begin/end events for a stage of processBlock, if the block is recorded
+    class ScopedStage
+    {
+    public:
+        ScopedStage(TraceRecorder& r, StageProfiler::Stage s)
+            : recorder(r), stage(static_cast<juce::uint8>(s)), active(r.recordingBlock)
+        {
+            if (active)
+                recorder.record(StageBegin, stage);
+        }
+
+        ~ScopedStage()
+        {
+            if (active)
+                recorder.record(StageEnd, stage);
+        }
+
+    private:
+        TraceRecorder& recorder;
+        juce::uint8 stage;
+        bool active;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+
+private:
+    std::vector<Event> events;
+    std::atomic<juce::uint64> writeIndex { 0 };
+    std::atomic<bool> enabled { false };
+    std::atomic<bool> paused { false };
+    bool recordingBlock = false;        // Audio thread only, set by ScopedBlock
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TraceRecorder)
+};
+
+#if STEREOIMAGER_TRACING
+ #define STEREOIMAGER_TRACE_BLOCK(recorder, numSamples) \
+     TraceRecorder::ScopedBlock tracedBlock ((recorder), (numSamples))
+ #define STEREOIMAGER_TRACE_EVENT(recorder, ...) (recorder).record(__VA_ARGS__)
+ #define STEREOIMAGER_TRACE_STAGE(recorder, stage) \
+     TraceRecorder::ScopedStage JUCE_JOIN_MACRO(tracedStage_, __LINE__) ((recorder), StageProfiler::stage)
+#else
+ #define STEREOIMAGER_TRACE_BLOCK(recorder, numSamples)
+ #define STEREOIMAGER_TRACE_EVENT(recorder, ...)
+ #define STEREOIMAGER_TRACE_STAGE(recorder, stage)
+#endif
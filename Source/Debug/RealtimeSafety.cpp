@@ -0,0 +1,308 @@
+#include "RealtimeSafety.h"
+
+#if STEREOIMAGER_RT_CHECKS
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <poll.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <sys/select.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    // initial-exec TLS never allocates on first access, which matters inside malloc
+   #if JUCE_LINUX
+    #define REALTIME_TLS thread_local __attribute__((tls_model("initial-exec")))
+   #else
+    #define REALTIME_TLS thread_local
+   #endif
+
+    REALTIME_TLS int realtimeDepth = 0;
+    REALTIME_TLS int allowDepth = 0;
+
+    std::atomic<RealtimeSafety::ViolationHandler> violationHandler { nullptr };
+
+    void reportViolation(const char* functionName)
+    {
+        RealtimeSafety::ScopedAllowNonRealtime allow;
+        auto stackTrace = juce::SystemStats::getStackBacktrace();
+
+        if (auto handler = violationHandler.load())
+        {
+            handler(functionName, stackTrace.toRawUTF8());
+            return;
+        }
+
+        std::fprintf(stderr, "\n*** Real-time violation: %s called on the audio thread ***\n%s\n",
+                     functionName, stackTrace.toRawUTF8());
+        std::fflush(stderr);
+        std::abort();
+    }
+}
+
+namespace RealtimeSafety
+{
+    ScopedAudioThread::ScopedAudioThread()  { ++realtimeDepth; }
+    ScopedAudioThread::~ScopedAudioThread() { --realtimeDepth; }
+
+    ScopedAllowNonRealtime::ScopedAllowNonRealtime()  { ++allowDepth; }
+    ScopedAllowNonRealtime::~ScopedAllowNonRealtime() { --allowDepth; }
+
+    void checkCall(const char* functionName)
+    {
+        if (realtimeDepth > 0 && allowDepth == 0)
+            reportViolation(functionName);
+    }
+
+    void setViolationHandler(ViolationHandler handler) { violationHandler.store(handler); }
+
+    bool isEnabled() { return true; }
+}
+
+//==============================================================================
+// Interposed C functions (Linux/glibc)
+#if JUCE_LINUX
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+}
+
+namespace
+{
+    void* rawMalloc(size_t size)                   { return __libc_malloc(size); }
+    void* rawAlignedMalloc(size_t align, size_t n) { return __libc_memalign(align, n); }
+    void rawFree(void* ptr)                        { __libc_free(ptr); }
+
+    // Resolved without function-local statics: their guards take a mutex, which
+    // would recurse into the interposed pthread_mutex_lock.
+    template <typename Fn>
+    Fn resolveNext(Fn& cached, const char* name)
+    {
+        if (cached == nullptr)
+            cached = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+        return cached;
+    }
+
+    int (*nextMutexLock)(pthread_mutex_t*) = nullptr;
+    int (*nextCondWait)(pthread_cond_t*, pthread_mutex_t*) = nullptr;
+    int (*nextCondTimedWait)(pthread_cond_t*, pthread_mutex_t*, const timespec*) = nullptr;
+    int (*nextSemWait)(sem_t*) = nullptr;
+    ssize_t (*nextRead)(int, void*, size_t) = nullptr;
+    ssize_t (*nextWrite)(int, const void*, size_t) = nullptr;
+    int (*nextNanosleep)(const timespec*, timespec*) = nullptr;
+    int (*nextUsleep)(useconds_t) = nullptr;
+    int (*nextPoll)(pollfd*, nfds_t, int) = nullptr;
+    int (*nextSelect)(int, fd_set*, fd_set*, fd_set*, timeval*) = nullptr;
+
+    // Resolve everything up front so dlsym's own allocations never happen on the audio thread
+    struct ResolveAtStartup
+    {
+        ResolveAtStartup()
+        {
+            resolveNext(nextMutexLock, "pthread_mutex_lock");
+            resolveNext(nextCondWait, "pthread_cond_wait");
+            resolveNext(nextCondTimedWait, "pthread_cond_timedwait");
+            resolveNext(nextSemWait, "sem_wait");
+            resolveNext(nextRead, "read");
+            resolveNext(nextWrite, "write");
+            resolveNext(nextNanosleep, "nanosleep");
+            resolveNext(nextUsleep, "usleep");
+            resolveNext(nextPoll, "poll");
+            resolveNext(nextSelect, "select");
+        }
+    };
+
+    ResolveAtStartup resolveAtStartup;
+}
+
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("realloc");
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+            RealtimeSafety::checkCall("free");
+        __libc_free(ptr);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("posix_memalign");
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        RealtimeSafety::checkCall("pthread_mutex_lock");
+        return resolveNext(nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+    {
+        RealtimeSafety::checkCall("pthread_cond_wait");
+        return resolveNext(nextCondWait, "pthread_cond_wait")(cond, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const timespec* abstime)
+    {
+        RealtimeSafety::checkCall("pthread_cond_timedwait");
+        return resolveNext(nextCondTimedWait, "pthread_cond_timedwait")(cond, mutex, abstime);
+    }
+
+    int sem_wait(sem_t* sem)
+    {
+        RealtimeSafety::checkCall("sem_wait");
+        return resolveNext(nextSemWait, "sem_wait")(sem);
+    }
+
+    ssize_t read(int fd, void* buffer, size_t count)
+    {
+        RealtimeSafety::checkCall("read");
+        return resolveNext(nextRead, "read")(fd, buffer, count);
+    }
+
+    ssize_t write(int fd, const void* buffer, size_t count)
+    {
+        RealtimeSafety::checkCall("write");
+        return resolveNext(nextWrite, "write")(fd, buffer, count);
+    }
+
+    int nanosleep(const timespec* duration, timespec* remaining)
+    {
+        RealtimeSafety::checkCall("nanosleep");
+        return resolveNext(nextNanosleep, "nanosleep")(duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        RealtimeSafety::checkCall("usleep");
+        return resolveNext(nextUsleep, "usleep")(microseconds);
+    }
+
+    int poll(pollfd* fds, nfds_t numFds, int timeout)
+    {
+        RealtimeSafety::checkCall("poll");
+        return resolveNext(nextPoll, "poll")(fds, numFds, timeout);
+    }
+
+    int select(int numFds, fd_set* readFds, fd_set* writeFds, fd_set* exceptFds, timeval* timeout)
+    {
+        RealtimeSafety::checkCall("select");
+        return resolveNext(nextSelect, "select")(numFds, readFds, writeFds, exceptFds, timeout);
+    }
+}
+
+#elif ! JUCE_WINDOWS
+
+namespace
+{
+    void* rawMalloc(size_t size)                   { return std::malloc(size); }
+    void* rawAlignedMalloc(size_t align, size_t n) { return std::aligned_alloc(align, (n + align - 1) / align * align); }
+    void rawFree(void* ptr)                        { std::free(ptr); }
+}
+
+#endif
+
+//==============================================================================
+// Replacement global allocation functions (not on Windows, where the CRT's aligned
+// allocations need a matching _aligned_free)
+#if ! JUCE_WINDOWS
+
+namespace
+{
+    void* checkedNew(size_t size, const char* name)
+    {
+        RealtimeSafety::checkCall(name);
+        if (auto* ptr = rawMalloc(size == 0 ? 1 : size))
+            return ptr;
+        throw std::bad_alloc();
+    }
+
+    void* checkedAlignedNew(size_t size, std::align_val_t alignment, const char* name)
+    {
+        RealtimeSafety::checkCall(name);
+        if (auto* ptr = rawAlignedMalloc(static_cast<size_t>(alignment), size == 0 ? 1 : size))
+            return ptr;
+        throw std::bad_alloc();
+    }
+
+    void checkedDelete(void* ptr, const char* name) noexcept
+    {
+        if (ptr != nullptr)
+            RealtimeSafety::checkCall(name);
+        rawFree(ptr);
+    }
+}
+
+void* operator new(size_t size)                                         { return checkedNew(size, "operator new"); }
+void* operator new[](size_t size)                                       { return checkedNew(size, "operator new[]"); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept         { try { return checkedNew(size, "operator new"); } catch (...) { return nullptr; } }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept       { try { return checkedNew(size, "operator new[]"); } catch (...) { return nullptr; } }
+void* operator new(size_t size, std::align_val_t alignment)             { return checkedAlignedNew(size, alignment, "operator new"); }
+void* operator new[](size_t size, std::align_val_t alignment)           { return checkedAlignedNew(size, alignment, "operator new[]"); }
+
+void operator delete(void* ptr) noexcept                                { checkedDelete(ptr, "operator delete"); }
+void operator delete[](void* ptr) noexcept                              { checkedDelete(ptr, "operator delete[]"); }
+void operator delete(void* ptr, size_t) noexcept                        { checkedDelete(ptr, "operator delete"); }
+void operator delete[](void* ptr, size_t) noexcept                      { checkedDelete(ptr, "operator delete[]"); }
+void operator delete(void* ptr, std::align_val_t) noexcept              { checkedDelete(ptr, "operator delete"); }
+void operator delete[](void* ptr, std::align_val_t) noexcept            { checkedDelete(ptr, "operator delete[]"); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept      { checkedDelete(ptr, "operator delete"); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept    { checkedDelete(ptr, "operator delete[]"); }
+
+#endif
+
+#else
+
+namespace RealtimeSafety
+{
+    ScopedAudioThread::ScopedAudioThread() {}
+    ScopedAudioThread::~ScopedAudioThread() {}
+
+    ScopedAllowNonRealtime::ScopedAllowNonRealtime() {}
+    ScopedAllowNonRealtime::~ScopedAllowNonRealtime() {}
+
+    void checkCall(const char*) {}
+    void setViolationHandler(ViolationHandler) {}
+    bool isEnabled() { return false; }
+}
+
+#endif
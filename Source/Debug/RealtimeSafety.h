@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Compile-time switch for the real-time safety checker (debug/test builds only).
+#ifndef STEREOIMAGER_RT_CHECKS
+ #define STEREOIMAGER_RT_CHECKS 0
+#endif
+
+// Catches real-time violations on the thread running processBlock.
+// With STEREOIMAGER_RT_CHECKS enabled, operator new/delete are replaced (except on
+// Windows) and, on Linux, malloc/free, pthread mutex/condition waits and common
+// blocking syscalls are interposed. Any of these inside a ScopedAudioThread prints
+// the call and a stack trace and aborts.
+//
+// Interposition of the C functions only takes effect in executables (Standalone,
+// the headless host); a plugin loaded into a host sees the host's symbols first.
+namespace RealtimeSafety
+{
+    // Marks the current thread as real-time for the lifetime of the object
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread();
+        ~ScopedAudioThread();
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+
+    // Temporarily allows non-real-time calls on the audio thread (e.g. a host callback
+    // we know is safe, or the checker's own reporting)
+    class ScopedAllowNonRealtime
+    {
+    public:
+        ScopedAllowNonRealtime();
+        ~ScopedAllowNonRealtime();
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllowNonRealtime)
+    };
+
+    // Called by the interposed functions; reports and aborts if the calling thread is real-time
+    void checkCall(const char* functionName);
+
+    // Replaces the default abort, e.g. so a harness can count violations instead
+    using ViolationHandler = void (*)(const char* functionName, const char* stackTrace);
+    void setViolationHandler(ViolationHandler handler);
+
+    bool isEnabled();
+}
+
+#if STEREOIMAGER_RT_CHECKS
+ #define STEREOIMAGER_REALTIME_SCOPE \
+     RealtimeSafety::ScopedAudioThread realtimeScope
+#else
+ #define STEREOIMAGER_REALTIME_SCOPE
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Sample-accurate parameter changes for the next processBlock call, from code that drives
+// the processor itself: the offline renderer (--automation) and the tests.
+//
+// This isn't a route for host automation. JUCE 7 has no API that hands a plugin a host's
+// sample-accurate automation queues (it passes only the last value of each), so host
+// automation arrives as ordinary parameter changes, read like any other. The driver fills
+// this list on the audio thread, just before processBlock; processBlock splits the block
+// at each change offset and empties the list.
+//
+// An event's value holds until the next event for that parameter, or until the parameter
+// is changed from outside. The parameters themselves catch up with the last event for each
+// from the processor's timer, so the controls and the host show where the events left
+// them; a state saved before then holds the events' values already.
+class ParameterEvents
+{
+public:
+    static constexpr int capacity = 512;
+
+    struct Event
+    {
+        int sampleOffset;       // From the start of the block
+        int parameterIndex;     // In getParameters() order
+        float value;            // Parameter units (Hz, %, dB; choices by index)
+    };
+
+    // Kept in offset order, earlier events first at the same offset. False if full.
+    bool add(int sampleOffset, int parameterIndex, float value)
+    {
+        if (numEvents == capacity)
+            return false;
+
+        int position = numEvents++;
+        for (; position > 0 && events[static_cast<size_t>(position - 1)].sampleOffset > sampleOffset; --position)
+            events[static_cast<size_t>(position)] = events[static_cast<size_t>(position - 1)];
+
+        events[static_cast<size_t>(position)] = { sampleOffset, parameterIndex, value };
+        return true;
+    }
+
+    void clear() { numEvents = 0; }
+
+    bool isEmpty() const { return numEvents == 0; }
+    int size() const { return numEvents; }
+    const Event& operator[](int index) const { return events[static_cast<size_t>(index)]; }
+
+private:
+    std::array<Event, capacity> events {};
+    int numEvents = 0;
+};
@@ -2,7 +2,10 @@
 #include "PluginEditor.h"
 
 StereoImagerAudioProcessorEditor::StereoImagerAudioProcessorEditor(StereoImagerAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), spectralCurveEditor(p.getAPVTS()), historyView(p.getMeterHistory())
+   #if STEREOIMAGER_PROFILING
+    , profilerPanel(p.getProfiler())
+   #endif
 {
     // Create and set LookAndFeel
     lookAndFeel = std::make_unique<StereoImagerLookAndFeel>();
@@ -37,6 +40,23 @@ StereoImagerAudioProcessorEditor::StereoImagerAudioProcessorEditor(StereoImagerA
     bypassButton.setButtonText("Bypass");
     addAndMakeVisible(bypassButton);
 
+    traceButton.setButtonText("Save Trace");
+    traceButton.setTooltip("Write the recent audio-thread timeline as a Chrome trace (chrome://tracing, Perfetto)");
+    traceButton.onClick = [this] { saveTrace(); };
+    addChildComponent(traceButton);
+    traceButton.setVisible(STEREOIMAGER_TRACING
+                           && audioProcessor.wrapperType == juce::AudioProcessor::wrapperType_Standalone);
+
+    storeAButton.setButtonText("Store A");
+    storeAButton.setTooltip("Keep the current settings as User A, to morph from or to");
+    storeAButton.onClick = [this] { audioProcessor.getPresetBank().storeUserSlot(0); };
+    addAndMakeVisible(storeAButton);
+
+    storeBButton.setButtonText("Store B");
+    storeBButton.setTooltip("Keep the current settings as User B, to morph from or to");
+    storeBButton.onClick = [this] { audioProcessor.getPresetBank().storeUserSlot(1); };
+    addAndMakeVisible(storeBButton);
+
     // Multiband controls
     multibandButton.setButtonText("Multiband");
     addAndMakeVisible(multibandButton);
@@ -56,23 +76,40 @@ StereoImagerAudioProcessorEditor::StereoImagerAudioProcessorEditor(StereoImagerA
     setupSlider(highWidthSlider, highWidthLabel, "HIGH");
     highWidthSlider.setTextValueSuffix(" %");
 
+    // Spectral width curve controls
+    spectralButton.setButtonText("Spectral");
+    addAndMakeVisible(spectralButton);
+
+    spectralFftSizeBox.addItemList({ "512", "1024", "2048", "4096" }, 1);
+    addAndMakeVisible(spectralFftSizeBox);
+    setupLabel(spectralFftSizeLabel, "FFT SIZE", 10.0f, juce::Justification::centredLeft);
+
+    addAndMakeVisible(spectralCurveEditor);
+
     // Meters
     addAndMakeVisible(inputMeter);
     addAndMakeVisible(outputMeter);
     addAndMakeVisible(correlationMeter);
     addAndMakeVisible(vectorscope);
+    addAndMakeVisible(stereoFieldDisplay);
     addAndMakeVisible(bandMeter);
     addAndMakeVisible(midMeter);
     addAndMakeVisible(sideMeter);
+    addAndMakeVisible(historyView);
 
     // Meter labels
     setupLabel(inputMeterLabel, "IN", 10.0f);
     setupLabel(outputMeterLabel, "OUT", 10.0f);
     setupLabel(correlationLabel, "CORRELATION", 10.0f);
     setupLabel(vectorscopeLabel, "VECTORSCOPE", 10.0f);
+    setupLabel(stereoFieldLabel, "STEREO FIELD", 10.0f);
     setupLabel(midMeterLabel, "M", 10.0f);
     setupLabel(sideMeterLabel, "S", 10.0f);
 
+   #if STEREOIMAGER_PROFILING
+    addAndMakeVisible(profilerPanel);
+   #endif
+
     // Create attachments
     widthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getAPVTS(), "width", widthSlider);
@@ -104,10 +141,19 @@ StereoImagerAudioProcessorEditor::StereoImagerAudioProcessorEditor(StereoImagerA
     highWidthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getAPVTS(), "highWidth", highWidthSlider);
 
+    spectralAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getAPVTS(), "spectralWidth", spectralButton);
+    spectralFftSizeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getAPVTS(), "spectralFftSize", spectralFftSizeBox);
+
     // Start timer for metering updates
     startTimerHz(30);
 
-    setSize(800, 550);
+   #if STEREOIMAGER_PROFILING
+    setSize(800, 550 + spectralHeight + historyHeight + profilerHeight);
+   #else
+    setSize(800, 550 + spectralHeight + historyHeight);
+   #endif
 }
 
 StereoImagerAudioProcessorEditor::~StereoImagerAudioProcessorEditor()
@@ -127,6 +173,17 @@ void StereoImagerAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::L
     setupLabel(label, labelText);
 }
 
+void StereoImagerAudioProcessorEditor::saveTrace()
+{
+    auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+                    .getNonexistentChildFile("StereoImager-trace-"
+                                                 + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S"),
+                                             ".json");
+
+    if (audioProcessor.getTraceRecorder().writeChromeTrace(file))
+        file.revealToUser();
+}
+
 void StereoImagerAudioProcessorEditor::setupLabel(juce::Label& label, const juce::String& text,
                                                    float fontSize, juce::Justification justification)
 {
@@ -158,12 +215,31 @@ void StereoImagerAudioProcessorEditor::paint(juce::Graphics& g)
     g.setColour(Colors::panelBg);
     g.fillRoundedRectangle(10.0f, 290.0f, 780.0f, 250.0f, 8.0f);
 
+    // Spectral section panel
+    g.setColour(Colors::panelBg);
+    g.fillRoundedRectangle(10.0f, 550.0f, 780.0f, (float)spectralHeight - 10.0f, 8.0f);
+
+    // History section panel
+    g.setColour(Colors::panelBg);
+    g.fillRoundedRectangle(10.0f, 550.0f + spectralHeight, 780.0f, (float)historyHeight - 10.0f, 8.0f);
+
+   #if STEREOIMAGER_PROFILING
+    // Profiler section panel
+    g.setColour(Colors::panelBg);
+    g.fillRoundedRectangle(10.0f, 550.0f + spectralHeight + historyHeight, 780.0f, (float)profilerHeight - 10.0f, 8.0f);
+   #endif
+
     // Section labels
     g.setColour(Colors::textSecondary);
     g.setFont(11.0f);
     g.drawText("STEREO", 20, 65, 100, 16, juce::Justification::centredLeft);
     g.drawText("MULTIBAND", 410, 65, 100, 16, juce::Justification::centredLeft);
     g.drawText("ANALYSIS", 20, 295, 100, 16, juce::Justification::centredLeft);
+    g.drawText("SPECTRAL", 20, 555, 100, 16, juce::Justification::centredLeft);
+    g.drawText("HISTORY", 20, 555 + spectralHeight, 100, 16, juce::Justification::centredLeft);
+   #if STEREOIMAGER_PROFILING
+    g.drawText("AUDIO THREAD", 20, 555 + spectralHeight + historyHeight, 100, 16, juce::Justification::centredLeft);
+   #endif
 }
 
 void StereoImagerAudioProcessorEditor::resized()
@@ -174,6 +250,9 @@ void StereoImagerAudioProcessorEditor::resized()
     auto header = bounds.removeFromTop(50);
     titleLabel.setBounds(header.reduced(15, 10));
     bypassButton.setBounds(header.removeFromRight(100).reduced(10, 12));
+    traceButton.setBounds(header.removeFromRight(100).reduced(5, 12));
+    storeBButton.setBounds(header.removeFromRight(80).reduced(5, 12));
+    storeAButton.setBounds(header.removeFromRight(80).reduced(5, 12));
 
     // Main content
     auto mainArea = bounds.reduced(10, 0);
@@ -258,8 +337,27 @@ void StereoImagerAudioProcessorEditor::resized()
     highWidthLabel.setBounds(highArea.removeFromTop(labelHeight));
     highWidthSlider.setBounds(highArea);
 
+    // Spectral curve (below the analysis section), its switch and FFT size on the left
+    auto spectralPanel = getLocalBounds().withTrimmedTop(550).withHeight(spectralHeight).reduced(20, 10).withTrimmedTop(14);
+    auto spectralControls = spectralPanel.removeFromLeft(110);
+    spectralButton.setBounds(spectralControls.removeFromTop(24));
+    spectralControls.removeFromTop(10);
+    spectralFftSizeLabel.setBounds(spectralControls.removeFromTop(14).withWidth(90));
+    spectralFftSizeBox.setBounds(spectralControls.removeFromTop(24).withWidth(90));
+    spectralCurveEditor.setBounds(spectralPanel);
+
+    // History strip (below the spectral curve)
+    historyView.setBounds(getLocalBounds().withTrimmedTop(550 + spectralHeight).withHeight(historyHeight)
+                              .reduced(20, 10).withTrimmedTop(14));
+
+   #if STEREOIMAGER_PROFILING
+    // Profiler strip (below the history)
+    profilerPanel.setBounds(getLocalBounds().removeFromBottom(profilerHeight)
+                                .reduced(20, 10).withTrimmedLeft(110));
+   #endif
+
     // Analysis/Meters section
-    auto metersPanel = getLocalBounds().reduced(10);
+    auto metersPanel = getLocalBounds().withHeight(550).reduced(10);
     metersPanel.removeFromTop(290);
     metersPanel = metersPanel.reduced(10, 10);
 
@@ -304,6 +402,11 @@ void StereoImagerAudioProcessorEditor::resized()
     corrArea.removeFromTop(20);
     correlationLabel.setBounds(corrArea.removeFromTop(14));
     correlationMeter.setBounds(corrArea.removeFromTop(40).withWidth(200));
+
+    // Stereo field (under the correlation meter)
+    corrArea.removeFromTop(6);
+    stereoFieldLabel.setBounds(corrArea.removeFromTop(14).withWidth(200));
+    stereoFieldDisplay.setBounds(corrArea.withWidth(200));
 }
 
 void StereoImagerAudioProcessorEditor::timerCallback()
@@ -346,4 +449,15 @@ void StereoImagerAudioProcessorEditor::timerCallback()
     std::vector<std::pair<float, float>> samples;
     audioProcessor.getStereoSamples(samples);
     vectorscope.setSamples(samples);
+
+    // Stereo field
+    StereoProcessor::StereoField field;
+    audioProcessor.getStereoField(field);
+    stereoFieldDisplay.setField(field.data(), static_cast<int>(field.size()));
+
+    historyView.update();
+
+   #if STEREOIMAGER_PROFILING
+    profilerPanel.update();
+   #endif
 }
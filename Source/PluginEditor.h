@@ -2,8 +2,11 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "UI/HistoryView.h"
 #include "UI/LookAndFeel.h"
 #include "UI/MeterComponents.h"
+#include "UI/ProfilerPanel.h"
+#include "UI/SpectralCurveEditor.h"
 
 class StereoImagerAudioProcessorEditor : public juce::AudioProcessorEditor,
                                           public juce::Timer
@@ -31,6 +34,8 @@ private:
     juce::Slider inputGainSlider;
     juce::Slider outputGainSlider;
     juce::ToggleButton bypassButton;
+    juce::TextButton traceButton;   // Standalone only: dump the audio-thread timeline
+    juce::TextButton storeAButton, storeBButton;    // Current settings into the user morph slots
 
     // Multiband controls
     juce::ToggleButton multibandButton;
@@ -40,6 +45,13 @@ private:
     juce::Slider midWidthSlider;
     juce::Slider highWidthSlider;
 
+    // Spectral width curve controls
+    juce::ToggleButton spectralButton;
+    juce::ComboBox spectralFftSizeBox;
+    juce::Label spectralFftSizeLabel;
+    SpectralCurveEditor spectralCurveEditor;
+    static constexpr int spectralHeight = 170;
+
     // Labels
     juce::Label widthLabel, panLabel, balanceLabel, monoBassLabel;
     juce::Label inputGainLabel, outputGainLabel;
@@ -52,15 +64,26 @@ private:
     StereoMeter outputMeter;
     CorrelationMeter correlationMeter;
     Vectorscope vectorscope;
+    StereoFieldDisplay stereoFieldDisplay;
     BandMeter bandMeter;
     LevelMeter midMeter;
     LevelMeter sideMeter;
 
     // Labels for meters
     juce::Label inputMeterLabel, outputMeterLabel;
-    juce::Label correlationLabel, vectorscopeLabel;
+    juce::Label correlationLabel, vectorscopeLabel, stereoFieldLabel;
     juce::Label midMeterLabel, sideMeterLabel;
 
+    // Scrolling correlation, side/mid and band timelines
+    HistoryView historyView;
+    static constexpr int historyHeight = 170;
+
+   #if STEREOIMAGER_PROFILING
+    // Audio-thread stage timings (profiling builds only)
+    ProfilerPanel profilerPanel;
+    static constexpr int profilerHeight = 110;
+   #endif
+
     // Smoothed levels for display
     float smoothedInputL = 0.0f;
     float smoothedInputR = 0.0f;
@@ -85,8 +108,12 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> midWidthAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highWidthAttachment;
 
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> spectralAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> spectralFftSizeAttachment;
+
     void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& labelText,
                      juce::Slider::SliderStyle style = juce::Slider::RotaryHorizontalVerticalDrag);
+    void saveTrace();
     void setupLabel(juce::Label& label, const juce::String& text, float fontSize = 12.0f,
                     juce::Justification justification = juce::Justification::centred);
 
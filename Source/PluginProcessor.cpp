@@ -1,33 +1,89 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Debug/RealtimeSafety.h"
 
 StereoImagerAudioProcessor::StereoImagerAudioProcessor()
      : AudioProcessor(BusesProperties()
                       .withInput("Input", juce::AudioChannelSet::stereo(), true)
                       .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-       apvts(*this, nullptr, "Parameters", createParameterLayout())
+       apvts(*this, nullptr, "Parameters", createParameterLayout()),
+       compactState(getParameters()),
+       presetBank(getParameters())
 {
-    // Cache parameter pointers
-    widthParam = apvts.getRawParameterValue("width");
-    panParam = apvts.getRawParameterValue("pan");
-    balanceParam = apvts.getRawParameterValue("balance");
-    monoBassFreqParam = apvts.getRawParameterValue("monoBassFreq");
-    monoBassEnabledParam = apvts.getRawParameterValue("monoBassEnabled");
-    inputGainParam = apvts.getRawParameterValue("inputGain");
-    outputGainParam = apvts.getRawParameterValue("outputGain");
-    bypassParam = apvts.getRawParameterValue("bypass");
+    // Cache the parameters' atomics, and where each one is among them
+    const auto& parameters = getParameters();
+    jassert(parameters.size() <= PresetBank::maxParameters);
+    numParameters = juce::jmin(PresetBank::maxParameters, parameters.size());
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        const auto id = static_cast<juce::RangedAudioParameter*>(parameters[i])->getParameterID();
+        rawParameters[static_cast<size_t>(i)] = apvts.getRawParameterValue(id);
+        apvts.addParameterListener(id, this);
+    }
+
+    lastReadValues.fill(std::numeric_limits<float>::quiet_NaN());
+    writtenBackValues.fill(std::numeric_limits<float>::quiet_NaN());
+
+    auto indexOf = [&](const juce::String& id)
+    {
+        for (int i = 0; i < numParameters; ++i)
+            if (static_cast<juce::RangedAudioParameter*>(parameters[i])->getParameterID() == id)
+                return i;
+
+        jassertfalse;
+        return 0;
+    };
+
+    widthIndex = indexOf("width");
+    panIndex = indexOf("pan");
+    balanceIndex = indexOf("balance");
+    monoBassFreqIndex = indexOf("monoBassFreq");
+    monoBassEnabledIndex = indexOf("monoBassEnabled");
+    inputGainIndex = indexOf("inputGain");
+    outputGainIndex = indexOf("outputGain");
+    bypassIndex = indexOf("bypass");
 
     // Multiband parameters
-    multibandEnabledParam = apvts.getRawParameterValue("multibandEnabled");
-    lowMidXoverParam = apvts.getRawParameterValue("lowMidXover");
-    midHighXoverParam = apvts.getRawParameterValue("midHighXover");
-    lowWidthParam = apvts.getRawParameterValue("lowWidth");
-    midWidthParam = apvts.getRawParameterValue("midWidth");
-    highWidthParam = apvts.getRawParameterValue("highWidth");
+    multibandEnabledIndex = indexOf("multibandEnabled");
+    lowMidXoverIndex = indexOf("lowMidXover");
+    midHighXoverIndex = indexOf("midHighXover");
+    lowWidthIndex = indexOf("lowWidth");
+    midWidthIndex = indexOf("midWidth");
+    highWidthIndex = indexOf("highWidth");
+    crossoverEngineIndex = indexOf("crossoverEngine");
+    multirateIndex = indexOf("multirate");
+    decorrelationIndex = indexOf("decorrelation");
+    targetCorrelationIndex = indexOf("targetCorrelation");
+
+    spectralEnabledIndex = indexOf("spectralWidth");
+    spectralFftSizeIndex = indexOf("spectralFftSize");
+    for (int node = 0; node < SpectralWidth::numNodes; ++node)
+    {
+        const juce::String prefix = "spectralNode" + juce::String(node + 1);
+        spectralNodeFreqIndices[(size_t) node] = indexOf(prefix + "Freq");
+        spectralNodeWidthIndices[(size_t) node] = indexOf(prefix + "Width");
+    }
+
+    presetMorphIndex = indexOf("presetMorph");
+    morphAIndex = indexOf("morphA");
+    morphBIndex = indexOf("morphB");
+    morphIndex = indexOf("morph");
+
+    stereoProcessor.setTraceRecorder(&traceRecorder);
+    multibandProcessor.setTraceRecorder(&traceRecorder);
+
+    // Latency changes the audio thread makes, and the morph's values, are passed on to the
+    // host from here
+    startTimerHz(30);
 }
 
 StereoImagerAudioProcessor::~StereoImagerAudioProcessor()
 {
+    stopTimer();
+
+    for (auto* parameter : getParameters())
+        apvts.removeParameterListener(static_cast<juce::RangedAudioParameter*>(parameter)->getParameterID(), this);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout StereoImagerAudioProcessor::createParameterLayout()
@@ -131,6 +187,96 @@ juce::AudioProcessorValueTreeState::ParameterLayout StereoImagerAudioProcessor::
         "Bypass",
         false));
 
+    // Parameters added after 1.0 go below, in the order they were added, so hosts that
+    // address parameters by index keep their automation. Their version hint is 2.
+
+    // Crossover filter topology (mono bass and multiband splits)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("crossoverEngine", 2),
+        "Crossover Engine",
+        juce::StringArray { "Biquad", "State Variable" },
+        0));
+
+    // Mono bass filter at a reduced rate at 88.2 kHz and above (adds latency)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("multirate", 2),
+        "Multirate Mono Bass",
+        false));
+
+    // Decorrelation: widens narrow sources towards a target correlation, mono-compatibly
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("decorrelation", 2),
+        "Decorrelation",
+        false));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("targetCorrelation", 2),
+        "Target Correlation",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f, 1.0f),
+        0.5f));
+
+    // Spectral width: a width curve over frequency instead of the bands, with its nodes
+    // log-spaced by default. The FFT size trades latency for low-frequency resolution.
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("spectralWidth", 2),
+        "Spectral Width",
+        false));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("spectralFftSize", 2),
+        "Spectral FFT Size",
+        juce::StringArray { "512", "1024", "2048", "4096" },
+        2));
+
+    const float defaultNodeFreqs[SpectralWidth::numNodes] = { 60.0f, 225.0f, 850.0f, 3200.0f, 12000.0f };
+
+    for (int node = 0; node < SpectralWidth::numNodes; ++node)
+    {
+        const juce::String number(node + 1);
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID("spectralNode" + number + "Freq", 2),
+            "Spectral Node " + number + " Freq",
+            juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.2f),
+            defaultNodeFreqs[node],
+            juce::AudioParameterFloatAttributes().withLabel("Hz")));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID("spectralNode" + number + "Width", 2),
+            "Spectral Node " + number + " Width",
+            juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f, 1.0f),
+            100.0f,
+            juce::AudioParameterFloatAttributes().withLabel("%")));
+    }
+
+    // Preset morph: the imaging settings follow a blend of two factory presets or user
+    // slots instead of their own controls (see PresetBank.h)
+    const auto sourceNames = PresetBank::getMorphSourceNames();
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("presetMorph", 2),
+        "Preset Morph",
+        false));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("morphA", 2),
+        "Morph A",
+        sourceNames,
+        0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("morphB", 2),
+        "Morph B",
+        sourceNames,
+        1));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("morph", 2),
+        "Morph",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f, 1.0f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("%")));
+
     return { params.begin(), params.end() };
 }
 
@@ -139,22 +285,167 @@ bool StereoImagerAudioProcessor::acceptsMidi() const { return false; }
 bool StereoImagerAudioProcessor::producesMidi() const { return false; }
 bool StereoImagerAudioProcessor::isMidiEffect() const { return false; }
 double StereoImagerAudioProcessor::getTailLengthSeconds() const { return 0.0; }
-int StereoImagerAudioProcessor::getNumPrograms() { return 1; }
-int StereoImagerAudioProcessor::getCurrentProgram() { return 0; }
-void StereoImagerAudioProcessor::setCurrentProgram(int index) { juce::ignoreUnused(index); }
-const juce::String StereoImagerAudioProcessor::getProgramName(int index) { juce::ignoreUnused(index); return {}; }
+int StereoImagerAudioProcessor::getNumPrograms() { return PresetBank::numPresets; }
+int StereoImagerAudioProcessor::getCurrentProgram() { return juce::jmax(0, currentProgram); }
+const juce::String StereoImagerAudioProcessor::getProgramName(int index) { return PresetBank::getPresetNames()[index]; }
+
+void StereoImagerAudioProcessor::setCurrentProgram(int index)
+{
+    // Some hosts re-select the current program after restoring a session; that mustn't
+    // overwrite the restored settings (the program is saved with them)
+    index = juce::jlimit(0, PresetBank::numPresets - 1, index);
+    if (index == currentProgram)
+        return;
+
+    currentProgram = index;
+    presetBank.recall(currentProgram);
+}
+
 void StereoImagerAudioProcessor::changeProgramName(int index, const juce::String& newName) { juce::ignoreUnused(index, newName); }
 
 void StereoImagerAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     stereoProcessor.prepare(sampleRate, samplesPerBlock);
     multibandProcessor.prepare(sampleRate, samplesPerBlock);
+    spectralWidth.prepare(sampleRate, samplesPerBlock);
+    allocateSpectralIfWanted();
+    presetBank.prepare(sampleRate);
+
+    // Drop any values held from parameter events
+    wasMorphing = false;
+    lastReadValues.fill(std::numeric_limits<float>::quiet_NaN());
+    writtenBackValues.fill(std::numeric_limits<float>::quiet_NaN());
+    parameterEvents.clear();
+    parametersChanged.store(false);
+    readParameters();
+    resolveParameterValues(0);
+    resetMeterFrame();
+
+    // Room for the largest latency at this rate: mono bass resampling, plus the largest FFT
+    bypassDelay.prepare(2, Multirate::LowBandResampler::getLatencyFor(sampleRate) + SpectralWidth::getMaxLatencySamples(),
+                        samplesPerBlock);
+    dryInput.setSize(2, juce::jmax(1, samplesPerBlock));
+    applyControls();
+    samplesSinceControl = controlPeriod;     // The first block reads the parameters again
+
+    // Not on the audio thread yet, so the host can hear about the latency right away
+    setLatencySamples(processingLatency.load(std::memory_order_relaxed));
+
+    // Meter frames of about 10 ms, whatever the host block size
+    meterFrameSamples = juce::jmax(controlPeriod, juce::roundToInt(sampleRate / 100.0));
+
+   #if STEREOIMAGER_PROFILING
+    profiler.prepare(sampleRate, samplesPerBlock);
+   #endif
+
+    // The history keeps up with the meters whether or not the editor is open
+    meterHistory.startConsolidating();
+
+    // Timelines are only captured when chasing xruns in the Standalone app
+    traceRecorder.setEnabled(STEREOIMAGER_TRACING && wrapperType == wrapperType_Standalone);
+}
+
+void StereoImagerAudioProcessor::readParameters()
+{
+    // A parameter takes over from parameter events only once it changes itself. An event's
+    // value coming back from writeBackEventValues() isn't a change: snapped to the
+    // parameter's steps, it could otherwise move the sound.
+    for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+    {
+        const float value = rawParameters[i]->load(std::memory_order_relaxed);
+
+        if (value == lastReadValues[i])
+            continue;
+
+        if (value != writtenBackValues[i])
+            sourceValues[i] = value;
+
+        lastReadValues[i] = value;
+        writtenBackValues[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+}
+
+void StereoImagerAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    // Any thread; the APVTS has stored the new value by now
+    juce::ignoreUnused(parameterID, newValue);
+    parametersChanged.store(true, std::memory_order_release);
+}
+
+void StereoImagerAudioProcessor::resolveParameterValues(int numSamples)
+{
+    // The morph controls are never morphed themselves
+    const bool morphing = sourceValues[(size_t) presetMorphIndex] > 0.5f;
+
+    // Switched off, the morph's last values (still in parameterValues) become the
+    // parameters' own, here at once and on the parameters from the message thread
+    if (wasMorphing && ! morphing)
+    {
+        for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+        {
+            if (parameterValues[i] != sourceValues[i])
+            {
+                sourceValues[i] = parameterValues[i];
+                queueWriteBack(i);
+            }
+        }
+
+        eventValuesPending.store(true, std::memory_order_release);
+    }
+
+    parameterValues = sourceValues;
+    const float position = parameterValue(morphIndex) / 100.0f;
+
+    // Switching the morph on starts it where the control is, without a glide
+    if (morphing && ! wasMorphing)
+        presetBank.resetMorph(position);
+
+    wasMorphing = morphing;
+
+    if (morphing)
+        presetBank.morph(juce::roundToInt(parameterValue(morphAIndex)), juce::roundToInt(parameterValue(morphBIndex)),
+                         position, numSamples, parameterValues.data());
+}
+
+void StereoImagerAudioProcessor::updateLatency()
+{
+    const bool multirate = parameterValue(multirateIndex) > 0.5f;
+    stereoProcessor.setMultirateEnabled(multirate);
+
+    spectralWidth.setEnabled(parameterValue(spectralEnabledIndex) > 0.5f);
+    spectralWidth.setFftOrder(SpectralWidth::minOrder + juce::roundToInt(parameterValue(spectralFftSizeIndex)));
+
+    const int latency = stereoProcessor.getLatencySamples() + spectralWidth.getLatencySamples();
+    bypassDelay.setDelay(latency);
+    processingLatency.store(latency, std::memory_order_relaxed);
+}
+
+void StereoImagerAudioProcessor::timerCallback()
+{
+    allocateSpectralIfWanted();
+    writeBackEventValues();
+
+    // setLatencySamples() calls straight into the host, so a change made on the audio
+    // thread is only reported from here
+    const int latency = processingLatency.load(std::memory_order_relaxed);
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+void StereoImagerAudioProcessor::allocateSpectralIfWanted()
+{
+    // Most sessions never use the spectral curve, so its FFTs are only built once it is
+    // switched on; the audio thread passes the audio through until then
+    if (! spectralWidth.isAllocated() && rawParameters[(size_t) spectralEnabledIndex]->load() > 0.5f)
+        spectralWidth.allocate();
 }
 
 void StereoImagerAudioProcessor::releaseResources()
 {
     stereoProcessor.reset();
     multibandProcessor.reset();
+    spectralWidth.reset();
+    meterHistory.stopConsolidating();
 }
 
 bool StereoImagerAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -171,6 +462,9 @@ void StereoImagerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 {
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    STEREOIMAGER_REALTIME_SCOPE;
+    STEREOIMAGER_PROFILE_BLOCK(profiler);
+    STEREOIMAGER_TRACE_BLOCK(traceRecorder, buffer.getNumSamples());
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -179,61 +473,315 @@ void StereoImagerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Check bypass
-    if (bypassParam->load() > 0.5f)
-        return;
+    // Levels, correlation and band meters always run, since the history records them;
+    // the vectorscope and field display only while the editor is there to show them
+    stereoProcessor.setVisualsEnabled(editorOpen.load(std::memory_order_relaxed));
 
-    // Apply input gain
-    float inputGain = juce::Decibels::decibelsToGain(inputGainParam->load());
-    buffer.applyGain(inputGain);
+    if (parameterEvents.isEmpty())
+    {
+        // A change reaches the gains, widths and modes in the block it arrives in; the rest
+        // of the controls follow on the control period, however the host slices the audio.
+        // The flag is read before it's cleared, since the exchange is a locked instruction
+        // and most calls have nothing to clear.
+        const bool changed = parametersChanged.load(std::memory_order_relaxed)
+                          && parametersChanged.exchange(false, std::memory_order_acquire);
+        if (changed)
+            readParameters();
+
+        if (samplesSinceControl >= controlPeriod)
+        {
+            refreshControls();
+        }
+        else if (changed)
+        {
+            resolveParameterValues(0);      // The morph advances on the control period
+            applyImmediateControls();
+        }
+
+        processSegment(buffer);
+        samplesSinceControl += buffer.getNumSamples();
+    }
+    else
+    {
+        processAutomatedBlock(buffer);
+    }
+
+    // A block that ends bypassed leaves the meters where they were
+    if (parameterValue(bypassIndex) > 0.5f)
+        return;
 
-    // Measure input levels
+    // Measure levels, published once a meter frame is full
     if (totalNumInputChannels >= 2)
     {
-        inputLevelL.store(buffer.getMagnitude(0, 0, buffer.getNumSamples()));
-        inputLevelR.store(buffer.getMagnitude(1, 0, buffer.getNumSamples()));
+        STEREOIMAGER_PROFILE_STAGE(profiler, Metering);
+        STEREOIMAGER_TRACE_STAGE(traceRecorder, Metering);
+        meterOutputL = juce::jmax(meterOutputL, buffer.getMagnitude(0, 0, buffer.getNumSamples()));
+        meterOutputR = juce::jmax(meterOutputR, buffer.getMagnitude(1, 0, buffer.getNumSamples()));
+        meterFrameFilled += buffer.getNumSamples();
+
+        if (meterFrameFilled >= meterFrameSamples)
+        {
+            inputLevelL.store(meterInputL);
+            inputLevelR.store(meterInputR);
+            outputLevelL.store(meterOutputL);
+            outputLevelR.store(meterOutputR);
+
+            MeterHistory::Frame frame;
+            frame.correlation = stereoProcessor.getCorrelation();
+            frame.midLevel = stereoProcessor.getMidLevel();
+            frame.sideLevel = stereoProcessor.getSideLevel();
+            frame.lowLevel = multibandProcessor.getLowLevel();
+            frame.midBandLevel = multibandProcessor.getMidLevel();
+            frame.highLevel = multibandProcessor.getHighLevel();
+            frame.seconds = static_cast<float>(meterFrameFilled / getSampleRate());
+            meterHistory.push(frame);
+
+            resetMeterFrame();
+        }
+    }
+}
+
+void StereoImagerAudioProcessor::resetMeterFrame()
+{
+    meterInputL = meterInputR = meterOutputL = meterOutputR = 0.0f;
+    meterFrameFilled = 0;
+}
+
+void StereoImagerAudioProcessor::processAutomatedBlock(juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    int next = 0;
+
+    if (parametersChanged.exchange(false, std::memory_order_acquire))
+        readParameters();
+
+    // Each stretch between change offsets runs with constant targets, like a whole block
+    for (int start = 0; start < numSamples;)
+    {
+        for (; next < parameterEvents.size() && parameterEvents[next].sampleOffset <= start; ++next)
+            applyParameterEvent(parameterEvents[next]);
+
+        const int end = next < parameterEvents.size() ? juce::jmin(numSamples, parameterEvents[next].sampleOffset) : numSamples;
+
+        // A view of the stretch; no allocation for stereo
+        juce::AudioBuffer<float> segment(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, end - start);
+        refreshControls();
+        processSegment(segment);
+        samplesSinceControl += end - start;
+        start = end;
     }
 
-    // Update stereo processor parameters
-    stereoProcessor.setWidth(widthParam->load());
-    stereoProcessor.setPan(panParam->load() / 100.0f);  // Convert from -100/+100 to -1/+1
-    stereoProcessor.setBalance(balanceParam->load() / 100.0f);
-    stereoProcessor.setMonoBassFreq(monoBassFreqParam->load());
-    stereoProcessor.setMonoBassEnabled(monoBassEnabledParam->load() > 0.5f);
-
-    // Update multiband processor parameters
-    bool multibandEnabled = multibandEnabledParam->load() > 0.5f;
-    multibandProcessor.setEnabled(multibandEnabled);
-    multibandProcessor.setLowMidCrossover(lowMidXoverParam->load());
-    multibandProcessor.setMidHighCrossover(midHighXoverParam->load());
-    multibandProcessor.setLowWidth(lowWidthParam->load());
-    multibandProcessor.setMidWidth(midWidthParam->load());
-    multibandProcessor.setHighWidth(highWidthParam->load());
+    // Changes past the end of the block hold from the next one
+    for (; next < parameterEvents.size(); ++next)
+        applyParameterEvent(parameterEvents[next]);
+
+    // The parameters catch up from the message thread (setValueNotifyingHost calls into the
+    // host and the listeners, so not from here), holding what the atomic will read then
+    for (int i = 0; i < parameterEvents.size(); ++i)
+    {
+        const int index = parameterEvents[i].parameterIndex;
+        if (! juce::isPositiveAndBelow(index, numParameters))
+            continue;
+
+        queueWriteBack(static_cast<size_t>(index));
+    }
+
+    eventValuesPending.store(true, std::memory_order_release);
+    parameterEvents.clear();
+}
+
+void StereoImagerAudioProcessor::queueWriteBack(size_t index)
+{
+    auto* parameter = static_cast<juce::RangedAudioParameter*>(getParameters()[static_cast<int>(index)]);
+    writtenBackValues[index] = parameter->convertFrom0to1(parameter->convertTo0to1(sourceValues[index]));
+    eventValues[index].store(sourceValues[index], std::memory_order_relaxed);
+    eventValuePending[index].store(true, std::memory_order_relaxed);
+}
+
+void StereoImagerAudioProcessor::applyParameterEvent(const ParameterEvents::Event& event)
+{
+    if (juce::isPositiveAndBelow(event.parameterIndex, numParameters))
+        sourceValues[static_cast<size_t>(event.parameterIndex)] = event.value;
+}
+
+void StereoImagerAudioProcessor::writeBackEventValues()
+{
+    if (! eventValuesPending.exchange(false, std::memory_order_acquire))
+        return;
+
+    // A block with newer events sets the flags again, so the latest value always lands
+    const auto& parameters = getParameters();
+
+    for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+    {
+        if (! eventValuePending[i].exchange(false, std::memory_order_relaxed))
+            continue;
+
+        auto* parameter = static_cast<juce::RangedAudioParameter*>(parameters[static_cast<int>(i)]);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(eventValues[i].load(std::memory_order_relaxed)));
+    }
+}
+
+void StereoImagerAudioProcessor::applyControls()
+{
+    updateLatency();
+
+    // Crossover engine for both processors
+    auto crossoverEngine = static_cast<LR4Crossover::Engine>(juce::roundToInt(parameterValue(crossoverEngineIndex)));
+    stereoProcessor.setCrossoverEngine(crossoverEngine);
+    multibandProcessor.setCrossoverEngine(crossoverEngine);
+
+    // The spectral curve takes over from the bands (enabled in updateLatency())
+    for (int node = 0; node < SpectralWidth::numNodes; ++node)
+        spectralWidth.setNode(node, parameterValue(spectralNodeFreqIndices[(size_t) node]), parameterValue(spectralNodeWidthIndices[(size_t) node]));
+
+    stereoProcessor.setDecorrelationEnabled(parameterValue(decorrelationIndex) > 0.5f);
+    stereoProcessor.setDecorrelationTarget(parameterValue(targetCorrelationIndex));
+
+    multibandProcessor.setLowMidCrossover(parameterValue(lowMidXoverIndex));
+    multibandProcessor.setMidHighCrossover(parameterValue(midHighXoverIndex));
+
+    applyImmediateControls();
+    appliedValues = parameterValues;
+}
+
+void StereoImagerAudioProcessor::applyImmediateControls()
+{
+    inputGain = juce::Decibels::decibelsToGain(parameterValue(inputGainIndex));
+    outputGain = juce::Decibels::decibelsToGain(parameterValue(outputGainIndex));
+
+    const bool spectralEnabled = spectralWidth.isEnabled();
+    multibandActive = parameterValue(multibandEnabledIndex) > 0.5f && ! spectralEnabled;
+    multibandProcessor.setEnabled(multibandActive);
+
+    // Update stereo processor parameters. With the bands or the curve doing the width,
+    // the main width's M/S stage stays neutral (pan and balance still apply).
+    stereoProcessor.setWidth(multibandActive || spectralEnabled ? 100.0f : parameterValue(widthIndex));
+    stereoProcessor.setPan(parameterValue(panIndex) / 100.0f);  // Convert from -100/+100 to -1/+1
+    stereoProcessor.setBalance(parameterValue(balanceIndex) / 100.0f);
+
+    // With multiband on, mono bass is one more band in its crossover tree rather than
+    // a second set of filters in the stereo processor (so it comes after pan and balance)
+    const bool monoBassEnabled = parameterValue(monoBassEnabledIndex) > 0.5f;
+    stereoProcessor.setMonoBassFreq(parameterValue(monoBassFreqIndex));
+    stereoProcessor.setMonoBassEnabled(monoBassEnabled && ! multibandActive);
+    multibandProcessor.setMonoBass(monoBassEnabled && multibandActive, parameterValue(monoBassFreqIndex));
+
+    multibandProcessor.setLowWidth(parameterValue(lowWidthIndex));
+    multibandProcessor.setMidWidth(parameterValue(midWidthIndex));
+    multibandProcessor.setHighWidth(parameterValue(highWidthIndex));
+}
+
+void StereoImagerAudioProcessor::refreshControls()
+{
+    resolveParameterValues(samplesSinceControl);
+    samplesSinceControl = 0;
+
+    // Nothing has moved since the controls were last applied (the usual case between
+    // changes, with no morph gliding), so the DSP already has all of it
+    if (parameterValues == appliedValues)
+        return;
+
+    applyControls();
+}
+
+void StereoImagerAudioProcessor::processSegment(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = juce::jmin(2, buffer.getNumChannels());
+    const bool bypassed = parameterValue(bypassIndex) > 0.5f;
+
+    // With no latency to match and bypass off, the dry input has nowhere to go
+    if (! bypassed && bypassDelay.getDelay() == 0)
+    {
+        processChain(buffer);
+        return;
+    }
+
+    // In pieces the dry copy has room for (hosts may send more than they said they would)
+    for (int start = 0; start < buffer.getNumSamples();)
+    {
+        const int length = juce::jmin(buffer.getNumSamples() - start, dryInput.getNumSamples());
+        juce::AudioBuffer<float> piece(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, length);
+
+        // The dry input is delayed like the processed signal, so toggling bypass doesn't
+        // shift timing, and the delay always holds the input that came just before
+        for (int ch = 0; ch < numChannels; ++ch)
+            dryInput.copyFrom(ch, 0, piece, ch, 0, length);
+
+        bypassDelay.process(dryInput.getArrayOfWritePointers(), numChannels, length);
+        processChain(piece);
+
+        if (bypassed)
+            for (int ch = 0; ch < numChannels; ++ch)
+                piece.copyFrom(ch, 0, dryInput, ch, 0, length);
+
+        start += length;
+    }
+}
+
+void StereoImagerAudioProcessor::processChain(juce::AudioBuffer<float>& buffer)
+{
+    // Apply input gain
+    {
+        STEREOIMAGER_PROFILE_STAGE(profiler, Gain);
+        STEREOIMAGER_TRACE_STAGE(traceRecorder, Gain);
+        buffer.applyGain(inputGain);
+    }
+
+    // Measure input levels (peak over the meter frame)
+    if (getTotalNumInputChannels() >= 2)
+    {
+        STEREOIMAGER_PROFILE_STAGE(profiler, Metering);
+        STEREOIMAGER_TRACE_STAGE(traceRecorder, Metering);
+        meterInputL = juce::jmax(meterInputL, buffer.getMagnitude(0, 0, buffer.getNumSamples()));
+        meterInputR = juce::jmax(meterInputR, buffer.getMagnitude(1, 0, buffer.getNumSamples()));
+    }
 
     // Process through DSP chain
-    if (multibandEnabled)
+    if (multibandActive)
     {
-        // Multiband mode - disable main width control's M/S processing
-        // (just use mono bass and pan/balance from stereo processor)
-        stereoProcessor.setWidth(100.0f); // Neutral
-        stereoProcessor.process(buffer);
-        multibandProcessor.process(buffer);
+        // Multiband mode - pan/balance from the stereo processor, width and mono bass in the bands
+        {
+            STEREOIMAGER_PROFILE_STAGE(profiler, Stereo);
+            STEREOIMAGER_TRACE_STAGE(traceRecorder, Stereo);
+            stereoProcessor.process(buffer);
+        }
+        {
+            STEREOIMAGER_PROFILE_STAGE(profiler, Multiband);
+            STEREOIMAGER_TRACE_STAGE(traceRecorder, Multiband);
+            multibandProcessor.process(buffer);
+        }
+    }
+    else if (spectralWidth.isEnabled())
+    {
+        // Spectral mode - the curve replaces the main width; mono bass stays in the
+        // stereo processor, where the curve can't undo it (zero side stays zero)
+        {
+            STEREOIMAGER_PROFILE_STAGE(profiler, Stereo);
+            STEREOIMAGER_TRACE_STAGE(traceRecorder, Stereo);
+            stereoProcessor.process(buffer);
+        }
+        {
+            STEREOIMAGER_PROFILE_STAGE(profiler, Spectral);
+            STEREOIMAGER_TRACE_STAGE(traceRecorder, Spectral);
+            spectralWidth.process(buffer);
+        }
     }
     else
     {
         // Single-band mode
-        stereoProcessor.process(buffer);
+        {
+            STEREOIMAGER_PROFILE_STAGE(profiler, Stereo);
+            STEREOIMAGER_TRACE_STAGE(traceRecorder, Stereo);
+            stereoProcessor.process(buffer);
+        }
     }
 
     // Apply output gain
-    float outputGain = juce::Decibels::decibelsToGain(outputGainParam->load());
-    buffer.applyGain(outputGain);
-
-    // Measure output levels
-    if (totalNumInputChannels >= 2)
     {
-        outputLevelL.store(buffer.getMagnitude(0, 0, buffer.getNumSamples()));
-        outputLevelR.store(buffer.getMagnitude(1, 0, buffer.getNumSamples()));
+        STEREOIMAGER_PROFILE_STAGE(profiler, Gain);
+        STEREOIMAGER_TRACE_STAGE(traceRecorder, Gain);
+        buffer.applyGain(outputGain);
     }
 }
 
@@ -241,21 +789,69 @@ bool StereoImagerAudioProcessor::hasEditor() const { return true; }
 
 juce::AudioProcessorEditor* StereoImagerAudioProcessor::createEditor()
 {
+    editorOpen.store(true);
     return new StereoImagerAudioProcessorEditor(*this);
 }
 
+void StereoImagerAudioProcessor::editorBeingDeleted(juce::AudioProcessorEditor* editor) noexcept
+{
+    editorOpen.store(false);
+    AudioProcessor::editorBeingDeleted(editor);
+}
+
 void StereoImagerAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Saved where the last parameter events left the parameters, even if the timer hasn't
+    // written them back yet; the parameters themselves are left to the timer, since the
+    // host may save from any thread
+    std::vector<CompactState::Record> eventRecords;
+
+    if (eventValuesPending.load(std::memory_order_acquire))
+    {
+        const auto& parameters = getParameters();
+
+        for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+        {
+            if (! eventValuePending[i].load(std::memory_order_relaxed))
+                continue;
+
+            // As the parameter will hold it, snapped to its steps
+            auto* parameter = static_cast<juce::RangedAudioParameter*>(parameters[static_cast<int>(i)]);
+            const float value = parameter->convertFrom0to1(parameter->convertTo0to1(eventValues[i].load(std::memory_order_relaxed)));
+            eventRecords.push_back({ CompactState::hashParameterID(parameter->getParameterID()), value });
+        }
+    }
+
+    std::vector<CompactState::Record> extraRecords { { CompactState::hashParameterID(programStateID), static_cast<float>(currentProgram) } };
+    presetBank.getUserSlotRecords(extraRecords);
+    compactState.write(destData, extraRecords, eventRecords);
 }
 
 void StereoImagerAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    if (CompactState::isCompactState(data, sizeInBytes))
+    {
+        std::vector<CompactState::Record> extraRecords;
+        if (! compactState.read(data, sizeInBytes, &extraRecords))
+            return;
+
+        currentProgram = -1;
+        for (const auto& record : extraRecords)
+            if (record.hash == CompactState::hashParameterID(programStateID))
+                currentProgram = juce::jlimit(-1, PresetBank::numPresets - 1, juce::roundToInt(record.value));
+
+        presetBank.setUserSlotRecords(extraRecords);
+        return;
+    }
+
+    // Sessions saved before the compact format, which had no programs or user slots
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    {
         apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        currentProgram = -1;
+        presetBank.setUserSlotRecords({});
+    }
 }
 
 // This creates new instances of the plugin
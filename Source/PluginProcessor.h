@@ -1,10 +1,19 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "CompactState.h"
+#include "PresetBank.h"
+#include "ParameterEvents.h"
 #include "DSP/StereoProcessor.h"
+#include "DSP/MeterHistory.h"
 #include "DSP/MultibandProcessor.h"
+#include "DSP/SpectralWidth.h"
+#include "DSP/StageProfiler.h"
+#include "DSP/TraceRecorder.h"
 
-class StereoImagerAudioProcessor : public juce::AudioProcessor
+class StereoImagerAudioProcessor : public juce::AudioProcessor,
+                                   private juce::AudioProcessorValueTreeState::Listener,
+                                   private juce::Timer
 {
 public:
     StereoImagerAudioProcessor();
@@ -19,6 +28,7 @@ public:
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
+    void editorBeingDeleted(juce::AudioProcessorEditor* editor) noexcept override;
 
     const juce::String getName() const override;
     bool acceptsMidi() const override;
@@ -32,6 +42,8 @@ public:
     const juce::String getProgramName(int index) override;
     void changeProgramName(int index, const juce::String& newName) override;
 
+    // Saves the compact binary state (see CompactState.h), with the current program and the
+    // user morph slots; loads that or an older XML session
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
@@ -58,37 +70,161 @@ public:
         stereoProcessor.getStereoSamples(samples);
     }
 
+    // Energy by stereo direction, for the polar field display
+    void getStereoField(StereoProcessor::StereoField& field) const
+    {
+        stereoProcessor.getStereoField(field);
+    }
+
+    // Factory presets and the user morph slots
+    PresetBank& getPresetBank() { return presetBank; }
+
+    // Scrolling meter history (recorded from prepareToPlay on, editor open or not)
+    MeterHistory& getMeterHistory() { return meterHistory; }
+
+    // Sample-accurate parameter changes from the renderer and tests, for the next processBlock
+    // (see ParameterEvents.h). Host automation doesn't come through here.
+    ParameterEvents& getParameterEvents() { return parameterEvents; }
+
+    // Audio-thread timeline (records in the Standalone build)
+    TraceRecorder& getTraceRecorder() { return traceRecorder; }
+
+   #if STEREOIMAGER_PROFILING
+    // Audio-thread stage timings (debug/profiling builds only)
+    StageProfiler& getProfiler() { return profiler; }
+   #endif
+
 private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    CompactState compactState;
 
     // DSP Modules
     StereoProcessor stereoProcessor;
     MultibandProcessor multibandProcessor;
-
-    // Parameter pointers (cached for fast access)
-    std::atomic<float>* widthParam = nullptr;
-    std::atomic<float>* panParam = nullptr;
-    std::atomic<float>* balanceParam = nullptr;
-    std::atomic<float>* monoBassFreqParam = nullptr;
-    std::atomic<float>* monoBassEnabledParam = nullptr;
-    std::atomic<float>* inputGainParam = nullptr;
-    std::atomic<float>* outputGainParam = nullptr;
-    std::atomic<float>* bypassParam = nullptr;
+    SpectralWidth spectralWidth;
+
+    // Every parameter's value for the segment, in parameter units and getParameters() order:
+    // the parameters' atomics or the latest parameter event, then overridden by the preset
+    // morph while it's on (advanced by the samples since the last resolve). The DSP is set
+    // up from these, never from the parameters directly. The atomics are only read again
+    // once a parameter has changed (parametersChanged, set by the APVTS listener).
+    void readParameters();
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void resolveParameterValues(int numSamples);
+    float parameterValue(int index) const { return parameterValues[static_cast<size_t>(index)]; }
+
+    std::array<std::atomic<float>*, PresetBank::maxParameters> rawParameters {};
+    std::array<float, PresetBank::maxParameters> lastReadValues {};     // Atomics as last read
+    std::array<float, PresetBank::maxParameters> writtenBackValues {};  // Event values on their way back
+    std::array<float, PresetBank::maxParameters> sourceValues {};       // Before the morph
+    std::array<float, PresetBank::maxParameters> parameterValues {};
+    std::atomic<bool> parametersChanged { true };
+    int numParameters = 0;
+
+    // Blocks with parameter events run as segments split at each change offset, each with
+    // constant parameter targets, exactly as a whole block runs
+    void processSegment(juce::AudioBuffer<float>& buffer);
+    void processChain(juce::AudioBuffer<float>& buffer);
+    void processAutomatedBlock(juce::AudioBuffer<float>& buffer);
+    void applyParameterEvent(const ParameterEvents::Event& event);
+
+    ParameterEvents parameterEvents;
+
+    // The last event value of each parameter an event has moved (or the morph, once it's
+    // switched off), left by the audio thread for writeBackEventValues() to set the
+    // parameter to (message thread)
+    void queueWriteBack(size_t index);
+    void writeBackEventValues();
+    std::array<std::atomic<float>, PresetBank::maxParameters> eventValues {};
+    std::array<std::atomic<bool>, PresetBank::maxParameters> eventValuePending {};
+    std::atomic<bool> eventValuesPending { false };
+
+    // The costly per-block work (the latency-changing settings, crossover engine and
+    // frequencies, the spectral curve's nodes, the morph's glide) runs once per control
+    // period rather than once per call, so hosts that send a few samples at a time, or a
+    // different count every call, don't repeat it for every call. Blocks of a period or more
+    // refresh every call, as before; parameter events still refresh on their exact sample.
+    // A parameter change reaches the cheap controls (gains, widths, pan, balance, mode and
+    // mono bass) in the block it arrives in (applyImmediateControls).
+    static constexpr int controlPeriod = 64;
+    void applyControls();
+    void applyImmediateControls();
+    void refreshControls();
+    std::array<float, PresetBank::maxParameters> appliedValues {};     // parameterValues as applyControls() last saw them
+    int samplesSinceControl = 0;
+    float inputGain = 1.0f, outputGain = 1.0f;
+    bool multibandActive = false;
+
+    // Preset programs and the A/B morph. No program is current until one is chosen, so the
+    // first choice always recalls it. The morph only moves the sound; switched off, it
+    // holds where it left off and hands those values to the parameters, once.
+    PresetBank presetBank;
+    int currentProgram = -1;
+    static constexpr const char* programStateID = "program";     // Its state record's name
+    bool wasMorphing = false;
+    int presetMorphIndex = 0, morphAIndex = 0, morphBIndex = 0, morphIndex = 0;
+
+    // Parameter indices (looked up once)
+    int widthIndex = 0;
+    int panIndex = 0;
+    int balanceIndex = 0;
+    int monoBassFreqIndex = 0;
+    int monoBassEnabledIndex = 0;
+    int inputGainIndex = 0;
+    int outputGainIndex = 0;
+    int bypassIndex = 0;
+    int decorrelationIndex = 0;
+    int targetCorrelationIndex = 0;
 
     // Multiband parameters
-    std::atomic<float>* multibandEnabledParam = nullptr;
-    std::atomic<float>* lowMidXoverParam = nullptr;
-    std::atomic<float>* midHighXoverParam = nullptr;
-    std::atomic<float>* lowWidthParam = nullptr;
-    std::atomic<float>* midWidthParam = nullptr;
-    std::atomic<float>* highWidthParam = nullptr;
-
-    // Metering state
+    int multibandEnabledIndex = 0;
+    int lowMidXoverIndex = 0;
+    int midHighXoverIndex = 0;
+    int lowWidthIndex = 0;
+    int midWidthIndex = 0;
+    int highWidthIndex = 0;
+    int crossoverEngineIndex = 0;
+    int multirateIndex = 0;
+
+    // Spectral width curve parameters
+    int spectralEnabledIndex = 0;
+    int spectralFftSizeIndex = 0;
+    std::array<int, SpectralWidth::numNodes> spectralNodeFreqIndices {};
+    std::array<int, SpectralWidth::numNodes> spectralNodeWidthIndices {};
+    void allocateSpectralIfWanted();   // Not on the audio thread
+
+    // Multirate mono bass and the spectral curve delay the output; bypass is delayed to
+    // match. The audio thread switches them and publishes the latency they add up to;
+    // the host is told in prepareToPlay, or later by the timer on the message thread.
+    // The dry input goes through the bypass delay and the chain keeps running whether or
+    // not bypass is on, so neither side starts from stale audio when it's toggled.
+    void updateLatency();
+    void timerCallback() override;
+    std::atomic<int> processingLatency { 0 };
+    Multirate::DelayLine bypassDelay;
+    juce::AudioBuffer<float> dryInput;
+
+    // Metering state. Input and output levels are peaks over a meter frame of about 10 ms,
+    // gathered across calls, so small blocks don't make them jitter or flood the history.
+    // They are measured and recorded into the history whether or not the editor is open,
+    // so a host or a reopened editor never sees them frozen or missing.
+    std::atomic<bool> editorOpen { false };
+    void resetMeterFrame();
+    float meterInputL = 0.0f, meterInputR = 0.0f, meterOutputL = 0.0f, meterOutputR = 0.0f;
+    int meterFrameFilled = 0;
+    int meterFrameSamples = 480;
     std::atomic<float> inputLevelL { 0.0f };
     std::atomic<float> inputLevelR { 0.0f };
     std::atomic<float> outputLevelL { 0.0f };
     std::atomic<float> outputLevelR { 0.0f };
+    MeterHistory meterHistory;
+
+   #if STEREOIMAGER_PROFILING
+    StageProfiler profiler;
+   #endif
+
+    TraceRecorder traceRecorder;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StereoImagerAudioProcessor)
 };
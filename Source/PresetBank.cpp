@@ -0,0 +1,193 @@
+#include "PresetBank.h"
+
+namespace
+{
+    struct PresetValue
+    {
+        const char* parameterID;
+        float value;                // Parameter units
+    };
+
+    // Changes from the defaults; the rest of each preset is the default
+    struct FactoryPreset
+    {
+        const char* name;
+        PresetValue values[8];
+    };
+
+    const FactoryPreset factoryPresets[PresetBank::numPresets] = {
+        { "Init", {} },
+        { "Wide Mix", { { "width", 150.0f }, { "monoBassFreq", 120.0f } } },
+        { "Narrow Verse", { { "width", 70.0f } } },
+        { "Tight Low End", { { "width", 110.0f }, { "monoBassFreq", 180.0f } } },
+        { "Big Chorus", { { "multibandEnabled", 1.0f }, { "lowMidXover", 200.0f }, { "midHighXover", 5000.0f },
+                          { "lowWidth", 0.0f }, { "midWidth", 140.0f }, { "highWidth", 170.0f } } },
+        { "Air", { { "multibandEnabled", 1.0f }, { "midHighXover", 6000.0f },
+                   { "lowWidth", 80.0f }, { "midWidth", 110.0f }, { "highWidth", 180.0f } } },
+        { "Diffuse", { { "decorrelation", 1.0f }, { "targetCorrelation", 0.4f }, { "width", 120.0f } } },
+        { "Mono Check", { { "width", 0.0f } } }
+    };
+
+    // Left as they are by recall and morph (see PresetBank.h)
+    const char* const userParameterIDs[] = {
+        "inputGain", "outputGain", "bypass", "crossoverEngine", "multirate", "spectralWidth",
+        "spectralFftSize", "presetMorph", "morphA", "morphB", "morph"
+    };
+
+    bool isUserParameter(const juce::String& parameterID)
+    {
+        for (auto* id : userParameterIDs)
+            if (parameterID == id)
+                return true;
+
+        return false;
+    }
+
+    // User slot names, and the prefixes of their state record names ("userA.width")
+    const char* const userSlotNames[PresetBank::numUserSlots] = { "User A", "User B" };
+    const char* const userSlotPrefixes[PresetBank::numUserSlots] = { "userA.", "userB." };
+}
+
+juce::StringArray PresetBank::getPresetNames()
+{
+    juce::StringArray names;
+
+    for (const auto& preset : factoryPresets)
+        names.add(preset.name);
+
+    return names;
+}
+
+juce::StringArray PresetBank::getMorphSourceNames()
+{
+    auto names = getPresetNames();
+
+    for (auto* name : userSlotNames)
+        names.add(name);
+
+    return names;
+}
+
+PresetBank::PresetBank(const juce::Array<juce::AudioProcessorParameter*>& processorParameters)
+{
+    jassert(processorParameters.size() <= maxParameters);
+    numParameters = juce::jmin(maxParameters, processorParameters.size());
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(processorParameters[i]);
+        jassert(parameter != nullptr);
+
+        const auto index = static_cast<size_t>(i);
+        parameters[index] = parameter;
+        presetControlled[index] = parameter != nullptr && ! isUserParameter(parameter->getParameterID());
+        discrete[index] = parameter != nullptr && parameter->isDiscrete();
+
+        for (size_t preset = 0; preset < snapshots.size(); ++preset)
+        {
+            auto& value = snapshots[preset][index];
+            value = parameter != nullptr ? parameter->getDefaultValue() : 0.0f;
+
+            for (const auto& change : factoryPresets[preset].values)
+                if (change.parameterID != nullptr && parameter != nullptr && parameter->getParameterID() == change.parameterID)
+                    value = parameter->convertTo0to1(change.value);
+        }
+
+        for (size_t slot = 0; slot < userSlots.size(); ++slot)
+        {
+            userSlots[slot][index].store(snapshots[0][index], std::memory_order_relaxed);
+
+            if (parameter != nullptr)
+                userSlotHashes[slot][index] = CompactState::hashParameterID(userSlotPrefixes[slot] + parameter->getParameterID());
+        }
+    }
+}
+
+void PresetBank::recall(int preset) const
+{
+    const auto& snapshot = snapshots[static_cast<size_t>(juce::jlimit(0, numPresets - 1, preset))];
+
+    for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+        if (presetControlled[i])
+            parameters[i]->setValueNotifyingHost(snapshot[i]);
+}
+
+void PresetBank::storeUserSlot(int slot)
+{
+    auto& userSlot = userSlots[static_cast<size_t>(juce::jlimit(0, numUserSlots - 1, slot))];
+
+    for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+        if (presetControlled[i])
+            userSlot[i].store(parameters[i]->getValue(), std::memory_order_relaxed);
+}
+
+void PresetBank::getUserSlotRecords(std::vector<CompactState::Record>& records) const
+{
+    // In parameter units, like the parameters' own records
+    for (size_t slot = 0; slot < userSlots.size(); ++slot)
+        for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+            if (presetControlled[i])
+                records.push_back({ userSlotHashes[slot][i],
+                                    parameters[i]->convertFrom0to1(userSlots[slot][i].load(std::memory_order_relaxed)) });
+}
+
+void PresetBank::setUserSlotRecords(const std::vector<CompactState::Record>& records)
+{
+    for (size_t slot = 0; slot < userSlots.size(); ++slot)
+    {
+        for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+        {
+            if (! presetControlled[i])
+                continue;
+
+            float value = snapshots[0][i];
+
+            for (const auto& record : records)
+                if (record.hash == userSlotHashes[slot][i])
+                    value = parameters[i]->convertTo0to1(record.value);
+
+            userSlots[slot][i].store(value, std::memory_order_relaxed);
+        }
+    }
+}
+
+void PresetBank::prepare(double sampleRate)
+{
+    morphPosition.reset(sampleRate, 50.0f);
+}
+
+void PresetBank::resetMorph(float position)
+{
+    morphPosition.setCurrentAndTargetValue(juce::jlimit(0.0f, 1.0f, position));
+}
+
+float PresetBank::getSourceValue(int source, size_t index) const
+{
+    source = juce::jlimit(0, numPresets + numUserSlots - 1, source);
+
+    if (source < numPresets)
+        return snapshots[static_cast<size_t>(source)][index];
+
+    return userSlots[static_cast<size_t>(source - numPresets)][index].load(std::memory_order_relaxed);
+}
+
+void PresetBank::morph(int sourceA, int sourceB, float position, int numSamples, float* values)
+{
+    morphPosition.setTargetValue(juce::jlimit(0.0f, 1.0f, position));
+
+    for (int i = 0; i < numSamples && morphPosition.isSmoothing(); ++i)
+        morphPosition.getNextValue();
+
+    const float t = morphPosition.getCurrentValue();
+
+    for (size_t i = 0; i < static_cast<size_t>(numParameters); ++i)
+    {
+        if (! presetControlled[i])
+            continue;
+
+        const float a = getSourceValue(sourceA, i);
+        const float b = getSourceValue(sourceB, i);
+        const float normalised = discrete[i] ? (t < 0.5f ? a : b) : a + (b - a) * t;
+        values[i] = parameters[i]->convertFrom0to1(normalised);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "CompactState.h"
+#include "DSP/DSPUtils.h"
+
+// Factory imaging presets, held as snapshots of every parameter, two user slots the
+// editor stores the current settings in, and the A/B morph between any two of them.
+//
+// Factory snapshots are built once from the parameters and never change. User slots are
+// atomics, written on the message thread and read by the morph without locks (a store
+// landing mid-block shows in full from the next one). Snapshots are stored normalised
+// (0-1): interpolating there follows each range's skew, so crossover frequencies morph
+// roughly logarithmically. Switches and choices change over halfway through.
+//
+// Gains, bypass, the crossover engine, and the settings that change latency (multirate,
+// spectral width and its FFT size) are the user's own, not a preset's: recall, morph and
+// the user slots leave them alone, as they do the morph controls themselves.
+class PresetBank
+{
+public:
+    static constexpr int maxParameters = 64;
+    static constexpr int numPresets = 8;
+    static constexpr int numUserSlots = 2;
+
+    // Preset names in bank order, for the program list
+    static juce::StringArray getPresetNames();
+
+    // The presets then the user slots, for the morph A/B choices (user slot n is
+    // numPresets + n)
+    static juce::StringArray getMorphSourceNames();
+
+    // The processor's parameters, in getParameters() order (at most maxParameters)
+    explicit PresetBank(const juce::Array<juce::AudioProcessorParameter*>& parameters);
+
+    // Message thread: sets the parameters to a preset, like a host program change
+    void recall(int preset) const;
+
+    // Message thread: takes the current settings into a user slot (0 is A, 1 is B). The
+    // slots start out as Init.
+    void storeUserSlot(int slot);
+
+    // Message thread: the user slots as extra state records (see CompactState.h), and back.
+    // Values a state doesn't hold go back to Init, like parameters it doesn't mention.
+    void getUserSlotRecords(std::vector<CompactState::Record>& records) const;
+    void setUserSlotRecords(const std::vector<CompactState::Record>& records);
+
+    // Audio thread. The morph position glides (SmoothedValue), so steps in the control
+    // don't step the sound; resetMorph jumps it, for when the morph is switched on.
+    void prepare(double sampleRate);
+    void resetMorph(float position);
+
+    // Overwrites the preset-controlled entries of values (parameter units, getParameters()
+    // order) with sourceA morphed position (0-1) of the way to sourceB. The parameters
+    // themselves are left alone. No allocation or locking; the position advances by numSamples.
+    void morph(int sourceA, int sourceB, float position, int numSamples, float* values);
+
+private:
+    using Snapshot = std::array<float, maxParameters>;
+    using UserSlot = std::array<std::atomic<float>, maxParameters>;
+
+    // Normalised value of parameter index in a morph source
+    float getSourceValue(int source, size_t index) const;
+
+    std::array<Snapshot, numPresets> snapshots {};
+    std::array<UserSlot, numUserSlots> userSlots;
+    std::array<std::array<juce::uint32, maxParameters>, numUserSlots> userSlotHashes {};
+    std::array<juce::RangedAudioParameter*, maxParameters> parameters {};
+    std::array<bool, maxParameters> presetControlled {};
+    std::array<bool, maxParameters> discrete {};
+    int numParameters = 0;
+
+    DSPUtils::SmoothedValue morphPosition;
+
+    JUCE_DECLARE_NON_COPYABLE(PresetBank)
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LookAndFeel.h"
+#include "../DSP/MeterHistory.h"
+
+// Scrolling timelines of correlation, side/mid ratio and band levels (see MeterHistory.h).
+// Each lane shows the min-max range per column with the mean on top. The mouse wheel
+// zooms from seconds to days; a double-click goes back to the last minute.
+class HistoryView : public juce::Component
+{
+public:
+    explicit HistoryView(MeterHistory& h) : history(h) {}
+
+    void update()
+    {
+        const int numColumns = juce::jmax(1, getPlotBounds().getWidth());
+
+        for (auto& series : columns)
+            series.resize(static_cast<size_t>(numColumns));
+
+        for (int s = 0; s < MeterHistory::NumSeries; ++s)
+            history.read(static_cast<MeterHistory::Series>(s), spanSeconds, numColumns, columns[static_cast<size_t>(s)].data());
+
+        repaint();
+    }
+
+    void mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel) override
+    {
+        const double factor = std::pow(1.25, -wheel.deltaY * 4.0);
+        spanSeconds = juce::jlimit(minSpanSeconds, MeterHistory::getMaxSpanSeconds(), spanSeconds * factor);
+        update();
+    }
+
+    void mouseDoubleClick(const juce::MouseEvent&) override
+    {
+        spanSeconds = defaultSpanSeconds;
+        update();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat().reduced(1.0f);
+
+        g.setColour(juce::Colour(0xff151515));
+        g.fillRoundedRectangle(bounds, 3.0f);
+
+        auto plot = getPlotBounds();
+        const int laneGap = 4;
+        const int laneHeight = (plot.getHeight() - 2 * laneGap) / 3;
+
+        auto correlationLane = plot.removeFromTop(laneHeight);
+        plot.removeFromTop(laneGap);
+        auto sideToMidLane = plot.removeFromTop(laneHeight);
+        plot.removeFromTop(laneGap);
+        auto bandLane = plot.removeFromTop(laneHeight);
+
+        drawLane(g, correlationLane, "CORR", -1.0f, 1.0f, 0.0f);
+        drawRange(g, correlationLane, MeterHistory::Correlation, -1.0f, 1.0f, Colors::correlationGood);
+
+        drawLane(g, sideToMidLane, "S/M dB", -40.0f, 10.0f, 0.0f);
+        drawRange(g, sideToMidLane, MeterHistory::SideToMid, -40.0f, 10.0f, Colors::accent);
+
+        drawLane(g, bandLane, "BANDS", -60.0f, 0.0f, -60.0f);
+        drawMean(g, bandLane, MeterHistory::LowBand, -60.0f, 0.0f, juce::Colour(0xff3498db));
+        drawMean(g, bandLane, MeterHistory::MidBand, -60.0f, 0.0f, juce::Colour(0xff9b59b6));
+        drawMean(g, bandLane, MeterHistory::HighBand, -60.0f, 0.0f, juce::Colour(0xffe74c3c));
+
+        g.setColour(Colors::textSecondary);
+        g.setFont(9.0f);
+        g.drawText("last " + formatSpan(spanSeconds), getLocalBounds().reduced(6, 2).removeFromBottom(12),
+                   juce::Justification::centredRight);
+    }
+
+private:
+    juce::Rectangle<int> getPlotBounds() const
+    {
+        return getLocalBounds().reduced(6, 4).withTrimmedLeft(labelWidth).withTrimmedBottom(12);
+    }
+
+    static float toY(juce::Rectangle<int> lane, float value, float minValue, float maxValue)
+    {
+        const float normalized = juce::jlimit(0.0f, 1.0f, (value - minValue) / (maxValue - minValue));
+        return static_cast<float>(lane.getBottom()) - normalized * static_cast<float>(lane.getHeight());
+    }
+
+    void drawLane(juce::Graphics& g, juce::Rectangle<int> lane, const juce::String& name,
+                  float minValue, float maxValue, float reference)
+    {
+        g.setColour(Colors::textSecondary.withAlpha(0.3f));
+        g.drawHorizontalLine(juce::roundToInt(toY(lane, reference, minValue, maxValue)),
+                             static_cast<float>(lane.getX()), static_cast<float>(lane.getRight()));
+
+        g.setColour(Colors::textSecondary);
+        g.setFont(9.0f);
+        g.drawText(name, lane.withX(lane.getX() - labelWidth).withWidth(labelWidth - 4), juce::Justification::centredLeft);
+    }
+
+    // Min-max bar per column, with the mean traced over it
+    void drawRange(juce::Graphics& g, juce::Rectangle<int> lane, MeterHistory::Series series,
+                   float minValue, float maxValue, juce::Colour colour)
+    {
+        const auto& data = columns[static_cast<size_t>(series)];
+
+        g.setColour(colour.withAlpha(0.3f));
+        for (size_t c = 0; c < data.size(); ++c)
+        {
+            if (! data[c].valid)
+                continue;
+
+            const float top = toY(lane, data[c].max, minValue, maxValue);
+            const float bottom = toY(lane, data[c].min, minValue, maxValue);
+            g.drawVerticalLine(lane.getX() + static_cast<int>(c), top, juce::jmax(bottom, top + 1.0f));
+        }
+
+        drawMean(g, lane, series, minValue, maxValue, colour);
+    }
+
+    void drawMean(juce::Graphics& g, juce::Rectangle<int> lane, MeterHistory::Series series,
+                  float minValue, float maxValue, juce::Colour colour)
+    {
+        const auto& data = columns[static_cast<size_t>(series)];
+        juce::Path path;
+        bool drawing = false;
+
+        for (size_t c = 0; c < data.size(); ++c)
+        {
+            if (! data[c].valid)
+            {
+                drawing = false;
+                continue;
+            }
+
+            const float x = static_cast<float>(lane.getX()) + static_cast<float>(c);
+            const float y = toY(lane, data[c].mean, minValue, maxValue);
+
+            if (drawing)
+                path.lineTo(x, y);
+            else
+                path.startNewSubPath(x, y);
+
+            drawing = true;
+        }
+
+        g.setColour(colour);
+        g.strokePath(path, juce::PathStrokeType(1.0f));
+    }
+
+    static juce::String formatSpan(double seconds)
+    {
+        if (seconds < 120.0)
+            return juce::String(juce::roundToInt(seconds)) + " s";
+        if (seconds < 2.0 * 3600.0)
+            return juce::String(seconds / 60.0, 1) + " min";
+        return juce::String(seconds / 3600.0, 1) + " h";
+    }
+
+    static constexpr int labelWidth = 44;
+    static constexpr double defaultSpanSeconds = 60.0;
+    static constexpr double minSpanSeconds = 10.0;
+
+    MeterHistory& history;
+    double spanSeconds = defaultSpanSeconds;
+    std::array<std::vector<MeterHistory::Column>, MeterHistory::NumSeries> columns;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HistoryView)
+};
@@ -239,8 +239,8 @@ public:
             float x = cx + side * radius * 0.8f;
             float y = cy - mid * radius * 0.8f;
 
-            // Fade based on age
-            float alpha = 0.3f + 0.5f * (1.0f - (float)i / samples.size());
+            // Fade based on age (samples arrive oldest-first)
+            float alpha = 0.3f + 0.5f * ((float)i / samples.size());
             g.setColour(Colors::accent.withAlpha(alpha));
             g.fillEllipse(x - 1.0f, y - 1.0f, 2.0f, 2.0f);
         }
@@ -250,6 +250,101 @@ private:
     std::vector<std::pair<float, float>> samples;
 };
 
+// Energy by stereo direction, on a half disc oriented like the Vectorscope: mid straight
+// up, L and R on the diagonals, side on the horizon (either polarity). Bins come from
+// StereoProcessor::getStereoField, left-most direction first; radius is dB.
+class StereoFieldDisplay : public juce::Component
+{
+public:
+    void setField(const float* energies, int numBins)
+    {
+        levels.resize(static_cast<size_t>(numBins), minDb);
+
+        // Instant attack, steady fall
+        for (size_t bin = 0; bin < levels.size(); ++bin)
+        {
+            const float db = juce::jmax(minDb, 10.0f * std::log10(energies[bin] + 1.0e-12f));
+            levels[bin] = juce::jmax(db, levels[bin] - releaseDbPerUpdate);
+        }
+
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat().reduced(4.0f);
+        const float radius = juce::jmin(bounds.getWidth() * 0.5f, bounds.getHeight() - 12.0f);
+        const float cx = bounds.getCentreX();
+        const float cy = bounds.getY() + radius;
+
+        // Background
+        juce::Path disc;
+        disc.addCentredArc(cx, cy, radius, radius, 0.0f,
+                           -juce::MathConstants<float>::halfPi, juce::MathConstants<float>::halfPi, true);
+        disc.closeSubPath();
+        g.setColour(juce::Colour(0xff0a0a0a));
+        g.fillPath(disc);
+
+        // Level arcs every 20 dB, and the M, L, R and S directions
+        g.setColour(juce::Colour(0xff303030));
+        for (float db = -40.0f; db < 0.0f; db += 20.0f)
+        {
+            const float r = radius * toRadius(db);
+            juce::Path arc;
+            arc.addCentredArc(cx, cy, r, r, 0.0f,
+                              -juce::MathConstants<float>::halfPi, juce::MathConstants<float>::halfPi, true);
+            g.strokePath(arc, juce::PathStrokeType(0.5f));
+        }
+
+        for (float angle : { -0.5f, -0.25f, 0.0f, 0.25f, 0.5f })
+        {
+            const float theta = angle * juce::MathConstants<float>::pi;
+            g.drawLine(cx, cy, cx + radius * std::sin(theta), cy - radius * std::cos(theta), 0.5f);
+        }
+
+        g.setColour(Colors::textSecondary);
+        g.setFont(10.0f);
+        const float labelY = cy + 1.0f;
+        g.drawText("S", juce::Rectangle<float>(cx - radius, labelY, 12.0f, 12.0f), juce::Justification::centredLeft);
+        g.drawText("S", juce::Rectangle<float>(cx + radius - 12.0f, labelY, 12.0f, 12.0f), juce::Justification::centredRight);
+        g.drawText("L", juce::Rectangle<float>(cx - radius * 0.75f - 6.0f, cy - radius * 0.75f - 6.0f, 12.0f, 12.0f), juce::Justification::centred);
+        g.drawText("R", juce::Rectangle<float>(cx + radius * 0.75f - 6.0f, cy - radius * 0.75f - 6.0f, 12.0f, 12.0f), juce::Justification::centred);
+        g.drawText("M", juce::Rectangle<float>(cx - 6.0f, cy - radius - 2.0f, 12.0f, 12.0f), juce::Justification::centred);
+
+        if (levels.empty())
+            return;
+
+        // One point per bin at its centre direction. Bins are even steps of the diamond
+        // angle t = side / (|mid| + |side|), i.e. tan(angle from M) = |t| / (1 - |t|).
+        juce::Path field;
+        field.startNewSubPath(cx, cy);
+
+        const auto numBins = static_cast<float>(levels.size());
+        for (size_t bin = 0; bin < levels.size(); ++bin)
+        {
+            const float t = (static_cast<float>(bin) + 0.5f) / numBins * 2.0f - 1.0f;
+            const float theta = std::atan2(t, 1.0f - std::abs(t));
+            const float r = radius * toRadius(levels[bin]);
+            field.lineTo(cx + r * std::sin(theta), cy - r * std::cos(theta));
+        }
+
+        field.closeSubPath();
+
+        g.setColour(Colors::accent.withAlpha(0.35f));
+        g.fillPath(field);
+        g.setColour(Colors::accent);
+        g.strokePath(field, juce::PathStrokeType(1.0f));
+    }
+
+private:
+    static float toRadius(float db) { return juce::jlimit(0.0f, 1.0f, (db - minDb) / -minDb); }
+
+    static constexpr float minDb = -60.0f;
+    static constexpr float releaseDbPerUpdate = 1.5f;
+
+    std::vector<float> levels;
+};
+
 class BandMeter : public juce::Component
 {
 public:
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LookAndFeel.h"
+#include "../DSP/StageProfiler.h"
+
+// Compact table of per-stage audio-thread timings (p50 / p99 / max and % of block budget).
+// Click the panel to reset the histograms.
+class ProfilerPanel : public juce::Component
+{
+public:
+    explicit ProfilerPanel(StageProfiler& p) : profiler(p) {}
+
+    void update()
+    {
+        for (int s = 0; s < StageProfiler::NumStages; ++s)
+            stats[s] = profiler.getStats(static_cast<StageProfiler::Stage>(s));
+        repaint();
+    }
+
+    void mouseUp(const juce::MouseEvent&) override
+    {
+        profiler.requestReset();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+
+        g.setColour(juce::Colour(0xff151515));
+        g.fillRoundedRectangle(bounds, 3.0f);
+
+        auto area = getLocalBounds().reduced(8, 4);
+        const int rowHeight = juce::jmax(10, area.getHeight() / (StageProfiler::NumStages + 1));
+        const int nameWidth = 80;
+        const int columnWidth = (area.getWidth() - nameWidth) / 5;
+
+        auto drawRow = [&](juce::Rectangle<int> row, const juce::String& name, const juce::StringArray& cells)
+        {
+            g.drawText(name, row.removeFromLeft(nameWidth), juce::Justification::centredLeft);
+            for (auto& cell : cells)
+                g.drawText(cell, row.removeFromLeft(columnWidth), juce::Justification::centredRight);
+        };
+
+        g.setFont(10.0f);
+        g.setColour(Colors::textSecondary);
+        drawRow(area.removeFromTop(rowHeight), "STAGE", { "p50 us", "p99 us", "max us", "p50 %", "p99 %" });
+
+        for (int s = 0; s < StageProfiler::NumStages; ++s)
+        {
+            const auto& st = stats[s];
+
+            // Flag stages whose tail eats a meaningful share of the block budget
+            g.setColour(st.p99Budget > 0.5 ? Colors::meterRed
+                        : st.p99Budget > 0.2 ? Colors::meterYellow : Colors::textPrimary);
+
+            drawRow(area.removeFromTop(rowHeight),
+                    StageProfiler::getStageName(static_cast<StageProfiler::Stage>(s)),
+                    { juce::String(st.p50Us, 1),
+                      juce::String(st.p99Us, 1),
+                      juce::String(st.maxUs, 1),
+                      juce::String(st.p50Budget * 100.0, 1),
+                      juce::String(st.p99Budget * 100.0, 1) });
+        }
+    }
+
+private:
+    StageProfiler& profiler;
+    std::array<StageProfiler::StageStats, StageProfiler::NumStages> stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerPanel)
+};
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LookAndFeel.h"
+#include "../DSP/SpectralWidth.h"
+
+// The spectral width curve with its nodes as handles: drag a node to move its frequency
+// (log scale, across) and width (0-200%, up); a double-click puts it back to its default.
+// The curve is drawn the way SpectralWidth joins the nodes, smoothstep in log frequency.
+class SpectralCurveEditor : public juce::Component
+{
+public:
+    explicit SpectralCurveEditor(juce::AudioProcessorValueTreeState& apvts)
+    {
+        for (int node = 0; node < SpectralWidth::numNodes; ++node)
+        {
+            const juce::String prefix = "spectralNode" + juce::String(node + 1);
+            auto& handle = handles[(size_t) node];
+
+            handle.frequencyParameter = apvts.getParameter(prefix + "Freq");
+            handle.widthParameter = apvts.getParameter(prefix + "Width");
+            jassert(handle.frequencyParameter != nullptr && handle.widthParameter != nullptr);
+
+            handle.frequency = std::make_unique<juce::ParameterAttachment>(*handle.frequencyParameter,
+                                                                            [this](float) { repaint(); });
+            handle.width = std::make_unique<juce::ParameterAttachment>(*handle.widthParameter,
+                                                                        [this](float) { repaint(); });
+        }
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat().reduced(1.0f);
+
+        g.setColour(juce::Colour(0xff151515));
+        g.fillRoundedRectangle(bounds, 3.0f);
+
+        const auto plot = getPlotBounds().toFloat();
+
+        // Decade lines and the 100% line
+        g.setFont(9.0f);
+        for (const float frequency : { 100.0f, 1000.0f, 10000.0f })
+        {
+            const float x = frequencyToX(frequency);
+            g.setColour(Colors::textSecondary.withAlpha(0.2f));
+            g.drawVerticalLine(juce::roundToInt(x), plot.getY(), plot.getBottom());
+            g.setColour(Colors::textSecondary);
+            g.drawText(frequency < 1000.0f ? juce::String(juce::roundToInt(frequency)) : juce::String(juce::roundToInt(frequency / 1000.0f)) + "k",
+                       juce::Rectangle<float>(x + 2.0f, plot.getBottom() - 12.0f, 30.0f, 12.0f), juce::Justification::centredLeft);
+        }
+
+        g.setColour(Colors::textSecondary.withAlpha(0.4f));
+        g.drawHorizontalLine(juce::roundToInt(widthToY(100.0f)), plot.getX(), plot.getRight());
+
+        // The curve, a pixel column at a time
+        const auto nodes = getSortedNodes();
+        juce::Path curve;
+
+        for (float x = plot.getX(); x <= plot.getRight(); x += 1.0f)
+        {
+            const float y = widthToY(widthAt(nodes, xToFrequency(x)));
+
+            if (x == plot.getX())
+                curve.startNewSubPath(x, y);
+            else
+                curve.lineTo(x, y);
+        }
+
+        g.setColour(Colors::accent);
+        g.strokePath(curve, juce::PathStrokeType(1.5f));
+
+        for (int node = 0; node < SpectralWidth::numNodes; ++node)
+        {
+            const auto centre = getHandlePosition(node);
+            const float radius = node == dragging || node == hovered ? 6.0f : 4.5f;
+
+            g.setColour(node == dragging ? Colors::textPrimary : Colors::accent);
+            g.fillEllipse(centre.x - radius, centre.y - radius, 2.0f * radius, 2.0f * radius);
+        }
+
+        if (dragging >= 0 || hovered >= 0)
+        {
+            const auto& handle = handles[(size_t) (dragging >= 0 ? dragging : hovered)];
+            g.setColour(Colors::textSecondary);
+            g.drawText(handle.frequencyParameter->getCurrentValueAsText() + " Hz, "
+                           + handle.widthParameter->getCurrentValueAsText() + " %",
+                       getLocalBounds().reduced(6, 2).removeFromTop(12), juce::Justification::centredRight);
+        }
+    }
+
+    void mouseMove(const juce::MouseEvent& e) override
+    {
+        const int node = findHandle(e.position);
+        if (node != hovered)
+        {
+            hovered = node;
+            repaint();
+        }
+    }
+
+    void mouseExit(const juce::MouseEvent&) override
+    {
+        hovered = -1;
+        repaint();
+    }
+
+    void mouseDown(const juce::MouseEvent& e) override
+    {
+        dragging = findHandle(e.position);
+        if (dragging < 0)
+            return;
+
+        auto& handle = handles[(size_t) dragging];
+        handle.frequency->beginGesture();
+        handle.width->beginGesture();
+        repaint();
+    }
+
+    void mouseDrag(const juce::MouseEvent& e) override
+    {
+        if (dragging < 0)
+            return;
+
+        const auto plot = getPlotBounds().toFloat();
+        const float x = juce::jlimit(plot.getX(), plot.getRight(), e.position.x);
+        const float y = juce::jlimit(plot.getY(), plot.getBottom(), e.position.y);
+
+        auto& handle = handles[(size_t) dragging];
+        handle.frequency->setValueAsPartOfGesture(xToFrequency(x));
+        handle.width->setValueAsPartOfGesture(yToWidth(y));
+    }
+
+    void mouseUp(const juce::MouseEvent&) override
+    {
+        if (dragging < 0)
+            return;
+
+        auto& handle = handles[(size_t) dragging];
+        handle.frequency->endGesture();
+        handle.width->endGesture();
+        dragging = -1;
+        repaint();
+    }
+
+    void mouseDoubleClick(const juce::MouseEvent& e) override
+    {
+        const int node = findHandle(e.position);
+        if (node < 0)
+            return;
+
+        auto& handle = handles[(size_t) node];
+        handle.frequency->setValueAsCompleteGesture(handle.frequencyParameter->convertFrom0to1(handle.frequencyParameter->getDefaultValue()));
+        handle.width->setValueAsCompleteGesture(handle.widthParameter->convertFrom0to1(handle.widthParameter->getDefaultValue()));
+    }
+
+private:
+    struct Handle
+    {
+        juce::RangedAudioParameter* frequencyParameter = nullptr;
+        juce::RangedAudioParameter* widthParameter = nullptr;
+        std::unique_ptr<juce::ParameterAttachment> frequency, width;
+    };
+
+    using Node = std::pair<float, float>;      // log2 frequency, width in %
+
+    juce::Rectangle<int> getPlotBounds() const { return getLocalBounds().reduced(10, 8); }
+
+    static float getValue(const juce::RangedAudioParameter* parameter)
+    {
+        return parameter->convertFrom0to1(parameter->getValue());
+    }
+
+    std::array<Node, SpectralWidth::numNodes> getSortedNodes() const
+    {
+        std::array<Node, SpectralWidth::numNodes> nodes;
+
+        for (size_t node = 0; node < nodes.size(); ++node)
+            nodes[node] = { std::log2(getValue(handles[node].frequencyParameter)), getValue(handles[node].widthParameter) };
+
+        std::sort(nodes.begin(), nodes.end());
+        return nodes;
+    }
+
+    static float widthAt(const std::array<Node, SpectralWidth::numNodes>& nodes, float frequency)
+    {
+        const float logFrequency = std::log2(frequency);
+
+        if (logFrequency <= nodes.front().first)
+            return nodes.front().second;
+        if (logFrequency >= nodes.back().first)
+            return nodes.back().second;
+
+        size_t segment = 0;
+        while (logFrequency > nodes[segment + 1].first)
+            ++segment;
+
+        const auto& a = nodes[segment];
+        const auto& b = nodes[segment + 1];
+        const float t = (logFrequency - a.first) / (b.first - a.first);
+        return a.second + (b.second - a.second) * t * t * (3.0f - 2.0f * t);
+    }
+
+    juce::Point<float> getHandlePosition(int node) const
+    {
+        const auto& handle = handles[(size_t) node];
+        return { frequencyToX(getValue(handle.frequencyParameter)), widthToY(getValue(handle.widthParameter)) };
+    }
+
+    // The nearest handle within reach, or -1
+    int findHandle(juce::Point<float> position) const
+    {
+        int nearest = -1;
+        float nearestDistance = 10.0f;
+
+        for (int node = 0; node < SpectralWidth::numNodes; ++node)
+        {
+            const float distance = position.getDistanceFrom(getHandlePosition(node));
+            if (distance < nearestDistance)
+            {
+                nearest = node;
+                nearestDistance = distance;
+            }
+        }
+
+        return nearest;
+    }
+
+    float frequencyToX(float frequency) const
+    {
+        const auto plot = getPlotBounds().toFloat();
+        const float position = std::log2(frequency / minFrequency) / std::log2(maxFrequency / minFrequency);
+        return plot.getX() + position * plot.getWidth();
+    }
+
+    float xToFrequency(float x) const
+    {
+        const auto plot = getPlotBounds().toFloat();
+        const float position = (x - plot.getX()) / plot.getWidth();
+        return minFrequency * std::pow(maxFrequency / minFrequency, position);
+    }
+
+    float widthToY(float width) const
+    {
+        const auto plot = getPlotBounds().toFloat();
+        return plot.getBottom() - width / maxWidth * plot.getHeight();
+    }
+
+    float yToWidth(float y) const
+    {
+        const auto plot = getPlotBounds().toFloat();
+        return (plot.getBottom() - y) / plot.getHeight() * maxWidth;
+    }
+
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float maxWidth = 200.0f;
+
+    std::array<Handle, SpectralWidth::numNodes> handles;
+    int dragging = -1, hovered = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralCurveEditor)
+};
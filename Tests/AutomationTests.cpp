@@ -0,0 +1,286 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "TestSignals.h"
+
+// Parameter events split the block they fall in, so a change takes effect on exactly its
+// sample whatever the block size: a step in output gain from that sample on, and a width
+// glide that starts there. Afterwards the parameter itself holds the last event's value.
+// A plain parameter change, as host automation arrives, lands at the start of the next
+// block even when blocks are shorter than the control period. The preset morph moves
+// the sound without touching the parameters, and holds it where it's switched off.
+class AutomationTests : public juce::UnitTest
+{
+public:
+    AutomationTests() : juce::UnitTest("Automation", "StereoImager") {}
+
+    void runTest() override
+    {
+        const auto noise = TestSignals::makeNoise(1 << 14, getRandom());
+
+        for (const int blockSize : { 64, 256, 1000 })
+        {
+            beginTest("Changes land on their sample in " + juce::String(blockSize) + "-sample blocks");
+
+            // Part-way into a block, at a block start, and on a block's last sample
+            for (const int changeSample : { 3 * blockSize + blockSize / 3, 5 * blockSize, 7 * blockSize - 1 })
+                checkChange(noise, blockSize, changeSample);
+        }
+
+        beginTest("Parameters follow their last event");
+        checkWriteBack(noise);
+
+        beginTest("The morph holds where it's switched off");
+        checkMorphHandOff(noise);
+
+        beginTest("Parameter changes land on the next short block");
+        checkImmediateChange(noise, false);
+
+        beginTest("Changes delivered like a plugin wrapper's land too");
+        checkImmediateChange(noise, true);
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+
+    // Runs the noise through a fresh processor in blockSize calls, with one parameter
+    // change at changeSample (none if negative) sent as an event in the block it falls in
+    static juce::AudioBuffer<float> render(const juce::AudioBuffer<float>& noise, int blockSize, int changeSample,
+                                           const juce::String& parameterID, float value)
+    {
+        StereoImagerAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        int parameterIndex = 0;
+        for (auto* param : processor.getParameters())
+            if (static_cast<juce::RangedAudioParameter*>(param)->getParameterID() == parameterID)
+                parameterIndex = param->getParameterIndex();
+
+        juce::AudioBuffer<float> output(noise);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            const int n = juce::jmin(blockSize, output.getNumSamples() - start);
+
+            if (changeSample >= start && changeSample < start + n)
+                processor.getParameterEvents().add(changeSample - start, parameterIndex, value);
+
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, n);
+            processor.processBlock(block, midi);
+        }
+
+        return output;
+    }
+
+    // First sample at which two renders differ by more than rounding, or -1
+    static int findFirstDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        for (int i = 0; i < a.getNumSamples(); ++i)
+            for (int ch = 0; ch < 2; ++ch)
+                if (std::abs(a.getSample(ch, i) - b.getSample(ch, i)) > 1.0e-6f)
+                    return i;
+
+        return -1;
+    }
+
+    void checkChange(const juce::AudioBuffer<float>& noise, int blockSize, int changeSample)
+    {
+        const auto reference = render(noise, blockSize, -1, "width", 100.0f);
+        const auto name = "change at " + juce::String(changeSample);
+
+        // -6 dB from the change on, exactly; nothing before it
+        const auto gained = render(noise, blockSize, changeSample, "outputGain", -6.0f);
+        const float gain = juce::Decibels::decibelsToGain(-6.0f);
+        float gainError = 0.0f;
+
+        for (int i = changeSample; i < noise.getNumSamples(); ++i)
+            for (int ch = 0; ch < 2; ++ch)
+                gainError = juce::jmax(gainError, std::abs(gained.getSample(ch, i) - reference.getSample(ch, i) * gain));
+
+        expectEquals(findFirstDifference(gained, reference), changeSample, "output gain, " + name);
+        expectLessOrEqual(gainError, 1.0e-6f, "output gain, " + name);
+
+        // The width glide starts on the change
+        const auto widened = render(noise, blockSize, changeSample, "width", 150.0f);
+        expectEquals(findFirstDifference(widened, reference), changeSample, "width, " + name);
+    }
+
+    void checkWriteBack(const juce::AudioBuffer<float>& noise)
+    {
+        // Two events on the output gain in the first block; the reference is at the last
+        // one's value throughout
+        constexpr int blockSize = 256;
+        StereoImagerAudioProcessor processor, reference;
+        auto* outputGain = processor.getAPVTS().getParameter("outputGain");
+        auto* referenceGain = reference.getAPVTS().getParameter("outputGain");
+        referenceGain->setValueNotifyingHost(referenceGain->convertTo0to1(-6.0f));
+
+        for (auto* p : { &processor, &reference })
+        {
+            p->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            p->prepareToPlay(sampleRate, blockSize);
+        }
+
+        processor.getParameterEvents().add(10, outputGain->getParameterIndex(), -12.0f);
+        processor.getParameterEvents().add(100, outputGain->getParameterIndex(), -6.0f);
+
+        juce::AudioBuffer<float> a(2, blockSize), b(2, blockSize);
+        juce::MidiBuffer midi;
+        float maxDifference = 0.0f;
+
+        for (int block = 0; block < 2; ++block)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                a.copyFrom(ch, 0, noise, ch, block * blockSize, blockSize);
+                b.copyFrom(ch, 0, noise, ch, block * blockSize, blockSize);
+            }
+
+            processor.processBlock(a, midi);
+            reference.processBlock(b, midi);
+
+            if (block == 0)
+            {
+                // A state saved before the timer has run holds the last event's value, and
+                // saving leaves the parameter itself alone
+                juce::MemoryBlock state;
+                processor.getStateInformation(state);
+                expectWithinAbsoluteError(outputGain->convertFrom0to1(outputGain->getValue()), 0.0f, 1.0e-4f);
+
+                StereoImagerAudioProcessor loaded;
+                loaded.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+                auto* loadedGain = loaded.getAPVTS().getParameter("outputGain");
+                expectWithinAbsoluteError(loadedGain->convertFrom0to1(loadedGain->getValue()), -6.0f, 1.0e-4f);
+
+                // Then the write-back, as the timer would do it
+                outputGain->setValueNotifyingHost(outputGain->convertTo0to1(-6.0f));
+                continue;
+            }
+
+            // Taking the written-back value doesn't move the sound
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    maxDifference = juce::jmax(maxDifference, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+        }
+
+        expectLessOrEqual(maxDifference, 1.0e-6f);
+    }
+
+    void checkMorphHandOff(const juce::AudioBuffer<float>& noise)
+    {
+        // All the way from Init to Mono Check (0% width), then switched off half-way through
+        constexpr int blockSize = 512;
+        constexpr int numBlocks = 32;
+        StereoImagerAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+        auto set = [&apvts](const juce::String& parameterID, float value)
+        {
+            auto* param = apvts.getParameter(parameterID);
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+        };
+
+        set("morphA", 0.0f);
+        set("morphB", 7.0f);
+        set("morph", 100.0f);
+        set("presetMorph", 1.0f);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        auto* width = apvts.getParameter("width");
+        const float widthValue = width->getValue();
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        float sideMorphing = 0.0f, sideAfter = 0.0f;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            if (block == numBlocks / 2)
+                set("presetMorph", 0.0f);
+
+            for (int ch = 0; ch < 2; ++ch)
+                buffer.copyFrom(ch, 0, noise, ch, block * blockSize, blockSize);
+
+            processor.processBlock(buffer, midi);
+
+            // Mono once the width has glided there, and still mono after the switch
+            float side = 0.0f;
+            for (int i = 0; i < blockSize; ++i)
+                side = juce::jmax(side, std::abs(buffer.getSample(0, i) - buffer.getSample(1, i)));
+
+            if (block >= numBlocks / 2)
+                sideAfter = juce::jmax(sideAfter, side);
+            else if (block >= numBlocks / 4)
+                sideMorphing = juce::jmax(sideMorphing, side);
+        }
+
+        expectLessOrEqual(sideMorphing, 1.0e-6f);
+        expectLessOrEqual(sideAfter, 1.0e-6f);
+
+        // The morph moved the sound, not the parameter (that waits for the message thread)
+        expectEquals(width->getValue(), widthValue);
+    }
+
+    // The change comes from setValueNotifyingHost(), or the way the plugin wrappers pass
+    // host automation on (and StereoImagerHost --automation does): setValue() then the
+    // listeners, on the audio thread
+    void checkImmediateChange(const juce::AudioBuffer<float>& noise, bool likeWrapper)
+    {
+        // 16-sample blocks, and the gain changes between the fifth and sixth: mid-period
+        constexpr int blockSize = 16;
+        constexpr int changeSample = 5 * blockSize;
+        StereoImagerAudioProcessor processor, reference;
+
+        for (auto* p : { &processor, &reference })
+        {
+            p->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            p->prepareToPlay(sampleRate, blockSize);
+        }
+
+        juce::AudioBuffer<float> changed(2, 256), unchanged(2, 256);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < changed.getNumSamples(); start += blockSize)
+        {
+            if (start == changeSample)
+            {
+                auto* outputGain = processor.getAPVTS().getParameter("outputGain");
+                const float value = outputGain->convertTo0to1(-6.0f);
+
+                if (likeWrapper)
+                {
+                    outputGain->setValue(value);
+                    outputGain->sendValueChangedMessageToListeners(value);
+                }
+                else
+                {
+                    outputGain->setValueNotifyingHost(value);
+                }
+            }
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                changed.copyFrom(ch, start, noise, ch, start, blockSize);
+                unchanged.copyFrom(ch, start, noise, ch, start, blockSize);
+            }
+
+            juce::AudioBuffer<float> a(changed.getArrayOfWritePointers(), 2, start, blockSize);
+            juce::AudioBuffer<float> b(unchanged.getArrayOfWritePointers(), 2, start, blockSize);
+            processor.processBlock(a, midi);
+            reference.processBlock(b, midi);
+        }
+
+        float gainError = 0.0f;
+        for (int i = changeSample; i < changed.getNumSamples(); ++i)
+            for (int ch = 0; ch < 2; ++ch)
+                gainError = juce::jmax(gainError, std::abs(changed.getSample(ch, i)
+                                                           - unchanged.getSample(ch, i) * juce::Decibels::decibelsToGain(-6.0f)));
+
+        expectEquals(findFirstDifference(changed, unchanged), changeSample);
+        expectLessOrEqual(gainError, 1.0e-6f);
+    }
+};
+
+static AutomationTests automationTests;
@@ -0,0 +1,140 @@
+#include <JuceHeader.h>
+#include "DSP/Crossover.h"
+#include "DSP/MultibandProcessor.h"
+#include "TestSignals.h"
+
+// The time-parallel block IIR must be interchangeable with per-sample filtering: against
+// a double-precision reference it may not be clearly less accurate, and a processor whose
+// splits share one scratch buffer must produce what it does without the block path.
+class BlockIIRTests : public juce::UnitTest
+{
+public:
+    BlockIIRTests() : juce::UnitTest("Block IIR", "StereoImager") {}
+
+    void runTest() override
+    {
+        const auto noise = TestSignals::makeNoise(1 << 17, getRandom());
+
+        for (const double rate : { 44100.0, 48000.0, 96000.0 })
+        {
+            beginTest("Split against a double-precision reference at " + juce::String(rate, 0) + " Hz");
+
+            for (const float frequency : { 20.0f, 120.0f, 1000.0f, 8000.0f, 18000.0f })
+                for (const int block : { BlockIIR::minBlockSize, 5000, 32768 })
+                    checkSplit(noise, rate, frequency, block);
+        }
+
+        beginTest("Shared scratch across a processor's splits");
+        checkSharedScratch(noise);
+    }
+
+private:
+    void checkSplit(const juce::AudioBuffer<float>& noise, double rate, float frequency, int block)
+    {
+        // The crossover's own coefficients at a steady frequency, run in double
+        DSPUtils::BiquadCoeffs lp, hp;
+        DSPUtils::SharedTableCache::get<DSPUtils::CrossoverTable>(rate)->lookup(std::log2(frequency), lp, hp);
+
+        std::vector<float> scratch(static_cast<size_t>(BlockIIR::scratchSize));
+        LR4Crossover blocked, perSample;
+        blocked.prepare(rate, frequency);
+        blocked.setBlockScratch(scratch.data());
+        perSample.prepare(rate, frequency);
+
+        const auto n = static_cast<size_t>(block);
+        std::vector<float> a(n * 4), b(n * 4);
+        double state[4][2][2] {};
+        float blockError = 0.0f, sampleError = 0.0f;
+
+        // Consecutive blocks, so the state carried between calls is checked too
+        const int numBlocks = juce::jmax(3, noise.getNumSamples() / block);
+
+        for (int pass = 0; pass < numBlocks; ++pass)
+        {
+            const int offset = (pass * block) % (noise.getNumSamples() - block);
+            const float* inL = noise.getReadPointer(0, offset);
+            const float* inR = noise.getReadPointer(1, offset);
+
+            blocked.process(inL, inR, &a[0], &a[n], &a[n * 2], &a[n * 3], block);
+            perSample.process(inL, inR, &b[0], &b[n], &b[n * 2], &b[n * 3], block);
+
+            // Bands: low L, low R, high L, high R
+            for (int band = 0; band < 4; ++band)
+            {
+                const auto& c = band < 2 ? lp : hp;
+                const float* input = band % 2 == 0 ? inL : inR;
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    double x = input[i];
+                    for (auto& z : state[band])
+                    {
+                        const double y = c.b0 * x + z[0];
+                        z[0] = c.b1 * x - c.a1 * y + z[1];
+                        z[1] = c.b2 * x - c.a2 * y;
+                        x = y;
+                    }
+
+                    const auto k = static_cast<size_t>(band) * n + i;
+                    blockError = juce::jmax(blockError, static_cast<float>(std::abs(a[k] - x)));
+                    sampleError = juce::jmax(sampleError, static_cast<float>(std::abs(b[k] - x)));
+                }
+            }
+        }
+
+        // Rounding differs between the paths; the block path must be no worse than twice
+        // the per-sample path's own error (with a floor for the near-exact cases)
+        expectLessOrEqual(blockError, 2.0f * sampleError + 1.0e-6f,
+                          juce::String(frequency, 0) + " Hz, " + juce::String(block) + "-sample blocks");
+    }
+
+    void checkSharedScratch(const juce::AudioBuffer<float>& noise)
+    {
+        // Prepared for large blocks, so every split gets the shared scratch. Fed whole
+        // blocks, the splits take the block path one after another; fed short ones, they
+        // run sample by sample.
+        constexpr int blockSize = 2 * BlockIIR::minBlockSize;
+        constexpr int shortBlock = 256;
+
+        MultibandProcessor blocked, perSample;
+
+        for (auto* bands : { &blocked, &perSample })
+        {
+            bands->prepare(48000.0, blockSize);
+            bands->setEnabled(true);
+            bands->setMonoBass(true, 60.0f);
+            bands->setLowMidCrossover(300.0f);
+            bands->setMidHighCrossover(5000.0f);
+            bands->setLowWidth(50.0f);
+            bands->setMidWidth(140.0f);
+            bands->setHighWidth(80.0f);
+        }
+
+        juce::AudioBuffer<float> a(2, blockSize), b(2, shortBlock);
+        float maxDifference = 0.0f;
+
+        for (int start = 0; start + blockSize <= noise.getNumSamples(); start += blockSize)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                a.copyFrom(ch, 0, noise, ch, start, blockSize);
+
+            blocked.process(a);
+
+            for (int offset = 0; offset < blockSize; offset += shortBlock)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    b.copyFrom(ch, 0, noise, ch, start + offset, shortBlock);
+
+                perSample.process(b);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < shortBlock; ++i)
+                        maxDifference = juce::jmax(maxDifference, std::abs(a.getSample(ch, offset + i) - b.getSample(ch, i)));
+            }
+        }
+
+        expectLessThan(maxDifference, 1.0e-4f);
+    }
+};
+
+static BlockIIRTests blockIIRTests;
@@ -0,0 +1,102 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "TestSignals.h"
+
+// With latency in the chain (multirate mono bass at 88.2 kHz and up, the spectral curve),
+// bypass must play the input delayed by exactly that latency from the block it's switched
+// on in, and switched off, the processed sound must carry on as if bypass never happened:
+// no leftovers from an earlier bypass, and no stale filter or overlap-add state.
+class BypassTests : public juce::UnitTest
+{
+public:
+    BypassTests() : juce::UnitTest("Bypass", "StereoImager") {}
+
+    void runTest() override
+    {
+        const auto noise = TestSignals::makeNoise(1 << 15, getRandom());
+
+        beginTest("Bypass toggles at 96 kHz with multirate mono bass");
+        checkToggles(noise, false);
+
+        beginTest("Bypass toggles at 96 kHz with multirate and the spectral curve");
+        checkToggles(noise, true);
+    }
+
+private:
+    static constexpr double sampleRate = 96000.0;
+    static constexpr int blockSize = 256;
+
+    // Runs the noise through a fresh processor with multirate mono bass on, flipping bypass
+    // at the start of each block listed in toggles
+    static juce::AudioBuffer<float> render(const juce::AudioBuffer<float>& noise, bool spectral,
+                                           const std::vector<int>& toggles, int& latency)
+    {
+        StereoImagerAudioProcessor processor;
+        auto& apvts = processor.getAPVTS();
+        auto set = [&apvts](const juce::String& parameterID, float value)
+        {
+            auto* param = apvts.getParameter(parameterID);
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+        };
+
+        // Switched on before prepareToPlay(), which allocates the curve
+        set("multirate", 1.0f);
+        set("spectralWidth", spectral ? 1.0f : 0.0f);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        latency = processor.getLatencySamples();
+
+        juce::AudioBuffer<float> output(noise);
+        juce::MidiBuffer midi;
+        bool bypassed = false;
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            if (std::find(toggles.begin(), toggles.end(), start) != toggles.end())
+            {
+                bypassed = ! bypassed;
+                set("bypass", bypassed ? 1.0f : 0.0f);
+            }
+
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, blockSize);
+            processor.processBlock(block, midi);
+        }
+
+        return output;
+    }
+
+    void checkToggles(const juce::AudioBuffer<float>& noise, bool spectral)
+    {
+        // Twice, so the second bypass follows an earlier one
+        const std::vector<int> toggles { 20 * blockSize, 40 * blockSize, 70 * blockSize, 90 * blockSize };
+
+        int latency = 0, referenceLatency = 0;
+        const auto reference = render(noise, spectral, {}, referenceLatency);
+        const auto toggled = render(noise, spectral, toggles, latency);
+
+        expectGreaterThan(latency, 0);
+        expectEquals(latency, referenceLatency);
+
+        float dryError = 0.0f, processedError = 0.0f;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int i = 0; i < toggled.getNumSamples(); ++i)
+            {
+                const bool bypassed = (i >= toggles[0] && i < toggles[1]) || (i >= toggles[2] && i < toggles[3]);
+                const float out = toggled.getSample(ch, i);
+
+                if (bypassed)
+                    dryError = juce::jmax(dryError, std::abs(out - noise.getSample(ch, i - latency)));
+                else
+                    processedError = juce::jmax(processedError, std::abs(out - reference.getSample(ch, i)));
+            }
+        }
+
+        expectLessOrEqual(dryError, 1.0e-6f, "Bypass isn't the input delayed by the latency");
+        expectLessOrEqual(processedError, 1.0e-6f, "The processed sound changed around a bypass");
+    }
+};
+
+static BypassTests bypassTests;
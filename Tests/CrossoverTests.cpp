@@ -0,0 +1,50 @@
+#include <JuceHeader.h>
+#include "DSP/Crossover.h"
+#include "TestSignals.h"
+
+// The two crossover engines implement the same Linkwitz-Riley split, so switching the
+// crossover engine parameter may change the cost but not the sound.
+class CrossoverTests : public juce::UnitTest
+{
+public:
+    CrossoverTests() : juce::UnitTest("Crossover", "StereoImager") {}
+
+    void runTest() override
+    {
+        const auto noise = TestSignals::makeNoise(1 << 16, getRandom());
+
+        for (const double rate : { 44100.0, 48000.0, 96000.0 })
+        {
+            beginTest("State-variable engine against the biquads at " + juce::String(rate, 0) + " Hz");
+
+            for (const float frequency : { 20.0f, 250.0f, 1000.0f, 8000.0f, 18000.0f })
+                checkEngines(noise, rate, frequency);
+        }
+    }
+
+private:
+    void checkEngines(const juce::AudioBuffer<float>& noise, double rate, float frequency)
+    {
+        LR4Crossover biquad, stateVariable;
+        biquad.prepare(rate, frequency);
+        stateVariable.setEngine(LR4Crossover::Engine::StateVariable);
+        stateVariable.prepare(rate, frequency);
+
+        const int n = noise.getNumSamples();
+        const auto size = static_cast<size_t>(n);
+        std::vector<float> a(size * 4), b(size * 4);
+
+        biquad.process(noise.getReadPointer(0), noise.getReadPointer(1), &a[0], &a[size], &a[size * 2], &a[size * 3], n);
+        stateVariable.process(noise.getReadPointer(0), noise.getReadPointer(1), &b[0], &b[size], &b[size * 2], &b[size * 3], n);
+
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i)
+            maxDifference = juce::jmax(maxDifference, std::abs(a[i] - b[i]));
+
+        // Float rounding only, which the biquads feel most at the lowest frequencies:
+        // more than 50 dB below the -6 dBFS noise
+        expectLessThan(maxDifference, 1.0e-3f, juce::String(frequency, 0) + " Hz");
+    }
+};
+
+static CrossoverTests crossoverTests;
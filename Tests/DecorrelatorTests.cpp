@@ -0,0 +1,69 @@
+#include <JuceHeader.h>
+#include "DSP/Decorrelator.h"
+
+// The decorrelator widens mono by moving the channels apart around their sum: on mono
+// noise it must settle at the target correlation and leave L + R exactly as it was.
+class DecorrelatorTests : public juce::UnitTest
+{
+public:
+    DecorrelatorTests() : juce::UnitTest("Decorrelator", "StereoImager") {}
+
+    void runTest() override
+    {
+        for (const float target : { 0.0f, 0.5f, 0.8f })
+        {
+            beginTest("Mono noise to a correlation of " + juce::String(target, 1));
+            checkTarget(target);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    void checkTarget(float target)
+    {
+        Decorrelator decorrelator;
+        decorrelator.prepare(sampleRate, blockSize);
+        decorrelator.setTargetCorrelation(target);
+        decorrelator.setEnabled(true);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        auto& random = getRandom();
+
+        // Settle for a second, then measure a second
+        const int settleBlocks = static_cast<int>(sampleRate) / blockSize;
+        double cross = 0.0, leftSq = 0.0, rightSq = 0.0;
+        float monoError = 0.0f;
+
+        for (int block = 0; block < 2 * settleBlocks; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float x = (random.nextFloat() * 2.0f - 1.0f) * 0.5f;
+                buffer.setSample(0, i, x);
+                buffer.setSample(1, i, x);
+            }
+
+            juce::AudioBuffer<float> input(buffer);
+            decorrelator.process(buffer.getWritePointer(0), buffer.getWritePointer(1), blockSize);
+
+            if (block < settleBlocks)
+                continue;
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float left = buffer.getSample(0, i), right = buffer.getSample(1, i);
+                cross += left * right;
+                leftSq += left * left;
+                rightSq += right * right;
+                monoError = juce::jmax(monoError, std::abs(left + right - 2.0f * input.getSample(0, i)));
+            }
+        }
+
+        expectWithinAbsoluteError(static_cast<float>(cross / std::sqrt(leftSq * rightSq)), target, 0.05f, "correlation");
+        expectLessThan(monoError, 1.0e-5f, "mono sum");
+    }
+};
+
+static DecorrelatorTests decorrelatorTests;
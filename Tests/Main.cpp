@@ -0,0 +1,52 @@
+// Unit tests for the plugin's processor and DSP, run by ctest.
+//
+//   StereoImagerTests [--category StereoImager] [--test "Test Name"] [--seed N]
+//
+// The tests are juce::UnitTest subclasses registered by static instances in the other
+// files here. The exit code is the number of failed checks (0 = pass).
+
+#include <JuceHeader.h>
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    const auto seed = args.containsOption("--seed") ? args.getValueForOption("--seed").getLargeIntValue()
+                                                    : juce::Random::getSystemRandom().nextInt64();
+
+    if (args.containsOption("--test"))
+    {
+        const auto name = args.getValueForOption("--test");
+        juce::Array<juce::UnitTest*> selected;
+
+        for (auto* test : juce::UnitTest::getAllTests())
+            if (test->getName() == name)
+                selected.add(test);
+
+        if (selected.isEmpty())
+        {
+            std::fprintf(stderr, "No test named \"%s\"\n", name.toRawUTF8());
+            return 2;
+        }
+
+        runner.runTests(selected, seed);
+    }
+    else
+    {
+        const auto category = args.containsOption("--category") ? args.getValueForOption("--category")
+                                                                : juce::String("StereoImager");
+        runner.runTestsInCategory(category, seed);
+    }
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    std::printf("%d test%s, %d failure%s\n", runner.getNumResults(), runner.getNumResults() == 1 ? "" : "s",
+                failures, failures == 1 ? "" : "s");
+    return juce::jmin(failures, 255);
+}
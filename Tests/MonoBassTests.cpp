@@ -0,0 +1,198 @@
+#include <JuceHeader.h>
+#include "DSP/MultibandProcessor.h"
+#include "DSP/StereoProcessor.h"
+
+// In multiband mode mono bass is a band of the crossover tree rather than the stereo
+// processor's own split ahead of it. At centre pan the tree must give what that two-stage
+// chain gave: sample for sample when the mono bass band comes off below the low-mid split
+// (the same filters in another order), and band for band elsewhere, where the bands
+// overlap a little differently around the crossovers. Switching the mono bass on the
+// low-mid split (where no band joins or leaves the tree) must not click.
+class MonoBassTests : public juce::UnitTest
+{
+public:
+    MonoBassTests() : juce::UnitTest("Mono bass", "StereoImager") {}
+
+    void runTest() override
+    {
+        beginTest("Bass band below the low-mid split matches the two-stage chain");
+        checkSamples(120.0f, 250.0f);
+
+        beginTest("Mono bass at the low-mid split matches the two-stage chain");
+        checkLevels(250.0f, 250.0f, { 40.0f, 1000.0f, 16000.0f });
+
+        beginTest("Bass band above the low-mid split matches the two-stage chain");
+        checkLevels(400.0f, 150.0f, { 40.0f, 1600.0f, 16000.0f });
+
+        beginTest("Switching mono bass on the low-mid split glides");
+        checkToggle(250.0f);
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr float midHighFreq = 4000.0f;
+
+    // The stereo processor (pan, balance and width neutral) ahead of the bands, with mono
+    // bass in the one or the other
+    struct Chain
+    {
+        Chain(bool inTree, float monoBassFreq, float lowMidFreq)
+        {
+            stereo.prepare(sampleRate, blockSize);
+            stereo.setVisualsEnabled(false);
+            stereo.setWidth(100.0f);
+            stereo.setPan(0.0f);
+            stereo.setBalance(0.0f);
+            stereo.setMonoBassFreq(monoBassFreq);
+            stereo.setMonoBassEnabled(! inTree);
+
+            bands.prepare(sampleRate, blockSize);
+            bands.setEnabled(true);
+            bands.setMonoBass(inTree, monoBassFreq);
+            bands.setLowMidCrossover(lowMidFreq);
+            bands.setMidHighCrossover(midHighFreq);
+            bands.setLowWidth(150.0f);
+            bands.setMidWidth(70.0f);
+            bands.setHighWidth(130.0f);
+        }
+
+        void process(juce::AudioBuffer<float>& buffer)
+        {
+            stereo.process(buffer);
+            bands.process(buffer);
+        }
+
+        StereoProcessor stereo;
+        MultibandProcessor bands;
+    };
+
+    void checkSamples(float monoBassFreq, float lowMidFreq)
+    {
+        Chain separate(false, monoBassFreq, lowMidFreq), inTree(true, monoBassFreq, lowMidFreq);
+        juce::AudioBuffer<float> a(2, blockSize), b(2, blockSize);
+        auto& random = getRandom();
+        float maxDifference = 0.0f;
+
+        // Compared once the crossovers have glided from their defaults
+        for (int block = 0; block < 256; ++block)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    a.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+            for (int ch = 0; ch < 2; ++ch)
+                b.copyFrom(ch, 0, a, ch, 0, blockSize);
+
+            separate.process(a);
+            inTree.process(b);
+
+            if (block < 32)
+                continue;
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    maxDifference = juce::jmax(maxDifference, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+        }
+
+        expectLessThan(maxDifference, 1.0e-4f);
+    }
+
+    void checkLevels(float monoBassFreq, float lowMidFreq, std::initializer_list<float> frequencies)
+    {
+        for (const float frequency : frequencies)
+        {
+            Chain separate(false, monoBassFreq, lowMidFreq), inTree(true, monoBassFreq, lowMidFreq);
+            const auto expected = measure(separate, frequency);
+            const auto actual = measure(inTree, frequency);
+            const auto name = juce::String(frequency, 0) + " Hz";
+
+            expectWithinAbsoluteError(toDecibels(actual.mid), toDecibels(expected.mid), 0.1f, name + " mid");
+            expectWithinAbsoluteError(toDecibels(actual.side), toDecibels(expected.side), 0.1f, name + " side");
+        }
+    }
+
+    struct Levels { float mid = 0.0f, side = 0.0f; };
+
+    // Steady RMS of a sine with a side component (R a third of L, a radian behind)
+    static Levels measure(Chain& chain, float frequency)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        const double step = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        double midSum = 0.0, sideSum = 0.0;
+        int count = 0;
+
+        for (int block = 0; block < 200; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const double phase = step * (block * blockSize + i);
+                buffer.setSample(0, i, static_cast<float>(0.5 * std::sin(phase)));
+                buffer.setSample(1, i, static_cast<float>(0.5 / 3.0 * std::sin(phase - 1.0)));
+            }
+
+            chain.process(buffer);
+
+            if (block < 100)
+                continue;
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const double mid = 0.5 * (buffer.getSample(0, i) + buffer.getSample(1, i));
+                const double side = 0.5 * (buffer.getSample(0, i) - buffer.getSample(1, i));
+                midSum += mid * mid;
+                sideSum += side * side;
+                ++count;
+            }
+        }
+
+        return { static_cast<float>(std::sqrt(midSum / count)), static_cast<float>(std::sqrt(sideSum / count)) };
+    }
+
+    // Anything over 50 dB below the input side counts as removed
+    static float toDecibels(float level) { return juce::Decibels::gainToDecibels(level, -66.0f); }
+
+    void checkToggle(float monoBassFreq)
+    {
+        // A pure side sine well below the split, so the mono bass takes all of it
+        MultibandProcessor bands;
+        bands.prepare(sampleRate, blockSize);
+        bands.setEnabled(true);
+        bands.setLowMidCrossover(monoBassFreq);
+        bands.setMidHighCrossover(midHighFreq);
+
+        constexpr double frequency = 40.0;
+        const double step = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        float previous = 0.0f, maxStep = 0.0f;
+
+        for (int block = 0; block < 400; ++block)
+        {
+            // On after a second, off again after another
+            if (block == 100 || block == 200)
+                bands.setMonoBass(block == 100, monoBassFreq);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float x = static_cast<float>(0.5 * std::sin(step * (block * blockSize + i)));
+                buffer.setSample(0, i, x);
+                buffer.setSample(1, i, -x);
+            }
+
+            bands.process(buffer);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float y = buffer.getSample(0, i);
+                if (block > 0 || i > 0)
+                    maxStep = juce::jmax(maxStep, std::abs(y - previous));
+                previous = y;
+            }
+        }
+
+        // The sine alone moves by up to 0.5 * step per sample
+        expectLessThan(maxStep, 2.0f * static_cast<float>(0.5 * step));
+    }
+};
+
+static MonoBassTests monoBassTests;
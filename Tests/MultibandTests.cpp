@@ -0,0 +1,191 @@
+#include <JuceHeader.h>
+#include "DSP/MultibandProcessor.h"
+#include "TestSignals.h"
+
+// The band tree is the plain sum of its Linkwitz-Riley bands, whichever path runs it: the
+// neutral path at 100% widths must sound like the bands, a switch between the paths must
+// not click, and the band meters must read the same on either path.
+class MultibandTests : public juce::UnitTest
+{
+public:
+    MultibandTests() : juce::UnitTest("Multiband", "StereoImager") {}
+
+    void runTest() override
+    {
+        const auto noise = TestSignals::makeNoise(1 << 17, getRandom());
+
+        beginTest("Widened bands against their plain sum");
+        checkAgainstReference(noise, 150.0f, 70.0f, 130.0f);
+
+        beginTest("Neutral path against the plain band sum");
+        checkAgainstReference(noise, 100.0f, 100.0f, 100.0f);
+
+        beginTest("Switching in and out of the neutral path");
+        checkSwitching(noise);
+
+        beginTest("Band meters on the neutral path");
+        checkMeters(noise);
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    // The three bands straight from two splits, widened and added up, at the processor's
+    // default crossovers and with its width glides
+    struct Reference
+    {
+        Reference()
+        {
+            lowMid.prepare(sampleRate, 250.0f);
+            midHigh.prepare(sampleRate, 4000.0f);
+
+            for (auto* width : widths)
+            {
+                width->reset(sampleRate, 20.0f);
+                width->setCurrentAndTargetValue(1.0f);
+            }
+
+            for (auto* band : { &low, &mid, &high })
+                band->setSize(2, blockSize);
+        }
+
+        void setWidths(float lowWidth, float midWidth, float highWidth)
+        {
+            lowSmoothed.setTargetValue(lowWidth / 100.0f);
+            midSmoothed.setTargetValue(midWidth / 100.0f);
+            highSmoothed.setTargetValue(highWidth / 100.0f);
+        }
+
+        void process(juce::AudioBuffer<float>& buffer)
+        {
+            const int n = buffer.getNumSamples();
+            lowMid.process(buffer.getReadPointer(0), buffer.getReadPointer(1), low.getWritePointer(0), low.getWritePointer(1),
+                           high.getWritePointer(0), high.getWritePointer(1), n);
+            midHigh.process(high.getReadPointer(0), high.getReadPointer(1), mid.getWritePointer(0), mid.getWritePointer(1),
+                            high.getWritePointer(0), high.getWritePointer(1), n);
+
+            for (int i = 0; i < n; ++i)
+            {
+                float left = 0.0f, right = 0.0f;
+                juce::AudioBuffer<float>* bands[] = { &low, &mid, &high };
+
+                for (size_t band = 0; band < 3; ++band)
+                {
+                    const float l = bands[band]->getSample(0, i), r = bands[band]->getSample(1, i);
+                    const float m = (l + r) * 0.5f;
+                    const float s = (l - r) * 0.5f * widths[band]->getNextValue();
+                    left += m + s;
+                    right += m - s;
+                }
+
+                buffer.setSample(0, i, left);
+                buffer.setSample(1, i, right);
+            }
+        }
+
+        LR4Crossover lowMid, midHigh;
+        DSPUtils::SmoothedValue lowSmoothed, midSmoothed, highSmoothed;
+        DSPUtils::SmoothedValue* widths[3] { &lowSmoothed, &midSmoothed, &highSmoothed };
+        juce::AudioBuffer<float> low, mid, high;
+    };
+
+    // Runs the processor and the reference side by side over the noise, calling
+    // changeWidths(block) first, and returns the largest difference between them
+    template <typename ChangeWidths>
+    static float runAgainstReference(const juce::AudioBuffer<float>& noise, MultibandProcessor& bands,
+                                     Reference& reference, ChangeWidths&& changeWidths)
+    {
+        juce::AudioBuffer<float> a(2, blockSize), b(2, blockSize);
+        float maxDifference = 0.0f;
+
+        for (int block = 0; (block + 1) * blockSize <= noise.getNumSamples(); ++block)
+        {
+            changeWidths(block);
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                a.copyFrom(ch, 0, noise, ch, block * blockSize, blockSize);
+                b.copyFrom(ch, 0, noise, ch, block * blockSize, blockSize);
+            }
+
+            bands.process(a);
+            reference.process(b);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    maxDifference = juce::jmax(maxDifference, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+        }
+
+        return maxDifference;
+    }
+
+    void checkAgainstReference(const juce::AudioBuffer<float>& noise, float lowWidth, float midWidth, float highWidth)
+    {
+        MultibandProcessor bands;
+        bands.prepare(sampleRate, blockSize);
+        bands.setLowWidth(lowWidth);
+        bands.setMidWidth(midWidth);
+        bands.setHighWidth(highWidth);
+
+        Reference reference;
+        reference.setWidths(lowWidth, midWidth, highWidth);
+
+        // Float rounding only: the neutral path's allpass runs in another order than the
+        // split it replaces
+        expectLessThan(runAgainstReference(noise, bands, reference, [](int) {}), 1.0e-4f);
+    }
+
+    void checkSwitching(const juce::AudioBuffer<float>& noise)
+    {
+        MultibandProcessor bands;
+        bands.prepare(sampleRate, blockSize);
+        Reference reference;
+
+        // Every quarter second the mid width leaves 100% or comes back. Against bands that
+        // never stopped, the hand-overs may only differ while the incoming path warms up
+        // and fades in.
+        const float maxDifference = runAgainstReference(noise, bands, reference, [&](int block)
+        {
+            const int period = static_cast<int>(0.25 * sampleRate) / blockSize;
+            if (block % period != 0)
+                return;
+
+            const float width = (block / period) % 2 == 0 ? 100.0f : 140.0f;
+            bands.setMidWidth(width);
+            reference.setWidths(100.0f, width, 100.0f);
+        });
+
+        expectLessThan(maxDifference, 0.01f);
+    }
+
+    void checkMeters(const juce::AudioBuffer<float>& noise)
+    {
+        // All at 100% runs the neutral path; a hair over on the mid band, the full tree
+        MultibandProcessor neutral, full;
+        neutral.prepare(sampleRate, blockSize);
+        full.prepare(sampleRate, blockSize);
+        full.setMidWidth(100.1f);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+
+        for (auto* bands : { &neutral, &full })
+        {
+            for (int start = 0; start + blockSize <= noise.getNumSamples(); start += blockSize)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.copyFrom(ch, 0, noise, ch, start, blockSize);
+
+                bands->process(buffer);
+            }
+        }
+
+        auto decibels = [](float level) { return juce::Decibels::gainToDecibels(level); };
+
+        expectWithinAbsoluteError(decibels(neutral.getLowLevel()), decibels(full.getLowLevel()), 0.1f, "low");
+        expectWithinAbsoluteError(decibels(neutral.getMidLevel()), decibels(full.getMidLevel()), 0.1f, "mid");
+        expectWithinAbsoluteError(decibels(neutral.getHighLevel()), decibels(full.getHighLevel()), 0.1f, "high");
+    }
+};
+
+static MultibandTests multibandTests;
@@ -0,0 +1,156 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "Debug/RealtimeSafety.h"
+
+// Sweeps parameter combinations through processBlock with the real-time checker active
+// (the test build always compiles it in), with and without parameter events, and with
+// the spectral curve's STFT running whenever it is switched on. Any allocation, lock or
+// blocking call on the audio thread is counted as a failure rather than aborting the run.
+namespace
+{
+    std::atomic<int> violations { 0 };
+
+    void countViolation(const char* functionName, const char* stackTrace)
+    {
+        if (violations.fetch_add(1) < 10)
+            std::fprintf(stderr, "Real-time violation: %s\n%s\n", functionName, stackTrace);
+    }
+}
+
+class RealtimeSafetyTests : public juce::UnitTest
+{
+public:
+    RealtimeSafetyTests() : juce::UnitTest("Real-time safety", "StereoImager") {}
+
+    void runTest() override
+    {
+        beginTest("Checker is compiled in");
+        expect(RealtimeSafety::isEnabled(), "The test build needs STEREOIMAGER_RT_CHECKS=1");
+
+        if (! RealtimeSafety::isEnabled())
+            return;
+
+        RealtimeSafety::setViolationHandler(countViolation);
+
+        for (const double sampleRate : { 48000.0, 96000.0 })
+        {
+            beginTest("Parameter sweep at " + juce::String(sampleRate, 0) + " Hz");
+            violations.store(0);
+            sweep(sampleRate);
+            expectEquals(violations.load(), 0);
+        }
+
+        RealtimeSafety::setViolationHandler(nullptr);
+    }
+
+private:
+    static constexpr int maxBlockSize = 512;
+
+    void sweep(double sampleRate)
+    {
+        StereoImagerAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+
+        juce::AudioBuffer<float> buffer(2, maxBlockSize);
+        juce::MidiBuffer midi;
+        auto& random = getRandom();
+
+        // Host block sizes vary, so do ours: odd, tiny and full-size blocks
+        const int blockSizes[] = { maxBlockSize, 1, 37, 64, 500 };
+        int nextBlockSize = 0;
+
+        auto& parameters = processor.getParameters();
+        auto& events = processor.getParameterEvents();
+
+        // With numEvents > 0, each block also carries that many sample-accurate changes to
+        // random parameters, queued just before processBlock like the renderer does
+        auto process = [&](int numBlocks, int numEvents)
+        {
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                const int numSamples = blockSizes[nextBlockSize++ % juce::numElementsInArray(blockSizes)];
+
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        buffer.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+                for (int e = 0; e < numEvents; ++e)
+                {
+                    const int index = random.nextInt(parameters.size());
+                    auto* ranged = static_cast<juce::RangedAudioParameter*>(parameters[index]);
+                    events.add(random.nextInt(numSamples), index, ranged->convertFrom0to1(random.nextFloat()));
+                }
+
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, numSamples);
+                processor.processBlock(block, midi);
+            }
+        };
+
+        // The spectral curve's FFTs are built off the audio thread once it is switched on
+        // (prepareToPlay, or the processor's timer, which doesn't run here); until then the
+        // curve passes audio through. Prepare again the first time it's on so the STFT runs.
+        auto* spectralSwitch = processor.getAPVTS().getParameter("spectralWidth");
+        bool spectralAllocated = false;
+
+        auto setParameters = [&](const std::function<float(juce::RangedAudioParameter&, int)>& valueFor, int numEvents)
+        {
+            for (int p = 0; p < parameters.size(); ++p)
+                if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameters[p]))
+                    ranged->setValueNotifyingHost(valueFor(*ranged, p));
+
+            if (! spectralAllocated && spectralSwitch->getValue() > 0.5f)
+            {
+                processor.prepareToPlay(sampleRate, maxBlockSize);
+                spectralAllocated = true;
+            }
+
+            process(4, numEvents);     // Parameter changes land in the first block, smoothing in the rest
+        };
+
+        process(4, 0);
+
+        // Every parameter at its minimum, default and maximum against every combination of
+        // the switches that pick a processing path
+        juce::StringArray switches;
+        for (auto* parameter : parameters)
+            if (auto* toggle = dynamic_cast<juce::AudioParameterBool*>(parameter))
+                switches.add(toggle->getParameterID());
+
+        for (int combination = 0; combination < (1 << switches.size()); ++combination)
+        {
+            for (int p = 0; p < parameters.size(); ++p)
+            {
+                for (int setting = 0; setting < 3; ++setting)
+                {
+                    setParameters([&](juce::RangedAudioParameter& parameter, int index)
+                    {
+                        const int switchIndex = switches.indexOf(parameter.getParameterID());
+                        if (switchIndex >= 0)
+                            return (combination >> switchIndex) & 1 ? 1.0f : 0.0f;
+                        if (index != p || setting == 1)
+                            return parameter.getDefaultValue();
+                        return setting == 0 ? 0.0f : 1.0f;
+                    }, 0);
+                }
+            }
+
+            // The same paths with parameter events splitting the blocks
+            setParameters([&](juce::RangedAudioParameter& parameter, int)
+            {
+                const int switchIndex = switches.indexOf(parameter.getParameterID());
+                if (switchIndex >= 0)
+                    return (combination >> switchIndex) & 1 ? 1.0f : 0.0f;
+                return parameter.getDefaultValue();
+            }, 8);
+        }
+
+        // Random combinations, with and without events
+        for (int i = 0; i < 500; ++i)
+            setParameters([&](juce::RangedAudioParameter&, int) { return random.nextFloat(); }, i % 2 == 0 ? 0 : 8);
+
+        processor.releaseResources();
+    }
+};
+
+static RealtimeSafetyTests realtimeSafetyTests;
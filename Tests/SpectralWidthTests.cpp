@@ -0,0 +1,197 @@
+#include <JuceHeader.h>
+#include "DSP/SpectralWidth.h"
+#include "TestSignals.h"
+
+// The STFT width curve at 100% everywhere must be a pure delay of its reported latency,
+// at every FFT size, and must pass audio straight through until it has been allocated.
+// A real curve must scale the side by the width at each frequency: nothing left of it at
+// 0%, twice it at 200%, reached by a glide once the curve changes, with the mid untouched.
+class SpectralWidthTests : public juce::UnitTest
+{
+public:
+    SpectralWidthTests() : juce::UnitTest("Spectral width", "StereoImager") {}
+
+    void runTest() override
+    {
+        const auto noise = TestSignals::makeNoise(1 << 16, getRandom());
+
+        for (int order = SpectralWidth::minOrder; order <= SpectralWidth::maxOrder; ++order)
+        {
+            beginTest("Flat curve is a delay at FFT size " + juce::String(1 << order));
+            checkFlat(noise, order);
+        }
+
+        beginTest("Passes through until allocated");
+        checkUnallocated(noise);
+
+        beginTest("Curve at 0% everywhere is mono");
+        checkMono(noise);
+
+        beginTest("Curve from 0% low to 200% high");
+        checkTilt(80.0f, 0.0f);
+        checkTilt(10000.0f, 2.0f);
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    // Largest difference between the processed noise and the noise delayed by the latency
+    static float runAgainstDelay(SpectralWidth& spectral, const juce::AudioBuffer<float>& noise)
+    {
+        const int latency = spectral.getLatencySamples();
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        float maxError = 0.0f;
+
+        for (int start = 0; start + blockSize <= noise.getNumSamples(); start += blockSize)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                buffer.copyFrom(ch, 0, noise, ch, start, blockSize);
+
+            spectral.process(buffer);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const int source = start + i - latency;
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    const float expected = source >= 0 ? noise.getSample(ch, source) : 0.0f;
+                    maxError = juce::jmax(maxError, std::abs(buffer.getSample(ch, i) - expected));
+                }
+            }
+        }
+
+        return maxError;
+    }
+
+    void checkFlat(const juce::AudioBuffer<float>& noise, int order)
+    {
+        SpectralWidth spectral;
+        spectral.prepare(sampleRate, blockSize);
+        spectral.allocate();
+        spectral.setFftOrder(order);
+        spectral.setEnabled(true);
+
+        expectEquals(spectral.getLatencySamples(), 1 << order);
+        expectLessThan(runAgainstDelay(spectral, noise), 1.0e-5f);
+    }
+
+    static void prepareAllocated(SpectralWidth& spectral)
+    {
+        spectral.prepare(sampleRate, blockSize);
+        spectral.allocate();
+        spectral.setFftOrder(11);
+        spectral.setEnabled(true);
+    }
+
+    void checkMono(const juce::AudioBuffer<float>& noise)
+    {
+        SpectralWidth spectral;
+        prepareAllocated(spectral);
+
+        for (int node = 0; node < SpectralWidth::numNodes; ++node)
+            spectral.setNode(node, 100.0f * static_cast<float>(node + 1), 0.0f);
+
+        const int latency = spectral.getLatencySamples();
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        float sideError = 0.0f, midError = 0.0f;
+
+        for (int start = 0; start + blockSize <= noise.getNumSamples(); start += blockSize)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                buffer.copyFrom(ch, 0, noise, ch, start, blockSize);
+
+            spectral.process(buffer);
+
+            // No side at all, while the mid is only delayed
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const int source = start + i - latency;
+                const float mid = source >= 0 ? (noise.getSample(0, source) + noise.getSample(1, source)) * 0.5f : 0.0f;
+                sideError = juce::jmax(sideError, std::abs(buffer.getSample(0, i) - buffer.getSample(1, i)));
+                midError = juce::jmax(midError, std::abs((buffer.getSample(0, i) + buffer.getSample(1, i)) * 0.5f - mid));
+            }
+        }
+
+        expectLessThan(sideError, 1.0e-4f);
+        expectLessThan(midError, 1.0e-5f);
+    }
+
+    // A sine in both mid and side through a flat curve that then changes to 0% up to
+    // 150 Hz and 200% from 4 kHz: the side's gain at the sine frequency glides from 1 to
+    // expectedGain, and the mid's stays 1
+    void checkTilt(float frequency, float expectedGain)
+    {
+        SpectralWidth spectral;
+        prepareAllocated(spectral);
+
+        const int latency = spectral.getLatencySamples();
+        const int change = 16 * blockSize;
+        const int numSamples = 160 * blockSize;
+        juce::AudioBuffer<float> buffer(2, numSamples);
+
+        // Left only: mid and side both a quarter of full scale
+        for (int i = 0; i < numSamples; ++i)
+        {
+            buffer.setSample(0, i, 0.5f * std::sin(juce::MathConstants<float>::twoPi * frequency * static_cast<float>(i / sampleRate)));
+            buffer.setSample(1, i, 0.0f);
+        }
+
+        const float tilt[SpectralWidth::numNodes][2] = { { 50.0f, 0.0f }, { 150.0f, 0.0f }, { 4000.0f, 200.0f },
+                                                         { 8000.0f, 200.0f }, { 16000.0f, 200.0f } };
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            if (start == change)
+                for (int node = 0; node < SpectralWidth::numNodes; ++node)
+                    spectral.setNode(node, tilt[node][0], tilt[node][1]);
+
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, start, blockSize);
+            spectral.process(block);
+        }
+
+        // RMS of the output mid and side against the input's (0.25 / sqrt 2) over a stretch
+        auto gains = [&buffer](int from, int length)
+        {
+            double midSquares = 0.0, sideSquares = 0.0;
+            for (int i = from; i < from + length; ++i)
+            {
+                const double mid = (buffer.getSample(0, i) + buffer.getSample(1, i)) * 0.5;
+                const double side = (buffer.getSample(0, i) - buffer.getSample(1, i)) * 0.5;
+                midSquares += mid * mid;
+                sideSquares += side * side;
+            }
+
+            const double input = 0.25 / std::sqrt(2.0);
+            return std::make_pair(static_cast<float>(std::sqrt(midSquares / length) / input),
+                                  static_cast<float>(std::sqrt(sideSquares / length) / input));
+        };
+
+        // Flat before the change; half a second after it (20 ms glide), on the curve
+        const auto before = gains(latency, change - latency);
+        expectWithinAbsoluteError(before.first, 1.0f, 0.01f);
+        expectWithinAbsoluteError(before.second, 1.0f, 0.01f);
+
+        const auto settled = gains(change + latency + 24000, 24000);
+        expectWithinAbsoluteError(settled.first, 1.0f, 0.01f);
+        expectWithinAbsoluteError(settled.second, expectedGain, 0.02f);
+
+        // On the way there in the first hops after the change, rather than a jump
+        const auto gliding = gains(change + latency, 1024);
+        expectGreaterThan(std::abs(gliding.second - 1.0f), 0.05f);
+        expectGreaterThan(std::abs(gliding.second - expectedGain), 0.05f);
+    }
+
+    void checkUnallocated(const juce::AudioBuffer<float>& noise)
+    {
+        SpectralWidth spectral;
+        spectral.prepare(sampleRate, blockSize);
+        spectral.setEnabled(true);
+        spectral.setNode(0, 100.0f, 0.0f);
+
+        expectEquals(spectral.getLatencySamples(), 0);
+        expectEquals(runAgainstDelay(spectral, noise), 0.0f);
+    }
+};
+
+static SpectralWidthTests spectralWidthTests;
@@ -0,0 +1,145 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// Saved state must bring back every parameter: from the compact format the plugin writes,
+// and from the XML that sessions saved before it. The compact format also brings back the
+// current program and the user morph slots. A state cut short must be turned away without
+// touching anything.
+class StateTests : public juce::UnitTest
+{
+public:
+    StateTests() : juce::UnitTest("State", "StereoImager") {}
+
+    void runTest() override
+    {
+        beginTest("Compact state round trip");
+        checkRoundTrip(false);
+
+        beginTest("XML sessions still load");
+        checkRoundTrip(true);
+
+        beginTest("Program and user slots round trip");
+        checkProgramAndSlots();
+
+        beginTest("First program choice recalls it");
+        checkFirstProgram();
+
+        beginTest("Truncated state is rejected");
+        checkTruncated();
+    }
+
+private:
+    void randomise(juce::AudioProcessor& processor)
+    {
+        auto& random = getRandom();
+        for (auto* param : processor.getParameters())
+            param->setValueNotifyingHost(random.nextFloat());
+    }
+
+    // Largest normalised difference between two instances' parameters
+    static float compareParameters(const juce::AudioProcessor& a, const juce::AudioProcessor& b)
+    {
+        const auto& paramsA = a.getParameters();
+        const auto& paramsB = b.getParameters();
+        float maxDifference = 0.0f;
+
+        for (int i = 0; i < paramsA.size(); ++i)
+            maxDifference = juce::jmax(maxDifference, std::abs(paramsA[i]->getValue() - paramsB[i]->getValue()));
+
+        return maxDifference;
+    }
+
+    void checkRoundTrip(bool xml)
+    {
+        StereoImagerAudioProcessor saved, loaded;
+        randomise(saved);
+
+        // Defaults aren't proof: start the loaded instance somewhere else as well
+        randomise(loaded);
+
+        juce::MemoryBlock state;
+
+        if (xml)
+        {
+            // What getStateInformation wrote before the compact format
+            std::unique_ptr<juce::XmlElement> element(saved.getAPVTS().copyState().createXml());
+            juce::AudioProcessor::copyXmlToBinary(*element, state);
+        }
+        else
+        {
+            saved.getStateInformation(state);
+        }
+
+        loaded.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        expectLessOrEqual(compareParameters(saved, loaded), 1.0e-6f);
+    }
+
+    // Largest difference between two instances' user slots, in parameter units
+    static float compareUserSlots(StereoImagerAudioProcessor& a, StereoImagerAudioProcessor& b)
+    {
+        std::vector<CompactState::Record> slotsA, slotsB;
+        a.getPresetBank().getUserSlotRecords(slotsA);
+        b.getPresetBank().getUserSlotRecords(slotsB);
+
+        if (slotsA.size() != slotsB.size())
+            return std::numeric_limits<float>::max();
+
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < slotsA.size(); ++i)
+            maxDifference = juce::jmax(maxDifference, std::abs(slotsA[i].value - slotsB[i].value));
+
+        return maxDifference;
+    }
+
+    void checkProgramAndSlots()
+    {
+        StereoImagerAudioProcessor saved, loaded;
+        saved.setCurrentProgram(3);
+
+        for (int slot = 0; slot < PresetBank::numUserSlots; ++slot)
+        {
+            randomise(saved);
+            saved.getPresetBank().storeUserSlot(slot);
+        }
+
+        juce::MemoryBlock state;
+        saved.getStateInformation(state);
+        loaded.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+        expectEquals(loaded.getCurrentProgram(), 3);
+        // Parameter units, so float rounding scales with the largest range (Hz)
+        expectLessOrEqual(compareUserSlots(saved, loaded), 0.01f);
+    }
+
+    void checkFirstProgram()
+    {
+        // Program 0 is Init: every preset-controlled parameter at its default
+        StereoImagerAudioProcessor processor;
+        processor.getAPVTS().getParameter("width")->setValueNotifyingHost(0.0f);
+        processor.setCurrentProgram(0);
+
+        auto* width = processor.getAPVTS().getParameter("width");
+        expectWithinAbsoluteError(width->getValue(), width->getDefaultValue(), 1.0e-6f);
+    }
+
+    void checkTruncated()
+    {
+        StereoImagerAudioProcessor saved, loaded, copy;
+        randomise(saved);
+        randomise(loaded);
+
+        // What the loaded instance holds before the bad state arrives
+        juce::MemoryBlock before;
+        loaded.getStateInformation(before);
+        copy.setStateInformation(before.getData(), static_cast<int>(before.getSize()));
+
+        // Missing its last record
+        juce::MemoryBlock state;
+        saved.getStateInformation(state);
+        loaded.setStateInformation(state.getData(), static_cast<int>(state.getSize()) - CompactState::recordSize);
+
+        expectLessOrEqual(compareParameters(loaded, copy), 1.0e-6f);
+    }
+};
+
+static StateTests stateTests;
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Signals shared by the tests. They take the test's random generator, so a run with
+// --seed N plays the same noise again.
+namespace TestSignals
+{
+    // Independent white noise on two channels, at half of full scale
+    inline juce::AudioBuffer<float> makeNoise(int numSamples, juce::Random& random)
+    {
+        juce::AudioBuffer<float> noise(2, numSamples);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                noise.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+        return noise;
+    }
+}
@@ -0,0 +1,187 @@
+// Offline stereo analyzer for QC.
+//
+// Reads audio files through memory-mapped windows (see MappedAudioFile.h) and writes
+// their stereo statistics as JSON (see StereoAnalysis.h): correlation distribution,
+// mid/side energy, per-band width and balance, time out of phase, and decimated series.
+//
+//   StereoImagerAnalyze --input in.wav | --batch dir|list.txt [--output report.json]
+//                       [--threads N] [--crossovers 250,4000] [--interval 1.0]
+//
+// One file gives one object; a batch gives {"files":[...]} in input order, with an
+// "error" entry for any file that couldn't be read. Files are analysed in parallel, one
+// analyser per worker (see BatchScheduler.h). Speed goes to stderr.
+
+#include <JuceHeader.h>
+#include "Analyze/StereoAnalysis.h"
+#include "Common/BatchScheduler.h"
+#include "Common/MappedAudioFile.h"
+
+namespace
+{
+    constexpr int chunk = 65536;
+
+    struct Worker
+    {
+        StereoAnalysis analysis;
+        juce::AudioBuffer<float> buffer { 2, chunk };
+    };
+
+    struct FileReport
+    {
+        juce::MemoryOutputStream json;
+        juce::int64 frames = 0;
+        double sampleRate = 0.0;
+        bool ok = false;
+    };
+
+    void analyseFile(Worker& worker, const juce::File& input, const StereoAnalysis::Settings& settings, FileReport& report)
+    {
+        MappedAudioFile::Reader reader;
+
+        if (! reader.open(input))
+        {
+            report.json << "{\"file\":\"" << juce::JSON::escapeString(input.getFileName()) << "\",\"error\":\"can't read\"}";
+            return;
+        }
+
+        const int fileChannels = juce::jmin(2, reader.getNumChannels());
+        const auto length = reader.getLengthInFrames();
+        auto& buffer = worker.buffer;
+
+        worker.analysis.prepare(reader.getSampleRate(), chunk, settings);
+
+        for (juce::int64 position = 0; position < length; position += chunk)
+        {
+            const int numFrames = static_cast<int>(juce::jmin<juce::int64>(chunk, length - position));
+
+            if (! reader.read(buffer.getArrayOfWritePointers(), fileChannels, position, numFrames))
+            {
+                report.json << "{\"file\":\"" << juce::JSON::escapeString(input.getFileName())
+                            << "\",\"error\":\"read failed at frame " << juce::String(position) << "\"}";
+                return;
+            }
+
+            // Mono analyses as two identical channels
+            const float* right = buffer.getReadPointer(fileChannels == 1 ? 0 : 1);
+            worker.analysis.process(buffer.getReadPointer(0), right, numFrames);
+        }
+
+        worker.analysis.writeJson(report.json, input.getFileName());
+        report.frames = length;
+        report.sampleRate = reader.getSampleRate();
+        report.ok = true;
+    }
+
+    juce::Array<juce::File> findInputs(const juce::ArgumentList& args)
+    {
+        juce::Array<juce::File> inputs;
+
+        if (args.containsOption("--input"))
+        {
+            inputs.add(args.getFileForOption("--input"));
+            return inputs;
+        }
+
+        return BatchScheduler::findInputs(args.getFileForOption("--batch"));
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (! args.containsOption("--input") && ! args.containsOption("--batch"))
+    {
+        std::fprintf(stderr, "Usage: StereoImagerAnalyze --input in.wav | --batch dir|list.txt [--output report.json]\n"
+                             "                           [--threads N] [--crossovers 250,4000] [--interval 1.0]\n");
+        return 2;
+    }
+
+    StereoAnalysis::Settings settings;
+
+    if (args.containsOption("--crossovers"))
+    {
+        const auto frequencies = args.getValueForOption("--crossovers");
+        settings.lowMidCrossover = frequencies.upToFirstOccurrenceOf(",", false, false).getFloatValue();
+        settings.midHighCrossover = frequencies.fromFirstOccurrenceOf(",", false, false).getFloatValue();
+
+        if (settings.lowMidCrossover <= 0.0f || settings.midHighCrossover <= settings.lowMidCrossover)
+        {
+            std::fprintf(stderr, "Bad --crossovers (low-mid,mid-high in Hz)\n");
+            return 2;
+        }
+    }
+
+    if (args.containsOption("--interval"))
+        settings.seriesInterval = juce::jmax(0.05, args.getValueForOption("--interval").getDoubleValue());
+
+    const auto inputs = findInputs(args);
+    if (inputs.isEmpty())
+    {
+        std::fprintf(stderr, "No audio files to analyse\n");
+        return 1;
+    }
+
+    const int defaultThreads = juce::jmax(1, juce::SystemStats::getNumPhysicalCpus());
+    const int numWorkers = juce::jlimit(1, inputs.size(),
+                                        args.containsOption("--threads") ? args.getValueForOption("--threads").getIntValue() : defaultThreads);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back(std::make_unique<Worker>());
+
+    std::vector<juce::int64> costs;
+    for (auto& input : inputs)
+        costs.push_back(input.getSize());
+
+    std::vector<FileReport> reports(static_cast<size_t>(inputs.size()));
+    BatchScheduler scheduler;
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    scheduler.run(numWorkers, costs, [&](int worker, int job)
+    {
+        analyseFile(*workers[static_cast<size_t>(worker)], inputs.getReference(job), settings, reports[static_cast<size_t>(job)]);
+    });
+
+    const double seconds = juce::jmax(1.0e-9, (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001);
+
+    juce::MemoryOutputStream json;
+    const bool batch = ! args.containsOption("--input");
+    double audioSeconds = 0.0;
+    int failures = 0;
+
+    json << (batch ? "{\"files\":[" : "");
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        auto& report = reports[i];
+        json << (i == 0 ? "" : ",\n") << report.json.toString();
+
+        if (report.ok)
+            audioSeconds += static_cast<double>(report.frames) / report.sampleRate;
+        else
+            ++failures;
+    }
+    json << (batch ? "]}\n" : "\n");
+
+    if (args.containsOption("--output"))
+    {
+        const auto output = args.getFileForOption("--output");
+        if (! output.replaceWithData(json.getData(), json.getDataSize()))
+        {
+            std::fprintf(stderr, "Can't write %s\n", output.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+    else
+    {
+        std::fwrite(json.getData(), 1, json.getDataSize(), stdout);
+    }
+
+    std::fprintf(stderr, "StereoImagerAnalyze: %d of %d files, %.1f s of audio in %.2f s on %d worker%s, %.1fx real time\n",
+                 inputs.size() - failures, inputs.size(), audioSeconds, seconds, numWorkers, numWorkers == 1 ? "" : "s",
+                 audioSeconds / seconds);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+#include "Analyze/StereoAnalysis.h"
+#include <numeric>
+
+namespace
+{
+    // -80 dBFS RMS per channel
+    constexpr double silenceEnergyPerSample = 2.0e-8;
+
+    // Past this the side is all there is (an inverted copy would be infinitely wide)
+    constexpr double maxWidth = 1000.0;
+
+    const char* const bandNames[StereoAnalysis::numBands] = { "low", "mid", "high" };
+
+    double getMidEnergy(const std::array<double, 3>& sums)  { return std::max(0.0, 0.25 * (sums[1] + 2.0 * sums[0] + sums[2])); }
+    double getSideEnergy(const std::array<double, 3>& sums) { return std::max(0.0, 0.25 * (sums[1] - 2.0 * sums[0] + sums[2])); }
+
+    double toDb(double energy) { return 10.0 * std::log10(std::max(energy, 1.0e-20)); }
+
+    // Fixed decimals without the trailing zeros, or null for NaN and infinities
+    juce::String number(double value, int decimals)
+    {
+        if (! std::isfinite(value))
+            return "null";
+
+        auto text = juce::String(value, decimals);
+
+        if (text.containsChar('.'))
+        {
+            text = text.trimCharactersAtEnd("0");
+            if (text.endsWith("."))
+                text = text.dropLastCharacters(1);
+        }
+
+        return text == "-0" ? juce::String("0") : text;
+    }
+
+    void writeArray(juce::OutputStream& out, const std::vector<float>& values, int decimals)
+    {
+        out << "[";
+        for (size_t i = 0; i < values.size(); ++i)
+            out << (i == 0 ? "" : ",") << number(values[i], decimals);
+        out << "]";
+    }
+}
+
+void StereoAnalysis::prepare(double newSampleRate, int maxBlockSize, const Settings& newSettings)
+{
+    settings = newSettings;
+    sampleRate = newSampleRate;
+    kernels = &Kernels::getBestTable();
+
+    lowMidSplit.prepare(sampleRate, settings.lowMidCrossover);
+    midHighSplit.prepare(sampleRate, settings.midHighCrossover);
+
+    for (auto* band : { &lowL, &lowR, &midL, &midR, &highL, &highR })
+        band->resize(static_cast<size_t>(maxBlockSize));
+
+    window = {};
+    bandWindow = {};
+    windowFill = 0;
+
+    pointSums = {};
+    totalSums = {};
+    pointBandSums = {};
+    totalBandSums = {};
+    pointWindows = 0;
+    windowsPerPoint = juce::jmax(1, juce::roundToInt(settings.seriesInterval * sampleRate / windowSize));
+
+    numSamplesSeen = 0;
+    numWindows = 0;
+    numSilentWindows = 0;
+    numOutOfPhaseWindows = 0;
+    windowCorrelations.clear();
+    histogram = {};
+
+    seriesCorrelation.clear();
+    seriesSideToMid.clear();
+    for (auto& series : seriesBandWidth)
+        series.clear();
+}
+
+void StereoAnalysis::process(const float* left, const float* right, int numSamples)
+{
+    jassert(numSamples <= static_cast<int>(lowL.size()));
+
+    lowMidSplit.process(left, right, lowL.data(), lowR.data(), midL.data(), midR.data(), numSamples);
+    midHighSplit.process(midL.data(), midR.data(), midL.data(), midR.data(), highL.data(), highR.data(), numSamples);
+
+    const float* bandLeft[numBands] = { lowL.data(), midL.data(), highL.data() };
+    const float* bandRight[numBands] = { lowR.data(), midR.data(), highR.data() };
+
+    accumulate(left, right, bandLeft, bandRight, numSamples);
+    numSamplesSeen += numSamples;
+}
+
+void StereoAnalysis::accumulate(const float* left, const float* right, const float* const* bandLeft,
+                                const float* const* bandRight, int numSamples)
+{
+    // In runs that stop at each window boundary, as the correlation meter does
+    for (int i = 0; i < numSamples;)
+    {
+        const int run = std::min(numSamples - i, windowSize - windowFill);
+
+        kernels->correlationSums(left + i, right + i, run, window.data());
+        for (int band = 0; band < numBands; ++band)
+            kernels->correlationSums(bandLeft[band] + i, bandRight[band] + i, run, bandWindow[static_cast<size_t>(band)].data());
+
+        windowFill += run;
+        i += run;
+
+        if (windowFill == windowSize)
+            finishWindow();
+    }
+}
+
+void StereoAnalysis::finishWindow()
+{
+    if (windowFill == 0)
+        return;
+
+    const Sums sums { window[0], window[1], window[2] };
+
+    for (size_t k = 0; k < sums.size(); ++k)
+    {
+        pointSums[k] += sums[k];
+        totalSums[k] += sums[k];
+
+        for (size_t band = 0; band < numBands; ++band)
+        {
+            pointBandSums[band][k] += bandWindow[band][k];
+            totalBandSums[band][k] += bandWindow[band][k];
+        }
+    }
+
+    ++numWindows;
+
+    if (sums[1] + sums[2] < silenceEnergyPerSample * windowFill)
+    {
+        ++numSilentWindows;
+    }
+    else
+    {
+        const auto correlation = static_cast<float>(getCorrelation(sums));
+        windowCorrelations.push_back(correlation);
+        ++histogram[static_cast<size_t>(juce::jlimit(0, numHistogramBins - 1, static_cast<int>((correlation + 1.0f) * 0.5f * numHistogramBins)))];
+
+        if (correlation < 0.0f)
+            ++numOutOfPhaseWindows;
+    }
+
+    window = {};
+    bandWindow = {};
+    windowFill = 0;
+
+    if (++pointWindows == windowsPerPoint)
+        finishSeriesPoint();
+}
+
+void StereoAnalysis::finishSeriesPoint()
+{
+    if (pointWindows == 0)
+        return;
+
+    seriesCorrelation.push_back(static_cast<float>(getCorrelation(pointSums)));
+    seriesSideToMid.push_back(static_cast<float>(getSideToMidDb(pointSums)));
+
+    for (size_t band = 0; band < numBands; ++band)
+        seriesBandWidth[band].push_back(static_cast<float>(getWidth(pointBandSums[band])));
+
+    pointSums = {};
+    pointBandSums = {};
+    pointWindows = 0;
+}
+
+double StereoAnalysis::getCorrelation(const Sums& sums)
+{
+    // One silent channel shares nothing with the other
+    const double denom = std::sqrt(sums[1] * sums[2]);
+    return denom > 1.0e-20 ? juce::jlimit(-1.0, 1.0, sums[0] / denom) : 0.0;
+}
+
+double StereoAnalysis::getSideToMidDb(const Sums& sums)
+{
+    return juce::jlimit(-100.0, 100.0, toDb(getSideEnergy(sums)) - toDb(getMidEnergy(sums)));
+}
+
+double StereoAnalysis::getWidth(const Sums& sums)
+{
+    const double mid = getMidEnergy(sums);
+    const double side = getSideEnergy(sums);
+
+    if (mid <= 1.0e-20)
+        return side <= 1.0e-20 ? 0.0 : maxWidth;
+
+    return std::min(maxWidth, 100.0 * std::sqrt(side / mid));
+}
+
+void StereoAnalysis::writeJson(juce::OutputStream& out, const juce::String& fileName)
+{
+    finishWindow();
+    finishSeriesPoint();
+
+    const double numSamples = static_cast<double>(juce::jmax<juce::int64>(1, numSamplesSeen));
+    const double percentPerWindow = 100.0 / juce::jmax(1, numWindows);
+
+    out << "{\"file\":\"" << juce::JSON::escapeString(fileName) << "\""
+        << ",\"sampleRate\":" << number(sampleRate, 0)
+        << ",\"seconds\":" << number(static_cast<double>(numSamplesSeen) / sampleRate, 3);
+
+    // Correlation: energy-weighted over the file, then over the non-silent windows
+    out << ",\"correlation\":{\"mean\":" << number(getCorrelation(totalSums), 3);
+
+    if (windowCorrelations.empty())
+    {
+        out << ",\"windowMean\":null,\"min\":null,\"p5\":null,\"median\":null,\"p95\":null";
+    }
+    else
+    {
+        auto& sorted = windowCorrelations;
+        std::sort(sorted.begin(), sorted.end());
+
+        auto percentile = [&sorted](double p)
+        {
+            return static_cast<double>(sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5)]);
+        };
+
+        const double sum = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+
+        out << ",\"windowMean\":" << number(sum / static_cast<double>(sorted.size()), 3)
+            << ",\"min\":" << number(sorted.front(), 3)
+            << ",\"p5\":" << number(percentile(0.05), 3)
+            << ",\"median\":" << number(percentile(0.5), 3)
+            << ",\"p95\":" << number(percentile(0.95), 3);
+    }
+
+    out << ",\"histogram\":[";
+    for (int bin = 0; bin < numHistogramBins; ++bin)
+        out << (bin == 0 ? "" : ",") << histogram[static_cast<size_t>(bin)];
+    out << "]}";
+
+    out << ",\"outOfPhasePercent\":" << number(numOutOfPhaseWindows * percentPerWindow, 2)
+        << ",\"silentPercent\":" << number(numSilentWindows * percentPerWindow, 2);
+
+    out << ",\"midSide\":{\"midDb\":" << number(toDb(getMidEnergy(totalSums) / numSamples), 2)
+        << ",\"sideDb\":" << number(toDb(getSideEnergy(totalSums) / numSamples), 2)
+        << ",\"sideToMidDb\":" << number(getSideToMidDb(totalSums), 2)
+        << ",\"width\":" << number(getWidth(totalSums), 1) << "}";
+
+    // Band balance: each band's share of the summed band energy
+    double bandEnergyTotal = 0.0;
+    for (auto& sums : totalBandSums)
+        bandEnergyTotal += sums[1] + sums[2];
+
+    const double edges[numBands + 1] = { 0.0, settings.lowMidCrossover, settings.midHighCrossover, sampleRate / 2.0 };
+
+    out << ",\"bands\":[";
+    for (size_t band = 0; band < numBands; ++band)
+    {
+        const auto& sums = totalBandSums[band];
+        out << (band == 0 ? "" : ",")
+            << "{\"name\":\"" << bandNames[band] << "\""
+            << ",\"from\":" << number(edges[band], 0) << ",\"to\":" << number(edges[band + 1], 0)
+            << ",\"energyPercent\":" << number(bandEnergyTotal > 0.0 ? 100.0 * (sums[1] + sums[2]) / bandEnergyTotal : 0.0, 2)
+            << ",\"correlation\":" << number(getCorrelation(sums), 3)
+            << ",\"sideToMidDb\":" << number(getSideToMidDb(sums), 2)
+            << ",\"width\":" << number(getWidth(sums), 1) << "}";
+    }
+    out << "]";
+
+    out << ",\"series\":{\"interval\":" << number(windowsPerPoint * windowSize / sampleRate, 4)
+        << ",\"correlation\":";
+    writeArray(out, seriesCorrelation, 2);
+    out << ",\"sideToMidDb\":";
+    writeArray(out, seriesSideToMid, 1);
+    out << ",\"width\":{";
+    for (size_t band = 0; band < numBands; ++band)
+    {
+        out << (band == 0 ? "" : ",") << "\"" << bandNames[band] << "\":";
+        writeArray(out, seriesBandWidth[band], 0);
+    }
+    out << "}}}";
+}
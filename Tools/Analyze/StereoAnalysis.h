@@ -0,0 +1,88 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSP/Crossover.h"
+#include "DSP/Kernels.h"
+
+// Whole-file stereo statistics, from the same kernels as the plugin's meters.
+//
+// The signal is cut into windows (2048 samples, as the correlation meter) and split
+// into low, mid and high bands by the multiband processor's LR4 crossovers. Each window
+// gives a correlation; silent windows (below -80 dBFS) are left out of the correlation
+// figures. Energies are summed over the whole file, and over every series interval
+// for the time-decimated series.
+//
+// Width is 100 * sqrt(side energy / mid energy): 0% for mono, 100% when the side
+// carries as much as the mid (uncorrelated channels at equal level), above that when
+// the channels lean out of phase.
+class StereoAnalysis
+{
+public:
+    struct Settings
+    {
+        float lowMidCrossover = 250.0f;
+        float midHighCrossover = 4000.0f;
+        double seriesInterval = 1.0;        // Seconds per series point
+    };
+
+    StereoAnalysis() = default;
+
+    // Clears everything from the last file; buffers are only reallocated when they grow
+    void prepare(double sampleRate, int maxBlockSize, const Settings& newSettings);
+    void process(const float* left, const float* right, int numSamples);
+
+    // Finishes the part-filled window and series point and writes the report as one
+    // JSON object
+    void writeJson(juce::OutputStream& out, const juce::String& fileName);
+
+    static constexpr int windowSize = 2048;
+    static constexpr int numBands = 3;
+    static constexpr int numHistogramBins = 20;     // 0.1 wide, -1 to 1
+
+private:
+    // sum L*R, L^2, R^2 (the correlationSums layout)
+    using Sums = std::array<double, 3>;
+    using WindowSums = std::array<float, 3>;
+
+    void accumulate(const float* left, const float* right, const float* const* bandLeft,
+                    const float* const* bandRight, int numSamples);
+    void finishWindow();
+    void finishSeriesPoint();
+
+    static double getCorrelation(const Sums& sums);
+    static double getSideToMidDb(const Sums& sums);
+    static double getWidth(const Sums& sums);
+
+    Settings settings;
+    double sampleRate = 44100.0;
+    const Kernels::Table* kernels = nullptr;
+
+    // Bands as the multiband processor splits them: low off the input, then mid and high
+    // off the rest
+    LR4Crossover lowMidSplit, midHighSplit;
+    std::vector<float> lowL, lowR, midL, midR, highL, highR;
+
+    // Current window, full band then each band
+    WindowSums window {};
+    std::array<WindowSums, numBands> bandWindow {};
+    int windowFill = 0;
+
+    // Current series point and the whole file
+    Sums pointSums {}, totalSums {};
+    std::array<Sums, numBands> pointBandSums {}, totalBandSums {};
+    int pointWindows = 0;
+    int windowsPerPoint = 1;
+
+    juce::int64 numSamplesSeen = 0;
+    int numWindows = 0;
+    int numSilentWindows = 0;
+    int numOutOfPhaseWindows = 0;
+    std::vector<float> windowCorrelations;          // Non-silent windows only
+    std::array<int, numHistogramBins> histogram {};
+
+    // Series, one entry per point
+    std::vector<float> seriesCorrelation, seriesSideToMid;
+    std::array<std::vector<float>, numBands> seriesBandWidth;
+
+    JUCE_DECLARE_NON_COPYABLE(StereoAnalysis)
+};
@@ -0,0 +1,121 @@
+#include "Common/BatchScheduler.h"
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+juce::Array<juce::File> BatchScheduler::findInputs(const juce::File& directoryOrList)
+{
+    juce::Array<juce::File> inputs;
+
+    if (directoryOrList.isDirectory())
+    {
+        inputs = directoryOrList.findChildFiles(juce::File::findFiles, false, "*.wav;*.wave;*.aif;*.aiff;*.flac");
+        inputs.sort();
+        return inputs;
+    }
+
+    juce::StringArray lines;
+    directoryOrList.readLines(lines);
+
+    for (auto& line : lines)
+        if (line.trim().isNotEmpty())
+            inputs.add(directoryOrList.getParentDirectory().getChildFile(line.trim()));
+
+    return inputs;
+}
+
+void BatchScheduler::run(int numWorkers, const std::vector<juce::int64>& costs, const Job& job)
+{
+    jassert(numWorkers > 0);
+
+    jobCosts = costs;
+    workers = std::vector<Worker>(static_cast<size_t>(numWorkers));
+
+    std::vector<int> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&costs](int a, int b) { return costs[static_cast<size_t>(a)] > costs[static_cast<size_t>(b)]; });
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        auto& worker = workers[i % workers.size()];
+        worker.queue.push_back(order[i]);
+        worker.queuedCost += costs[static_cast<size_t>(order[i])];
+    }
+
+    // Nothing is ever added once running, so a worker that finds every queue empty is done
+    auto workerLoop = [this, &job](int workerIndex)
+    {
+        auto& self = workers[static_cast<size_t>(workerIndex)];
+        int jobIndex = -1;
+
+        while (popOwn(self, jobIndex) || steal(workerIndex, jobIndex))
+        {
+            const auto startMs = juce::Time::getMillisecondCounterHiRes();
+            job(workerIndex, jobIndex);
+            self.busySeconds += (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(numWorkers - 1));
+
+    for (int i = 1; i < numWorkers; ++i)
+        threads.emplace_back(workerLoop, i);
+
+    workerLoop(0);
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+bool BatchScheduler::popOwn(Worker& worker, int& jobIndex)
+{
+    const std::lock_guard<std::mutex> guard(worker.lock);
+
+    if (worker.queue.empty())
+        return false;
+
+    jobIndex = worker.queue.front();
+    worker.queue.pop_front();
+    worker.queuedCost -= jobCosts[static_cast<size_t>(jobIndex)];
+    return true;
+}
+
+bool BatchScheduler::steal(int thiefIndex, int& jobIndex)
+{
+    // Keep trying while any queue has work: the chosen victim may empty in between
+    for (;;)
+    {
+        int victim = -1;
+        juce::int64 mostCost = -1;
+        bool anyQueued = false;
+
+        for (int i = 0; i < static_cast<int>(workers.size()); ++i)
+        {
+            if (i == thiefIndex)
+                continue;
+
+            auto& worker = workers[static_cast<size_t>(i)];
+            const std::lock_guard<std::mutex> guard(worker.lock);
+
+            if (worker.queue.empty())
+                continue;
+
+            anyQueued = true;
+            if (worker.queuedCost > mostCost)
+            {
+                mostCost = worker.queuedCost;
+                victim = i;
+            }
+        }
+
+        if (! anyQueued)
+            return false;
+
+        if (popOwn(workers[static_cast<size_t>(victim)], jobIndex))
+        {
+            ++workers[static_cast<size_t>(thiefIndex)].stolen;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// Runs a list of jobs on a fixed set of worker threads with work stealing.
+//
+// Jobs are dealt round-robin, longest first, into one deque per worker. A worker takes
+// from the front of its own deque; when that runs dry it steals the front (the longest
+// job still waiting) of whichever deque has the most work left. Starting the long jobs
+// first and stealing them early keeps a few very long files from landing at the end
+// of one queue and leaving the other workers idle.
+class BatchScheduler
+{
+public:
+    // job(workerIndex, jobIndex): each worker owns its own state, indexed by workerIndex
+    using Job = std::function<void(int workerIndex, int jobIndex)>;
+
+    BatchScheduler() = default;
+
+    // Audio files directly in a directory, or listed one per line in a text file
+    // (relative to the list), for --batch
+    static juce::Array<juce::File> findInputs(const juce::File& directoryOrList);
+
+    // costs[i] is any measure of job i's length (frames, bytes); only the order matters
+    void run(int numWorkers, const std::vector<juce::int64>& costs, const Job& job);
+
+    // Seconds each worker of the last run spent inside jobs, and how many it stole
+    double getBusySeconds(int workerIndex) const { return workers[static_cast<size_t>(workerIndex)].busySeconds; }
+    int getNumStolen(int workerIndex) const { return workers[static_cast<size_t>(workerIndex)].stolen; }
+
+private:
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<int> queue;
+        juce::int64 queuedCost = 0;       // Sum of the costs still in queue, guarded by lock
+        double busySeconds = 0.0;
+        int stolen = 0;
+    };
+
+    bool popOwn(Worker& worker, int& jobIndex);
+    bool steal(int thiefIndex, int& jobIndex);
+
+    std::vector<juce::int64> jobCosts;
+    std::vector<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE(BatchScheduler)
+};
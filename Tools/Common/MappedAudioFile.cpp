@@ -0,0 +1,162 @@
+#include "Common/MappedAudioFile.h"
+
+namespace MappedAudioFile
+{
+    //==============================================================================
+    bool Reader::open(const juce::File& file)
+    {
+        reader.reset();
+        mappedReader = nullptr;
+
+        juce::WavAudioFormat wav;
+        juce::AiffAudioFormat aiff;
+
+        for (juce::AudioFormat* format : { static_cast<juce::AudioFormat*>(&wav), static_cast<juce::AudioFormat*>(&aiff) })
+        {
+            if (! format->canHandleFile(file))
+                continue;
+
+            if (auto* mapped = format->createMemoryMappedReader(file))
+            {
+                mappedReader = mapped;
+                reader.reset(mapped);
+                return true;
+            }
+        }
+
+        // Not mappable: stream it instead
+        if (formats.getNumKnownFormats() == 0)
+            formats.registerBasicFormats();
+
+        reader.reset(formats.createReaderFor(file));
+        return reader != nullptr;
+    }
+
+    bool Reader::read(float* const* channels, int numChannels, juce::int64 startFrame, int numFrames)
+    {
+        jassert(reader != nullptr && numChannels <= getNumChannels());
+
+        const auto length = getLengthInFrames();
+        const int available = static_cast<int>(juce::jlimit<juce::int64>(0, numFrames, length - startFrame));
+
+        if (available > 0)
+        {
+            if (mappedReader != nullptr)
+            {
+                // Move the window on when this chunk leaves it; the old pages are unmapped
+                const juce::Range<juce::int64> needed(startFrame, startFrame + available);
+
+                if (! mappedReader->getMappedSection().contains(needed))
+                {
+                    const auto end = juce::jmin(length, startFrame + juce::jmax<juce::int64>(windowFrames, available));
+                    if (! mappedReader->mapSectionOfFile({ startFrame, end }))
+                        return false;
+                }
+            }
+
+            if (! reader->read(channels, numChannels, startFrame, available))
+                return false;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::fill(channels[ch] + available, channels[ch] + numFrames, 0.0f);
+
+        return true;
+    }
+
+    //==============================================================================
+    bool Writer::create(const juce::File& fileToCreate, double sampleRate, int channels,
+                        PcmFormat::Type sampleFormat, juce::int64 numFrames)
+    {
+        window.reset();
+        file = fileToCreate;
+        format = sampleFormat;
+        numChannels = channels;
+        frameBytes = numChannels * PcmFormat::getBytesPerSample(format);
+        totalFrames = numFrames;
+
+        const juce::int64 dataBytes = numFrames * frameBytes;
+        const juce::int64 riffBytes = headerBytes - 8 + dataBytes;
+        const bool isRF64 = riffBytes > 0xffffffffLL;
+
+        file.deleteFile();
+        juce::FileOutputStream out(file);
+        if (out.failedToOpen())
+            return false;
+
+        auto writeId = [&out](const char* id) { out.write(id, 4); };
+        auto writeSize32 = [&out](juce::int64 size) { out.writeInt(static_cast<int>(static_cast<juce::uint32>(size))); };
+
+        // The ds64 chunk is there either way (as JUNK in a plain WAV), so the data always
+        // starts at headerBytes
+        writeId(isRF64 ? "RF64" : "RIFF");
+        writeSize32(isRF64 ? 0xffffffffLL : riffBytes);
+        writeId("WAVE");
+
+        writeId(isRF64 ? "ds64" : "JUNK");
+        out.writeInt(28);
+        out.writeInt64(isRF64 ? riffBytes : 0);
+        out.writeInt64(isRF64 ? dataBytes : 0);
+        out.writeInt64(isRF64 ? numFrames : 0);
+        out.writeInt(0);                                        // No table entries
+
+        writeId("fmt ");
+        out.writeInt(16);
+        out.writeShort(format == PcmFormat::Type::F32 ? 3 : 1);    // IEEE float or PCM
+        out.writeShort(static_cast<short>(numChannels));
+        out.writeInt(juce::roundToInt(sampleRate));
+        out.writeInt(juce::roundToInt(sampleRate) * frameBytes);
+        out.writeShort(static_cast<short>(frameBytes));
+        out.writeShort(static_cast<short>(8 * PcmFormat::getBytesPerSample(format)));
+
+        writeId("data");
+        writeSize32(isRF64 ? 0xffffffffLL : dataBytes);
+        jassert(out.getPosition() == headerBytes);
+
+        // Size the file now so the data can be mapped (sparse until written)
+        if (dataBytes > 0)
+        {
+            out.setPosition(headerBytes + dataBytes - 1);
+            out.writeByte(0);
+        }
+
+        out.flush();
+        return out.getStatus().wasOk();
+    }
+
+    bool Writer::mapWindowFor(juce::int64 startFrame, int numFrames)
+    {
+        if (window != nullptr && windowRange.contains({ startFrame, startFrame + numFrames }))
+            return true;
+
+        // Unmap the old window first, so only one is ever resident
+        window.reset();
+
+        const auto end = juce::jmin(totalFrames, startFrame + juce::jmax<juce::int64>(windowFrames, numFrames));
+        const juce::Range<juce::int64> bytes(headerBytes + startFrame * frameBytes, headerBytes + end * frameBytes);
+        window = std::make_unique<juce::MemoryMappedFile>(file, bytes, juce::MemoryMappedFile::readWrite);
+
+        if (window->getData() == nullptr)
+        {
+            window.reset();
+            return false;
+        }
+
+        windowRange = { startFrame, end };
+        return true;
+    }
+
+    bool Writer::write(const float* const* channels, juce::int64 startFrame, int numFrames)
+    {
+        if (numFrames <= 0)
+            return true;
+
+        if (startFrame + numFrames > totalFrames || ! mapWindowFor(startFrame, numFrames))
+            return false;
+
+        // The mapping starts on a page boundary at or before the bytes asked for
+        const auto offset = headerBytes + startFrame * frameBytes - window->getRange().getStart();
+        PcmFormat::interleave(format, channels, numChannels, numFrames, static_cast<char*>(window->getData()) + offset);
+        return true;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Common/PcmFormat.h"
+
+// Memory-mapped audio file I/O for offline rendering.
+//
+// Both sides map a window of the file around the frames being processed and move it
+// along in large steps, rather than mapping the whole file or reading it into buffers.
+// Samples are converted straight between the mapped frames and the caller's float
+// channels, and pages left behind are unmapped, so resident memory stays at about one
+// window whatever the file length.
+namespace MappedAudioFile
+{
+    static constexpr juce::int64 windowFrames = 1 << 20;
+
+    // WAV, RF64 and AIFF are mapped (juce::MemoryMappedAudioFormatReader); anything else
+    // JUCE can read falls back to a streaming reader, still a chunk at a time.
+    class Reader
+    {
+    public:
+        Reader() = default;
+
+        bool open(const juce::File& file);
+
+        bool isMapped() const { return mappedReader != nullptr; }
+        double getSampleRate() const { return reader->sampleRate; }
+        int getNumChannels() const { return static_cast<int>(reader->numChannels); }
+        juce::int64 getLengthInFrames() const { return reader->lengthInSamples; }
+        int getBitsPerSample() const { return static_cast<int>(reader->bitsPerSample); }
+        bool isFloatingPoint() const { return reader->usesFloatingPointData; }
+
+        // Converts numFrames from startFrame into the first numChannels of channels;
+        // frames past the end read as silence
+        bool read(float* const* channels, int numChannels, juce::int64 startFrame, int numFrames);
+
+    private:
+        juce::AudioFormatManager formats;
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        juce::MemoryMappedAudioFormatReader* mappedReader = nullptr;   // reader, when it's mapped
+
+        JUCE_DECLARE_NON_COPYABLE(Reader)
+    };
+
+    // Writes a WAV file of known length through a mapped window. The header is written
+    // and the file sized up front; it becomes RF64 when the data passes 4 GB.
+    class Writer
+    {
+    public:
+        Writer() = default;
+
+        bool create(const juce::File& file, double sampleRate, int numChannels,
+                    PcmFormat::Type format, juce::int64 numFrames);
+
+        // Frames may arrive in any order, but the window only moves forward cheaply
+        bool write(const float* const* channels, juce::int64 startFrame, int numFrames);
+
+    private:
+        bool mapWindowFor(juce::int64 startFrame, int numFrames);
+
+        juce::File file;
+        PcmFormat::Type format = PcmFormat::Type::F32;
+        int numChannels = 0;
+        int frameBytes = 0;
+        juce::int64 totalFrames = 0;
+
+        std::unique_ptr<juce::MemoryMappedFile> window;
+        juce::Range<juce::int64> windowRange;    // Frames covered by window
+
+        static constexpr juce::int64 headerBytes = 80;      // RIFF/RF64, ds64 or JUNK, fmt, data
+
+        JUCE_DECLARE_NON_COPYABLE(Writer)
+    };
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstring>
+
+// Raw interleaved little-endian PCM, converted straight to and from the processor's
+// channel buffers: one pass does the format conversion and the (de)interleave, so there
+// is no intermediate interleaved float copy.
+namespace PcmFormat
+{
+    enum class Type
+    {
+        S16,
+        S24,        // Packed, 3 bytes per sample
+        F32
+    };
+
+    inline int getBytesPerSample(Type type)
+    {
+        switch (type)
+        {
+            case Type::S16: return 2;
+            case Type::S24: return 3;
+            case Type::F32: return 4;
+        }
+
+        return 4;
+    }
+
+    inline const char* getName(Type type)
+    {
+        switch (type)
+        {
+            case Type::S16: return "s16";
+            case Type::S24: return "s24";
+            case Type::F32: return "f32";
+        }
+
+        return "";
+    }
+
+    // "s16le", "s24le" and "f32le" are accepted too, as ffmpeg spells them
+    inline bool parse(juce::String name, Type& type)
+    {
+        name = name.toLowerCase();
+        if (name.endsWith("le"))
+            name = name.dropLastCharacters(2);
+
+        if (name == "s16") { type = Type::S16; return true; }
+        if (name == "s24") { type = Type::S24; return true; }
+        if (name == "f32") { type = Type::F32; return true; }
+        return false;
+    }
+
+    // numFrames interleaved frames of numChannels into separate channels
+    inline void deinterleave(Type type, const char* source, float* const* channels, int numChannels, int numFrames)
+    {
+        const int frameBytes = numChannels * getBytesPerSample(type);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const char* in = source + ch * getBytesPerSample(type);
+            float* out = channels[ch];
+
+            switch (type)
+            {
+                case Type::S16:
+                    for (int i = 0; i < numFrames; ++i)
+                    {
+                        juce::int16 sample;
+                        std::memcpy(&sample, in + i * frameBytes, sizeof(sample));
+                        out[i] = static_cast<float>(sample) * (1.0f / 32767.0f);
+                    }
+                    break;
+
+                case Type::S24:
+                    for (int i = 0; i < numFrames; ++i)
+                    {
+                        const auto* bytes = reinterpret_cast<const juce::uint8*>(in + i * frameBytes);
+                        const auto packed = static_cast<juce::uint32>(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16));
+                        const auto sample = static_cast<juce::int32>(packed << 8) >> 8;    // Sign-extend
+                        out[i] = static_cast<float>(sample) * (1.0f / 8388607.0f);
+                    }
+                    break;
+
+                case Type::F32:
+                    for (int i = 0; i < numFrames; ++i)
+                        std::memcpy(out + i, in + i * frameBytes, sizeof(float));
+                    break;
+            }
+        }
+    }
+
+    // Separate channels into numFrames interleaved frames. Integer formats are clipped
+    // and rounded; float is passed through. Integers scale by the same full-scale value
+    // both ways, so an unprocessed integer stream comes back bit for bit (bar the most
+    // negative code, which clips to one above).
+    inline void interleave(Type type, const float* const* channels, int numChannels, int numFrames, char* dest)
+    {
+        const int frameBytes = numChannels * getBytesPerSample(type);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* in = channels[ch];
+            char* out = dest + ch * getBytesPerSample(type);
+
+            switch (type)
+            {
+                case Type::S16:
+                    for (int i = 0; i < numFrames; ++i)
+                    {
+                        const auto sample = static_cast<juce::int16>(std::lrint(std::clamp(in[i], -1.0f, 1.0f) * 32767.0f));
+                        std::memcpy(out + i * frameBytes, &sample, sizeof(sample));
+                    }
+                    break;
+
+                case Type::S24:
+                    for (int i = 0; i < numFrames; ++i)
+                    {
+                        const auto sample = static_cast<juce::int32>(std::lrint(std::clamp(in[i], -1.0f, 1.0f) * 8388607.0f));
+                        auto* bytes = reinterpret_cast<juce::uint8*>(out + i * frameBytes);
+                        bytes[0] = static_cast<juce::uint8>(sample);
+                        bytes[1] = static_cast<juce::uint8>(sample >> 8);
+                        bytes[2] = static_cast<juce::uint8>(sample >> 16);
+                    }
+                    break;
+
+                case Type::F32:
+                    for (int i = 0; i < numFrames; ++i)
+                        std::memcpy(out + i * frameBytes, in + i, sizeof(float));
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// Plugin parameters from the command line, shared by the offline tools:
+// --preset file (the plugin's saved state, compact or XML, or the plain XML), then any number of
+// --param id=value (plain values: Hz, %, dB; choices by index, switches 0/1) on top,
+// and --list-params. StereoImagerRender also takes --automation file, sample-accurate
+// parameter changes over the input's timeline (see loadAutomation).
+namespace ToolParameters
+{
+    struct AutomationPoint
+    {
+        double seconds;             // From the start of the input
+        int parameterIndex;         // In getParameters() order
+        float value;                // Plain value, as for --param
+    };
+    inline bool set(StereoImagerAudioProcessor& processor, const juce::String& assignment)
+    {
+        const auto id = assignment.upToFirstOccurrenceOf("=", false, false).trim();
+        const auto value = assignment.fromFirstOccurrenceOf("=", false, false).trim();
+        auto* param = processor.getAPVTS().getParameter(id);
+
+        if (param == nullptr || value.isEmpty())
+            return false;
+
+        param->setValueNotifyingHost(param->convertTo0to1(value.getFloatValue()));
+        return true;
+    }
+
+    // Accepts what getStateInformation() writes now or wrote before, and the plain APVTS XML
+    inline bool loadPreset(StereoImagerAudioProcessor& processor, const juce::File& file)
+    {
+        juce::MemoryBlock state;
+        if (! file.loadFileAsData(state))
+            return false;
+
+        if (CompactState::isCompactState(state.getData(), static_cast<int>(state.getSize())))
+        {
+            // Loaded as it is below
+        }
+        else if (auto xml = juce::parseXML(file))
+        {
+            if (! xml->hasTagName(processor.getAPVTS().state.getType()))
+                return false;
+
+            state.reset();
+            juce::AudioProcessor::copyXmlToBinary(*xml, state);
+        }
+        else if (auto binaryXml = juce::AudioProcessor::getXmlFromBinary(state.getData(), static_cast<int>(state.getSize())))
+        {
+            if (! binaryXml->hasTagName(processor.getAPVTS().state.getType()))
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+
+        processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        return true;
+    }
+
+    // --preset, then every --param in order (a later one wins). Reports the first bad one
+    // and returns false.
+    inline bool applyArguments(StereoImagerAudioProcessor& processor, const juce::ArgumentList& args)
+    {
+        if (args.containsOption("--preset"))
+        {
+            const auto preset = args.getFileForOption("--preset");
+            if (! loadPreset(processor, preset))
+            {
+                std::fprintf(stderr, "Can't load preset %s\n", preset.getFullPathName().toRawUTF8());
+                return false;
+            }
+        }
+
+        for (int i = 0; i + 1 < args.size(); ++i)
+        {
+            if (args[i] == "--param" && ! set(processor, args[i + 1].text))
+            {
+                std::fprintf(stderr, "Bad --param %s (see --list-params)\n", args[i + 1].text.toRawUTF8());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // One change per line, "seconds id value", # comments and blank lines skipped. Sorted
+    // by time, keeping file order at the same time. Reports the first bad line and returns false.
+    inline bool loadAutomation(StereoImagerAudioProcessor& processor, const juce::File& file,
+                               std::vector<AutomationPoint>& points)
+    {
+        juce::StringArray lines;
+        if (! file.existsAsFile())
+        {
+            std::fprintf(stderr, "Can't read automation %s\n", file.getFullPathName().toRawUTF8());
+            return false;
+        }
+
+        file.readLines(lines);
+        const auto& parameters = processor.getParameters();
+        points.clear();
+
+        for (int line = 0; line < lines.size(); ++line)
+        {
+            const auto text = lines[line].upToFirstOccurrenceOf("#", false, false).trim();
+            if (text.isEmpty())
+                continue;
+
+            auto tokens = juce::StringArray::fromTokens(text, " \t", "");
+            tokens.removeEmptyStrings();
+
+            int index = -1;
+            if (tokens.size() == 3)
+                for (int i = 0; i < parameters.size() && index < 0; ++i)
+                    if (auto* param = dynamic_cast<juce::RangedAudioParameter*>(parameters[i]))
+                        if (param->getParameterID() == tokens[1])
+                            index = i;
+
+            if (index < 0 || tokens[0].getDoubleValue() < 0.0)
+            {
+                std::fprintf(stderr, "Bad automation line %d: %s (see --list-params)\n", line + 1, text.toRawUTF8());
+                return false;
+            }
+
+            points.push_back({ tokens[0].getDoubleValue(), index, tokens[2].getFloatValue() });
+        }
+
+        std::stable_sort(points.begin(), points.end(), [](const AutomationPoint& a, const AutomationPoint& b)
+        {
+            return a.seconds < b.seconds;
+        });
+
+        return true;
+    }
+
+    inline void list(StereoImagerAudioProcessor& processor)
+    {
+        for (auto* p : processor.getParameters())
+        {
+            if (auto* param = dynamic_cast<juce::RangedAudioParameter*>(p))
+            {
+                const auto& range = param->getNormalisableRange();
+                std::fprintf(stderr, "%-22s %8g to %-8g default %g\n", param->getParameterID().toRawUTF8(),
+                             static_cast<double>(range.start), static_cast<double>(range.end),
+                             static_cast<double>(param->convertFrom0to1(param->getDefaultValue())));
+            }
+        }
+    }
+}
@@ -0,0 +1,599 @@
+#include "Benchmarks.h"
+#include "PluginProcessor.h"
+#include "DSP/Crossover.h"
+#include "DSP/Decorrelator.h"
+#include "DSP/Kernels.h"
+#include "DSP/StereoProcessor.h"
+#include "DSP/MultibandProcessor.h"
+#include "DSP/SpectralWidth.h"
+
+namespace
+{
+    // Stereo noise at -6 dBFS, long enough that blocks don't repeat in cache. Always at
+    // least a few blocks long, so the offset arithmetic of the runs never divides by zero.
+    juce::AudioBuffer<float> makeNoise(const Benchmarks::Options& options, int minSamples)
+    {
+        const int numSamples = juce::jmax(minSamples, 4 * options.blockSize);
+        juce::AudioBuffer<float> noise(2, numSamples);
+        juce::Random random(1234);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                noise.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+        return noise;
+    }
+
+    const char* getEngineName(LR4Crossover::Engine engine)
+    {
+        return engine == LR4Crossover::Engine::StateVariable ? "state-variable" : "biquad";
+    }
+
+    // Runs the split over the noise for the requested time; returns ns per stereo sample
+    double timeCrossover(const Benchmarks::Options& options, LR4Crossover::Engine engine, bool sweep,
+                         const juce::AudioBuffer<float>& noise)
+    {
+        LR4Crossover crossover;
+        crossover.setEngine(engine);
+        crossover.prepare(options.sampleRate, 250.0f);
+
+        const int block = options.blockSize;
+        std::vector<float> lowL(static_cast<size_t>(block)), lowR(lowL.size()), highL(lowL.size()), highR(lowL.size());
+
+        const auto totalSamples = static_cast<juce::int64>(options.seconds * options.sampleRate);
+        const int noiseBlocks = noise.getNumSamples() / block;
+        juce::int64 processed = 0;
+        int blockIndex = 0;
+
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        while (processed < totalSamples)
+        {
+            // Sweep 80 Hz - 1 kHz once a second, retargeting every block like host automation
+            if (sweep)
+            {
+                const double phase = std::fmod(static_cast<double>(processed) / options.sampleRate, 1.0);
+                crossover.setFrequency(static_cast<float>(80.0 * std::pow(12.5, phase < 0.5 ? 2.0 * phase : 2.0 - 2.0 * phase)));
+            }
+
+            const int offset = (blockIndex++ % noiseBlocks) * block;
+            crossover.process(noise.getReadPointer(0, offset), noise.getReadPointer(1, offset),
+                              lowL.data(), lowR.data(), highL.data(), highR.data(), block);
+            processed += block;
+        }
+
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        return elapsed * 1.0e9 / static_cast<double>(processed);
+    }
+
+    // The multiband signal path of processBlock: stereo processor at neutral width, then bands.
+    // shared puts mono bass in the band tree instead of the stereo processor.
+    struct BandChain
+    {
+        StereoProcessor stereo;
+        MultibandProcessor multiband;
+
+        BandChain(const Benchmarks::Options& options, bool shared, float monoBassHz, float lowMidHz, float lowWidth)
+        {
+            stereo.prepare(options.sampleRate, options.blockSize);
+            multiband.prepare(options.sampleRate, options.blockSize);
+            stereo.setVisualsEnabled(false);
+            multiband.setMeteringEnabled(false);
+
+            stereo.setMonoBassFreq(monoBassHz);
+            stereo.setMonoBassEnabled(! shared);
+            multiband.setMonoBass(shared, monoBassHz);
+            multiband.setLowMidCrossover(lowMidHz);
+            multiband.setLowWidth(lowWidth);
+            multiband.setMidWidth(130.0f);
+            multiband.setHighWidth(80.0f);
+        }
+
+        void process(juce::AudioBuffer<float>& buffer)
+        {
+            stereo.process(buffer);
+            multiband.process(buffer);
+        }
+    };
+
+    // Calls run(instance) for every instance, round after round, for the requested time;
+    // returns microseconds per call
+    template <typename Fn>
+    double timePerInstance(const Benchmarks::Options& options, int numInstances, Fn&& run)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        juce::int64 calls = 0;
+        double elapsed = 0.0;
+
+        do
+        {
+            for (int i = 0; i < numInstances; ++i)
+                run(i);
+
+            calls += numInstances;
+            elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        }
+        while (elapsed < options.seconds);
+
+        return elapsed * 1.0e6 / static_cast<double>(calls);
+    }
+
+    // Calls run(offset) over the noise in block-sized steps for the requested time;
+    // returns ns per stereo sample
+    template <typename Fn>
+    double timeKernel(const Benchmarks::Options& options, int noiseLength, Fn&& run)
+    {
+        const auto totalSamples = static_cast<juce::int64>(options.seconds * options.sampleRate);
+        const int noiseBlocks = noiseLength / options.blockSize;
+        juce::int64 processed = 0;
+        int blockIndex = 0;
+
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        while (processed < totalSamples)
+        {
+            run((blockIndex++ % noiseBlocks) * options.blockSize);
+            processed += options.blockSize;
+        }
+
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        return elapsed * 1.0e9 / static_cast<double>(processed);
+    }
+}
+
+namespace Benchmarks
+{
+    int runCrossover(const Options& options)
+    {
+        std::printf("Crossover benchmark: %.0f Hz, %d-sample blocks, %.1f s per run\n"
+                    "(the engines' outputs are compared in StereoImagerTests)\n\n",
+                    options.sampleRate, options.blockSize, options.seconds);
+        std::printf("%16s %14s %14s\n", "engine", "static ns/smp", "swept ns/smp");
+
+        const auto noise = makeNoise(options, 1 << 16);
+
+        for (auto engine : { LR4Crossover::Engine::Biquad, LR4Crossover::Engine::StateVariable })
+        {
+            const double fixed = timeCrossover(options, engine, false, noise);
+            const double swept = timeCrossover(options, engine, true, noise);
+            std::printf("%16s %14.2f %14.2f\n", getEngineName(engine), fixed, swept);
+        }
+
+        return 0;
+    }
+
+    int runKernels(const Options& options)
+    {
+        std::printf("Kernel benchmark: %d-sample blocks, %.1f s per kernel, ns per stereo sample\n"
+                    "(dispatcher picks %s on this CPU)\n\n",
+                    options.blockSize, options.seconds, Kernels::getLevelName(Kernels::getBestLevel()));
+        std::printf("%10s %12s %12s %12s %12s %12s %12s %12s\n",
+                    "isa", "lr4Split", "matrix", "levels", "correlation", "decimate", "allpass", "field");
+
+        auto noise = makeNoise(options, 1 << 16);
+        const int n = options.blockSize;
+        std::vector<float> a(static_cast<size_t>(n)), b(a.size()), c(a.size()), d(a.size());
+        float sink = 0.0f;
+
+        for (int level = 0; level < static_cast<int>(Kernels::IsaLevel::NumLevels); ++level)
+        {
+            const auto* table = Kernels::getTable(static_cast<Kernels::IsaLevel>(level));
+            if (table == nullptr)
+                continue;
+
+            Kernels::LR4Lanes lanes;
+            auto lp = DSPUtils::calcLowPassLR(options.sampleRate, 250.0f);
+            auto hp = DSPUtils::calcHighPassLR(options.sampleRate, 250.0f);
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const auto& coeffs = lane < 2 ? lp : hp;
+                lanes.b0[lane] = coeffs.b0; lanes.b1[lane] = coeffs.b1; lanes.b2[lane] = coeffs.b2;
+                lanes.a1[lane] = coeffs.a1; lanes.a2[lane] = coeffs.a2;
+            }
+
+            Kernels::AllpassLanes allpass;
+            for (int section = 0; section < Kernels::AllpassLanes::numSections; ++section)
+            {
+                const auto coeffs = DSPUtils::calcAllPass(options.sampleRate, 250.0f * static_cast<float>(section + 1), 0.7f);
+                allpass.a1[section] = coeffs.a1;
+                allpass.a2[section] = coeffs.a2;
+            }
+
+            const Kernels::StereoMatrix matrix { 0.9f, 0.1f, 0.2f, 0.8f };
+            float sums[4] = {};
+            float fieldBins[Kernels::stereoFieldBins] = {};
+
+            const double split = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                table->lr4Split(lanes, noise.getReadPointer(0, offset), noise.getReadPointer(1, offset),
+                                a.data(), b.data(), c.data(), d.data(), n);
+            });
+
+            // In place on a copy so the noise doesn't decay towards zero
+            const double matrixNs = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                std::copy_n(noise.getReadPointer(0, offset), n, a.data());
+                std::copy_n(noise.getReadPointer(1, offset), n, b.data());
+                table->stereoMatrix(a.data(), b.data(), matrix, n);
+            });
+
+            const double levels = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                table->levelSums(noise.getReadPointer(0, offset), noise.getReadPointer(1, offset), n, sums);
+            });
+
+            const double correlation = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                table->correlationSums(noise.getReadPointer(0, offset), noise.getReadPointer(1, offset), n, sums);
+            });
+
+            const double decimation = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                table->decimate(noise.getReadPointer(0, offset), 4, n / 4, c.data());
+                table->decimate(noise.getReadPointer(1, offset), 4, n / 4, d.data());
+            });
+
+            // One channel through the whole cascade
+            const double allpassNs = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                table->allpassCascade(allpass, noise.getReadPointer(0, offset), a.data(), n);
+            });
+
+            const double field = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                table->stereoFieldHistogram(noise.getReadPointer(0, offset), noise.getReadPointer(1, offset), n, fieldBins);
+            });
+
+            sink += a[0] + b[0] + c[0] + d[0] + sums[0] + fieldBins[0];
+            std::printf("%10s %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f\n",
+                        table->name, split, matrixNs, levels, correlation, decimation, allpassNs, field);
+        }
+
+        std::printf("\n(checksum %g)\n", static_cast<double>(sink));
+        return 0;
+    }
+
+    int runBlockIIR(const Options& options)
+    {
+        std::printf("Block IIR benchmark: LR4 split, block path against per-sample path, %.1f s per run\n"
+                    "(accuracy is covered by StereoImagerTests)\n\n", options.seconds);
+        std::printf("%8s %8s %8s %10s %10s\n", "rate", "freq", "block", "block ns", "sample ns");
+
+        const auto noise = makeNoise(options, 1 << 18);
+        std::vector<float> scratch(static_cast<size_t>(BlockIIR::scratchSize));
+
+        for (double rate : { 44100.0, 96000.0 })
+        {
+            for (float frequency : { 120.0f, 1000.0f })
+            {
+                for (int block : { BlockIIR::minBlockSize, 16384, 65536 })
+                {
+                    LR4Crossover blocked, perSample;
+                    blocked.prepare(rate, frequency);
+                    blocked.setBlockScratch(scratch.data());
+                    perSample.prepare(rate, frequency);
+
+                    const auto n = static_cast<size_t>(block);
+                    std::vector<float> bands(n * 4);
+
+                    Options blockOptions = options;
+                    blockOptions.sampleRate = rate;
+                    blockOptions.blockSize = block;
+
+                    auto timeSplit = [&](LR4Crossover& crossover)
+                    {
+                        return timeKernel(blockOptions, noise.getNumSamples() - block, [&](int offset)
+                        {
+                            crossover.process(noise.getReadPointer(0, offset), noise.getReadPointer(1, offset),
+                                              &bands[0], &bands[n], &bands[n * 2], &bands[n * 3], block);
+                        });
+                    };
+
+                    const double blockNs = timeSplit(blocked);
+                    const double sampleNs = timeSplit(perSample);
+                    std::printf("%8.0f %8.0f %8d %10.2f %10.2f\n", rate, frequency, block, blockNs, sampleNs);
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    int runSharedBands(const Options& options)
+    {
+        std::printf("Shared band tree: %.0f Hz, %d-sample blocks, %.1f s per run, ns per stereo sample\n\n",
+                    options.sampleRate, options.blockSize, options.seconds);
+        std::printf("%10s %10s %12s %12s %10s\n", "mono bass", "low-mid", "separate", "shared", "saving");
+
+        const auto noise = makeNoise(options, 1 << 16);
+        const int n = options.blockSize;
+        juce::AudioBuffer<float> buffer(2, n);
+
+        struct Case { float monoBass, lowMid; };
+        for (auto c : { Case { 250.0f, 250.0f }, Case { 120.0f, 250.0f }, Case { 400.0f, 250.0f } })
+        {
+            double ns[2] {};
+
+            for (int shared = 0; shared < 2; ++shared)
+            {
+                BandChain chain(options, shared != 0, c.monoBass, c.lowMid, 150.0f);
+
+                // In place on a copy so the noise doesn't decay towards zero
+                ns[shared] = timeKernel(options, noise.getNumSamples(), [&](int offset)
+                {
+                    for (int ch = 0; ch < 2; ++ch)
+                        buffer.copyFrom(ch, 0, noise, ch, offset, n);
+                    chain.process(buffer);
+                });
+            }
+
+            std::printf("%10.0f %10.0f %12.2f %12.2f %9.0f%%\n", c.monoBass, c.lowMid, ns[0], ns[1],
+                        100.0 * (1.0 - ns[1] / ns[0]));
+        }
+
+        return 0;
+    }
+
+    int runNeutralBands(const Options& options)
+    {
+        std::printf("Neutral bands: %.0f Hz, %d-sample blocks, %.1f s per run, ns per stereo sample\n\n",
+                    options.sampleRate, options.blockSize, options.seconds);
+
+        const auto noise = makeNoise(options, 1 << 16);
+        const int n = options.blockSize;
+        juce::AudioBuffer<float> buffer(2, n);
+
+        // All widths at 100% leaves the neutral path; a hair over on the mid band keeps the
+        // full tree (its width stage runs, as it would at any other setting)
+        double ns[2] {};
+
+        for (int full = 0; full < 2; ++full)
+        {
+            MultibandProcessor bands;
+            bands.prepare(options.sampleRate, options.blockSize);
+            bands.setMidWidth(full != 0 ? 101.0f : 100.0f);
+
+            ns[full] = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.copyFrom(ch, 0, noise, ch, offset, n);
+                bands.process(buffer);
+            });
+        }
+
+        std::printf("%14s %14s %10s\n", "full tree", "neutral path", "saving");
+        std::printf("%14.2f %14.2f %9.0f%%\n", ns[1], ns[0], 100.0 * (1.0 - ns[0] / ns[1]));
+        return 0;
+    }
+
+    int runDecorrelator(const Options& options)
+    {
+        std::printf("Decorrelator: %.0f Hz, %d-sample blocks, mono noise in, %.1f s per target, ns per stereo sample\n"
+                    "(the correlation it settles at and the mono sum are checked in StereoImagerTests)\n\n",
+                    options.sampleRate, options.blockSize, options.seconds);
+        std::printf("%8s %10s\n", "target", "ns");
+
+        // Identical channels: nothing for width to scale
+        auto noise = makeNoise(options, 1 << 16);
+        noise.copyFrom(1, 0, noise, 0, 0, noise.getNumSamples());
+
+        const int n = options.blockSize;
+        juce::AudioBuffer<float> buffer(2, n);
+
+        for (const float target : { 0.0f, 0.5f, 0.8f })
+        {
+            Decorrelator decorrelator;
+            decorrelator.prepare(options.sampleRate, n);
+            decorrelator.setTargetCorrelation(target);
+            decorrelator.setEnabled(true);
+
+            const double ns = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.copyFrom(ch, 0, noise, ch, offset, n);
+                decorrelator.process(buffer.getWritePointer(0), buffer.getWritePointer(1), n);
+            });
+
+            std::printf("%8.2f %10.2f\n", target, ns);
+        }
+
+        return 0;
+    }
+
+    int runSpectralWidth(const Options& options)
+    {
+        std::printf("Spectral width: %.0f Hz, %d-sample blocks, %.1f s per size, ns per stereo sample\n"
+                    "(a flat curve is checked to be a pure delay in StereoImagerTests)\n\n",
+                    options.sampleRate, options.blockSize, options.seconds);
+        std::printf("%8s %10s %10s %10s\n", "fft", "latency", "ms", "ns");
+
+        const auto noise = makeNoise(options, 1 << 16);
+        const int n = options.blockSize;
+        juce::AudioBuffer<float> buffer(2, n);
+
+        for (int order = SpectralWidth::minOrder; order <= SpectralWidth::maxOrder; ++order)
+        {
+            // A curve that isn't flat, so every bin gain is in play
+            SpectralWidth spectral;
+            spectral.prepare(options.sampleRate, n);
+            spectral.allocate();
+            spectral.setFftOrder(order);
+            spectral.setEnabled(true);
+            spectral.setNode(0, 100.0f, 0.0f);
+            spectral.setNode(4, 8000.0f, 180.0f);
+
+            const int latency = spectral.getLatencySamples();
+
+            const double ns = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.copyFrom(ch, 0, noise, ch, offset, n);
+                spectral.process(buffer);
+            });
+
+            std::printf("%8d %10d %10.1f %10.2f\n", spectral.getFftSize(), latency, 1000.0 * latency / options.sampleRate, ns);
+        }
+
+        return 0;
+    }
+
+    int runState(const Options& options)
+    {
+        constexpr int numInstances = 200;
+        std::printf("State benchmark: %d instances, %.1f s per measurement, microseconds per instance\n"
+                    "(both formats are checked to restore every parameter in StereoImagerTests)\n\n",
+                    numInstances, options.seconds);
+        std::printf("%10s %10s %12s %12s\n", "format", "bytes", "save", "load");
+
+        std::vector<std::unique_ptr<StereoImagerAudioProcessor>> instances, loaded;
+        juce::Random random(1234);
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            instances.push_back(std::make_unique<StereoImagerAudioProcessor>());
+            loaded.push_back(std::make_unique<StereoImagerAudioProcessor>());
+
+            for (auto* param : instances.back()->getParameters())
+                param->setValueNotifyingHost(random.nextFloat());
+        }
+
+        std::vector<juce::MemoryBlock> states(static_cast<size_t>(numInstances));
+
+        for (bool compact : { false, true })
+        {
+            const double save = timePerInstance(options, numInstances, [&](int i)
+            {
+                auto& state = states[static_cast<size_t>(i)];
+
+                if (compact)
+                {
+                    instances[static_cast<size_t>(i)]->getStateInformation(state);
+                    return;
+                }
+
+                // What getStateInformation wrote before the compact format
+                std::unique_ptr<juce::XmlElement> xml(instances[static_cast<size_t>(i)]->getAPVTS().copyState().createXml());
+                state.reset();
+                juce::AudioProcessor::copyXmlToBinary(*xml, state);
+            });
+
+            const double load = timePerInstance(options, numInstances, [&](int i)
+            {
+                const auto& state = states[static_cast<size_t>(i)];
+                loaded[static_cast<size_t>(i)]->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            });
+
+            std::printf("%10s %10d %12.2f %12.2f\n", compact ? "compact" : "xml",
+                        static_cast<int>(states[0].getSize()), save, load);
+        }
+
+        return 0;
+    }
+
+    int runAutomation(const Options& options)
+    {
+        std::printf("Automation: %.0f Hz, %d-sample blocks, %.1f s per measurement\n"
+                    "(changes are checked to land on their sample in StereoImagerTests)\n\n",
+                    options.sampleRate, options.blockSize, options.seconds);
+
+        const auto noise = makeNoise(options, 1 << 14);
+        const int block = options.blockSize;
+
+        // Cost of a change every 64 samples, against the same blocks with none
+        std::printf("%12s %12s\n", "changes", "ns/sample");
+        StereoImagerAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(options.sampleRate, block);
+        processor.prepareToPlay(options.sampleRate, block);
+        juce::AudioBuffer<float> buffer(2, block);
+        juce::MidiBuffer midi;
+
+        int widthIndex = 0;
+        for (auto* param : processor.getParameters())
+            if (static_cast<juce::RangedAudioParameter*>(param)->getParameterID() == "width")
+                widthIndex = param->getParameterIndex();
+
+        for (bool automated : { false, true })
+        {
+            int toggle = 0;
+            const double ns = timeKernel(options, noise.getNumSamples(), [&](int offset)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.copyFrom(ch, 0, noise, ch, offset, block);
+
+                if (automated)
+                    for (int i = 0; i < block; i += 64)
+                        processor.getParameterEvents().add(i, widthIndex, (toggle++ & 1) != 0 ? 140.0f : 60.0f);
+
+                processor.processBlock(buffer, midi);
+            });
+
+            std::printf("%12s %12.2f\n", automated ? "every 64" : "none", ns);
+        }
+
+        return 0;
+    }
+
+    int runBlockSizes(const Options& options)
+    {
+        constexpr int maxBlock = 4096;
+        std::printf("Block sizes: %.0f Hz, %.1f s per size, ns per stereo sample\n\n", options.sampleRate, options.seconds);
+        std::printf("%10s %12s %12s\n", "block", "ns", "vs 4096");
+
+        const auto noise = makeNoise(options, 1 << 16);
+        const auto totalSamples = static_cast<juce::int64>(options.seconds * options.sampleRate);
+        juce::AudioBuffer<float> buffer(2, maxBlock);
+        juce::MidiBuffer midi;
+
+        // Calls nextSize() for each block's length; returns ns per stereo sample
+        auto timeSizes = [&](auto&& nextSize)
+        {
+            StereoImagerAudioProcessor processor;
+            processor.setRateAndBufferSizeDetails(options.sampleRate, maxBlock);
+            processor.prepareToPlay(options.sampleRate, maxBlock);
+
+            // Something for every stage to do: mono bass, then three bands
+            for (auto* param : processor.getParameters())
+            {
+                const auto id = static_cast<juce::RangedAudioParameter*>(param)->getParameterID();
+                if (id == "multibandEnabled" || id == "monoBassEnabled")
+                    param->setValueNotifyingHost(1.0f);
+                else if (id == "lowWidth")
+                    param->setValueNotifyingHost(0.2f);
+            }
+
+            juce::int64 processed = 0;
+            int position = 0;
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            while (processed < totalSamples)
+            {
+                const int n = nextSize();
+                if (position + n > noise.getNumSamples())
+                    position = 0;
+
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.copyFrom(ch, 0, noise, ch, position, n);
+
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, n);
+                processor.processBlock(block, midi);
+                position += n;
+                processed += n;
+            }
+
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            return elapsed * 1.0e9 / static_cast<double>(processed);
+        };
+
+        const double reference = timeSizes([] { return maxBlock; });
+
+        for (int size = 1; size <= maxBlock; size *= 2)
+        {
+            const double ns = size == maxBlock ? reference : timeSizes([size] { return size; });
+            std::printf("%10d %12.2f %11.2fx\n", size, ns, ns / reference);
+        }
+
+        // What some hosts do around loop points and automation: a new size every call
+        juce::Random random(99);
+        const double varying = timeSizes([&random] { return 1 + random.nextInt(64); });
+        std::printf("%10s %12.2f %11.2fx\n", "1-64", varying, varying / reference);
+        return 0;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Focused DSP kernel benchmarks, run from StereoImagerHost instead of the
+// multi-instance session. They only time; whether the code they time is right is
+// StereoImagerTests' job. Each returns the process exit code.
+namespace Benchmarks
+{
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 256;
+        double seconds = 2.0;
+    };
+
+    // Biquad vs state-variable LR4 crossover, static and swept
+    int runCrossover(const Options& options);
+
+    // Each DSP kernel at every instruction set level this CPU supports
+    int runKernels(const Options& options);
+
+    // The time-parallel block IIR against per-sample filtering, over a few rates,
+    // frequencies and block sizes
+    int runBlockIIR(const Options& options);
+
+    // Mono bass + multiband as two crossover sets (stereo processor, then bands) against
+    // the shared band tree, with the mono bass crossover below, at and above the low-mid
+    // one (the outputs are compared in Tests/MonoBassTests.cpp)
+    int runSharedBands(const Options& options);
+
+    // The multiband processor on its full band tree and, at 100% widths, on the neutral
+    // path (the outputs are compared in Tests/MultibandTests.cpp)
+    int runNeutralBands(const Options& options);
+
+    // The decorrelator on mono noise at a few target correlations
+    int runDecorrelator(const Options& options);
+
+    // The STFT width curve at each FFT size: latency and cost
+    int runSpectralWidth(const Options& options);
+
+    // Saving and loading the plugin state per instance, the old XML way and the compact
+    // binary way, across a session's worth of instances with varied settings
+    int runState(const Options& options);
+
+    // The cost of splitting blocks at a parameter event every 64 samples
+    int runAutomation(const Options& options);
+
+    // The whole processor at host block sizes from 1 to 4096 samples, then with a size that
+    // changes every call: ns per stereo sample, and each size's cost against 4096-sample
+    // blocks. Reports only; from 8 samples up the curve is flat, and 1- and 2-sample
+    // blocks still pay the filters' per-call state load and store.
+    int runBlockSizes(const Options& options);
+}
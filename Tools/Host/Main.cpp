@@ -0,0 +1,399 @@
+// Headless multi-instance host.
+//
+// Creates N StereoImagerAudioProcessor instances and drives them from a simulated
+// audio callback across a worker pool, the way a DAW runs a parallel graph. Reports
+// callback times against the buffer deadline, throughput, the per-instance cost as the
+// instance count (and so the working set) grows, and the largest count that still
+// meets the deadline.
+//
+// The real-time safety sweep (no allocation or locking in processBlock across parameter
+// combinations) lives in StereoImagerTests; run it with ctest.
+//
+//   StereoImagerHost [--instances N] [--max-instances N] [--block 256] [--rate 48000]
+//                    [--threads T] [--seconds 5] [--automation] [--editors] [--shuffle]
+//                    [--bench-crossover] [--bench-kernels] [--bench-block-iir]
+//                    [--bench-bands] [--bench-neutral] [--bench-decorrelator]
+//                    [--bench-spectral] [--bench-state] [--bench-automation]
+//                    [--bench-block-sizes] [--isa sse2|neon|avx2|avx512]
+
+#include <JuceHeader.h>
+#include <numeric>
+#include <random>
+#include <thread>
+#include "PluginProcessor.h"
+#include "DSP/Kernels.h"
+#include "Host/Benchmarks.h"
+
+namespace
+{
+    struct HostOptions
+    {
+        int instances = 0;          // 0 = search for the maximum
+        int maxInstances = 4096;
+        int blockSize = 256;
+        double sampleRate = 48000.0;
+        int threads = juce::jmax(1, juce::SystemStats::getNumCpus());
+        double seconds = 5.0;
+        bool automation = false;
+        bool editors = false;
+        bool shuffle = false;
+    };
+
+    struct Instance
+    {
+        std::unique_ptr<StereoImagerAudioProcessor> processor;
+        std::unique_ptr<juce::AudioProcessorEditor> editor;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        juce::Random random;
+        int sourceOffset = 0;
+    };
+
+    struct SessionStats
+    {
+        int instances = 0;
+        int cycles = 0;
+        int deadlineMisses = 0;
+        double meanCycleUs = 0.0;
+        double p99CycleUs = 0.0;
+        double maxCycleUs = 0.0;
+        double deadlineUs = 0.0;
+        double nsPerInstanceSample = 0.0;
+        double realtimeFactor = 0.0;    // Audio seconds processed per wall second, summed over instances
+
+        bool meetsDeadline() const { return p99CycleUs <= deadlineUs && deadlineMisses * 100 <= cycles; }
+    };
+
+    //==============================================================================
+    class Session
+    {
+    public:
+        explicit Session(const HostOptions& o) : options(o)
+        {
+            // Shared noise source, copied into each instance's buffer every callback. A few
+            // blocks longer than one block, so every instance has somewhere to start from.
+            const int sourceLength = juce::jmax(1 << 16, 4 * options.blockSize);
+            source.setSize(2, sourceLength);
+            juce::Random random(1234);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < sourceLength; ++i)
+                    source.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+            for (int t = 1; t < options.threads; ++t)
+                workers.emplace_back([this] { workerLoop(); });
+        }
+
+        ~Session()
+        {
+            quit.store(true);
+            generation.fetch_add(1);
+            for (auto& w : workers)
+                w.join();
+
+            // Editors must go before their processors
+            for (auto& inst : instances)
+                inst->editor.reset();
+        }
+
+        void ensureInstances(int count)
+        {
+            while ((int)instances.size() < count)
+            {
+                auto inst = std::make_unique<Instance>();
+                inst->processor = std::make_unique<StereoImagerAudioProcessor>();
+                inst->processor->setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+                inst->processor->prepareToPlay(options.sampleRate, options.blockSize);
+                inst->buffer.setSize(2, options.blockSize);
+                inst->random.setSeed((juce::int64)instances.size() + 1);
+                inst->sourceOffset = inst->random.nextInt(source.getNumSamples() - options.blockSize);
+
+                if (options.editors)
+                {
+                    inst->editor.reset(inst->processor->createEditorIfNeeded());
+                    inst->editor->setVisible(true);
+                }
+
+                instances.push_back(std::move(inst));
+            }
+        }
+
+        SessionStats run(int count)
+        {
+            ensureInstances(count);
+            activeCount = count;
+
+            order.resize((size_t)count);
+            std::iota(order.begin(), order.end(), 0);
+
+            const int cycles = juce::jmax(1, (int)(options.seconds * options.sampleRate / options.blockSize));
+            std::vector<double> cycleUs;
+            cycleUs.reserve((size_t)cycles);
+
+            const double ticksToUs = 1.0e6 / (double)juce::Time::getHighResolutionTicksPerSecond();
+            auto lastEditorPaint = juce::Time::getMillisecondCounterHiRes();
+
+            for (int c = 0; c < cycles; ++c)
+            {
+                if (options.shuffle)
+                    std::shuffle(order.begin(), order.end(), shuffleEngine);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                runCycle();
+                cycleUs.push_back((double)(juce::Time::getHighResolutionTicks() - start) * ticksToUs);
+
+                // Editors repaint on the message thread between callbacks, ~30 fps of wall time
+                if (options.editors && juce::Time::getMillisecondCounterHiRes() - lastEditorPaint > 33.0)
+                {
+                    paintEditors();
+                    lastEditorPaint = juce::Time::getMillisecondCounterHiRes();
+                }
+            }
+
+            SessionStats stats;
+            stats.instances = count;
+            stats.cycles = cycles;
+            stats.deadlineUs = 1.0e6 * options.blockSize / options.sampleRate;
+
+            double total = 0.0;
+            for (auto us : cycleUs)
+            {
+                total += us;
+                if (us > stats.deadlineUs)
+                    ++stats.deadlineMisses;
+            }
+
+            std::sort(cycleUs.begin(), cycleUs.end());
+            stats.meanCycleUs = total / cycles;
+            stats.p99CycleUs = cycleUs[(size_t)juce::jmin(cycles - 1, (int)std::ceil(cycles * 0.99) - 1)];
+            stats.maxCycleUs = cycleUs.back();
+            stats.nsPerInstanceSample = 1000.0 * stats.meanCycleUs / ((double)count * options.blockSize)
+                                        * options.threads;
+            stats.realtimeFactor = (double)count * stats.deadlineUs / stats.meanCycleUs;
+            return stats;
+        }
+
+    private:
+        void runCycle()
+        {
+            // remaining first: a worker still returning from the last cycle may grab
+            // index 0 as soon as nextIndex is reset
+            remaining.store(activeCount);
+            nextIndex.store(0);
+            generation.fetch_add(1, std::memory_order_release);
+
+            processAvailable();
+
+            while (remaining.load(std::memory_order_acquire) > 0)
+                std::this_thread::yield();
+        }
+
+        void workerLoop()
+        {
+            auto seen = generation.load();
+
+            while (! quit.load())
+            {
+                auto current = generation.load(std::memory_order_acquire);
+                if (current == seen)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                seen = current;
+                if (! quit.load())
+                    processAvailable();
+            }
+        }
+
+        // Work distribution: every thread pulls the next unprocessed instance
+        void processAvailable()
+        {
+            for (;;)
+            {
+                const int index = nextIndex.fetch_add(1);
+                if (index >= activeCount)
+                    return;
+
+                processInstance(*instances[(size_t)order[(size_t)index]]);
+                remaining.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        void processInstance(Instance& inst)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                inst.buffer.copyFrom(ch, 0, source, ch, inst.sourceOffset, options.blockSize);
+
+            inst.sourceOffset = (inst.sourceOffset + options.blockSize) % (source.getNumSamples() - options.blockSize);
+
+            // Randomised automation, delivered on the audio thread the way the plugin wrappers
+            // deliver a host's: setValue() alone would leave the APVTS (and so the processor)
+            // unaware of the change
+            if (options.automation && inst.random.nextInt(8) == 0)
+            {
+                auto& params = inst.processor->getParameters();
+                auto* param = params[inst.random.nextInt(params.size())];
+                const float value = inst.random.nextFloat();
+                param->setValue(value);
+                param->sendValueChangedMessageToListeners(value);
+            }
+
+            inst.processor->processBlock(inst.buffer, inst.midi);
+        }
+
+        void paintEditors()
+        {
+            for (int i = 0; i < activeCount; ++i)
+            {
+                if (auto* editor = instances[(size_t)i]->editor.get())
+                {
+                    if (auto* timer = dynamic_cast<juce::Timer*>(editor))
+                        timer->timerCallback();
+
+                    juce::ignoreUnused(editor->createComponentSnapshot(editor->getLocalBounds()));
+                }
+            }
+        }
+
+        const HostOptions options;
+        juce::AudioBuffer<float> source;
+        std::vector<std::unique_ptr<Instance>> instances;
+        std::vector<int> order;
+        std::mt19937 shuffleEngine { 42 };
+        int activeCount = 0;
+
+        std::vector<std::thread> workers;
+        std::atomic<juce::uint64> generation { 0 };
+        std::atomic<int> nextIndex { 0 };
+        std::atomic<int> remaining { 0 };
+        std::atomic<bool> quit { false };
+    };
+
+    //==============================================================================
+    void printHeader()
+    {
+        std::printf("%10s %10s %10s %10s %8s %14s %12s\n",
+                    "instances", "mean us", "p99 us", "max us", "misses", "ns/inst-smp", "x realtime");
+    }
+
+    void printStats(const SessionStats& s)
+    {
+        std::printf("%10d %10.1f %10.1f %10.1f %8d %14.2f %12.1f%s\n",
+                    s.instances, s.meanCycleUs, s.p99CycleUs, s.maxCycleUs, s.deadlineMisses,
+                    s.nsPerInstanceSample, s.realtimeFactor, s.meetsDeadline() ? "" : "  (misses deadline)");
+        std::fflush(stdout);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    HostOptions options;
+    if (args.containsOption("--instances"))     options.instances = args.getValueForOption("--instances").getIntValue();
+    if (args.containsOption("--max-instances")) options.maxInstances = args.getValueForOption("--max-instances").getIntValue();
+    if (args.containsOption("--block"))         options.blockSize = args.getValueForOption("--block").getIntValue();
+    if (args.containsOption("--rate"))          options.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+    if (args.containsOption("--threads"))       options.threads = args.getValueForOption("--threads").getIntValue();
+    if (args.containsOption("--seconds"))       options.seconds = args.getValueForOption("--seconds").getDoubleValue();
+    options.automation = args.containsOption("--automation");
+    options.editors = args.containsOption("--editors");
+    options.shuffle = args.containsOption("--shuffle");
+
+    options.blockSize = juce::jlimit(1, 65536, options.blockSize);
+    options.threads = juce::jmax(1, options.threads);
+
+    Benchmarks::Options benchOptions;
+    benchOptions.sampleRate = options.sampleRate;
+    benchOptions.blockSize = options.blockSize;
+    if (args.containsOption("--seconds"))
+        benchOptions.seconds = options.seconds;
+
+    if (args.containsOption("--bench-crossover"))
+        return Benchmarks::runCrossover(benchOptions);
+
+    if (args.containsOption("--bench-kernels"))
+        return Benchmarks::runKernels(benchOptions);
+
+    if (args.containsOption("--bench-block-iir"))
+        return Benchmarks::runBlockIIR(benchOptions);
+
+    if (args.containsOption("--bench-bands"))
+        return Benchmarks::runSharedBands(benchOptions);
+
+    if (args.containsOption("--bench-neutral"))
+        return Benchmarks::runNeutralBands(benchOptions);
+
+    if (args.containsOption("--bench-decorrelator"))
+        return Benchmarks::runDecorrelator(benchOptions);
+
+    if (args.containsOption("--bench-spectral"))
+        return Benchmarks::runSpectralWidth(benchOptions);
+
+    if (args.containsOption("--bench-state"))
+        return Benchmarks::runState(benchOptions);
+
+    if (args.containsOption("--bench-automation"))
+        return Benchmarks::runAutomation(benchOptions);
+
+    if (args.containsOption("--bench-block-sizes"))
+        return Benchmarks::runBlockSizes(benchOptions);
+
+    // Cap the kernel ISA for A/B runs of the session
+    if (args.containsOption("--isa"))
+    {
+        const auto isa = args.getValueForOption("--isa").toLowerCase();
+        Kernels::forceLevel(isa == "avx512" ? Kernels::IsaLevel::AVX512
+                          : isa == "avx2"   ? Kernels::IsaLevel::AVX2
+                                            : Kernels::IsaLevel::Baseline);
+    }
+
+    std::printf("StereoImagerHost: %.0f Hz, %d-sample blocks (deadline %.1f us), %d threads, %s kernels%s%s%s\n\n",
+                options.sampleRate, options.blockSize, 1.0e6 * options.blockSize / options.sampleRate,
+                options.threads, Kernels::getLevelName(Kernels::getBestLevel()), options.automation ? ", automation" : "",
+                options.editors ? ", editors" : "", options.shuffle ? ", shuffled graph order" : "");
+
+    Session session(options);
+    printHeader();
+
+    if (options.instances > 0)
+    {
+        printStats(session.run(options.instances));
+        return 0;
+    }
+
+    // Scaling curve: double the instance count until the deadline is missed...
+    int good = 0, bad = 0;
+    for (int n = 1; n <= options.maxInstances; n *= 2)
+    {
+        auto stats = session.run(n);
+        printStats(stats);
+
+        if (! stats.meetsDeadline())
+        {
+            bad = n;
+            break;
+        }
+
+        good = n;
+    }
+
+    // ...then bisect for the largest count that still meets it
+    if (bad > 0)
+    {
+        while (bad - good > juce::jmax(1, good / 50))
+        {
+            const int n = (good + bad) / 2;
+            auto stats = session.run(n);
+            printStats(stats);
+            (stats.meetsDeadline() ? good : bad) = n;
+        }
+    }
+
+    std::printf("\nMaximum instances before missing the deadline: %d%s\n",
+                good, bad == 0 ? " (search limit reached)" : "");
+    return 0;
+}
@@ -0,0 +1,275 @@
+// Offline renderer for long files.
+//
+// Runs an audio file through the plugin's processor into a WAV (RF64 past 4 GB) of the
+// same length, reading and writing through memory-mapped windows (see MappedAudioFile.h):
+//
+//   StereoImagerRender --input in.wav --output out.wav [--format s16|s24|f32] [--chunk 65536]
+//                      [--preset state.xml] [--param id=value ...] [--automation changes.txt]
+//                      [--keep-latency] [--list-params]
+//
+// --automation lists parameter changes as "seconds id value" lines, applied on the exact
+// sample whatever the chunk size.
+//
+// The output format follows the input unless --format says otherwise. Mono input is
+// rendered as stereo. As with StereoImagerStream the processor's latency is compensated
+// unless --keep-latency. Reports the render speed and the peak resident memory, which
+// should not grow with the file length.
+//
+// Batch mode renders every file in a directory (or listed one per line in a text file)
+// with the same settings, into WAVs of the same names in --output-dir:
+//
+//   StereoImagerRender --batch dir|list.txt --output-dir out [--threads N] [other options as above]
+//
+// Inputs that differ only in their extension (a.wav, a.aiff) keep it in the output name
+// (a.wav.wav, a.aiff.wav). Any other clash, such as the same name from two directories
+// of a list, stops the batch before anything is rendered.
+// Each worker thread keeps one processor for the whole batch (see BatchScheduler.h).
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "Common/ToolParameters.h"
+#include "Common/BatchScheduler.h"
+#include "Render/RenderJob.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <sys/resource.h>
+#endif
+
+namespace
+{
+    // Peak resident set size in MB, or -1 where there's no getrusage
+    double getPeakResidentMB()
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+        #if JUCE_MAC
+         return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);    // Bytes
+        #else
+         return static_cast<double>(usage.ru_maxrss) / 1024.0;               // KB
+        #endif
+       #else
+        return -1.0;
+       #endif
+    }
+
+    std::unique_ptr<StereoImagerAudioProcessor> createProcessor(const juce::ArgumentList& args)
+    {
+        auto processor = std::make_unique<StereoImagerAudioProcessor>();
+        return ToolParameters::applyArguments(*processor, args) ? std::move(processor) : nullptr;
+    }
+
+    void printResult(const char* prefix, const juce::String& name, const RenderJob::Result& result)
+    {
+        if (! result.ok)
+        {
+            std::fprintf(stderr, "%sFAILED %s: %s\n", prefix, name.toRawUTF8(), result.error.toRawUTF8());
+            return;
+        }
+
+        const double seconds = juce::jmax(1.0e-9, result.seconds);
+        std::fprintf(stderr, "%s%s: %.1f s of audio in %.2f s, %.1fx real time, %.1f MB/s in\n", prefix, name.toRawUTF8(),
+                     static_cast<double>(result.frames) / result.sampleRate, seconds,
+                     static_cast<double>(result.frames) / result.sampleRate / seconds, result.inputMB / seconds);
+    }
+
+    // One output WAV per input, or an empty array (and the clashing inputs reported) if two
+    // would still write the same file. Names are compared ignoring case, as on the
+    // filesystems where that matters.
+    juce::Array<juce::File> getBatchOutputs(const juce::Array<juce::File>& inputs, const juce::File& outputDir)
+    {
+        std::map<juce::String, int> baseNameCounts;
+        for (auto& input : inputs)
+            ++baseNameCounts[input.getFileNameWithoutExtension().toLowerCase()];
+
+        juce::Array<juce::File> outputs;
+        std::map<juce::String, juce::File> taken;
+        bool clash = false;
+
+        for (auto& input : inputs)
+        {
+            const bool keepExtension = baseNameCounts[input.getFileNameWithoutExtension().toLowerCase()] > 1;
+            const auto output = outputDir.getChildFile((keepExtension ? input.getFileName() : input.getFileNameWithoutExtension()) + ".wav");
+            const auto inserted = taken.emplace(output.getFileName().toLowerCase(), input);
+
+            if (! inserted.second)
+            {
+                std::fprintf(stderr, "%s and %s would both render to %s\n", inserted.first->second.getFullPathName().toRawUTF8(),
+                             input.getFullPathName().toRawUTF8(), output.getFileName().toRawUTF8());
+                clash = true;
+            }
+
+            outputs.add(output);
+        }
+
+        return clash ? juce::Array<juce::File>() : outputs;
+    }
+
+    int renderBatch(const juce::ArgumentList& args, const RenderJob::Settings& settings)
+    {
+        const auto source = args.getFileForOption("--batch");
+        const auto outputDir = args.getFileForOption("--output-dir");
+        const auto inputs = BatchScheduler::findInputs(source);
+
+        if (inputs.isEmpty())
+        {
+            std::fprintf(stderr, "No audio files in %s\n", source.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        const auto outputs = getBatchOutputs(inputs, outputDir);
+        if (outputs.isEmpty())
+            return 1;
+
+        if (! outputDir.createDirectory())
+        {
+            std::fprintf(stderr, "Can't create %s\n", outputDir.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        const int defaultThreads = juce::jmax(1, juce::SystemStats::getNumPhysicalCpus());
+        const int numWorkers = juce::jlimit(1, inputs.size(),
+                                            args.containsOption("--threads") ? args.getValueForOption("--threads").getIntValue() : defaultThreads);
+
+        // Everything a worker needs is allocated here, once, and reused for every file it
+        // renders; only prepareToPlay runs per file
+        std::vector<std::unique_ptr<StereoImagerAudioProcessor>> processors;
+        std::vector<juce::AudioBuffer<float>> buffers(static_cast<size_t>(numWorkers));
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            processors.push_back(createProcessor(args));
+            if (processors.back() == nullptr)
+                return 2;
+
+            buffers[static_cast<size_t>(i)].setSize(2, settings.chunk);
+        }
+
+        std::vector<juce::int64> costs;
+        for (auto& input : inputs)
+            costs.push_back(RenderJob::getLengthInFrames(input));
+
+        std::fprintf(stderr, "StereoImagerRender: %d files, %d worker%s, %d-frame chunks\n",
+                     inputs.size(), numWorkers, numWorkers == 1 ? "" : "s", settings.chunk);
+
+        std::vector<RenderJob::Result> results(static_cast<size_t>(inputs.size()));
+        std::mutex printLock;
+        BatchScheduler scheduler;
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        scheduler.run(numWorkers, costs, [&](int worker, int job)
+        {
+            const auto& input = inputs.getReference(job);
+            const auto& output = outputs.getReference(job);
+            auto& result = results[static_cast<size_t>(job)];
+
+            result = RenderJob::render(*processors[static_cast<size_t>(worker)], buffers[static_cast<size_t>(worker)],
+                                       input, output, settings);
+
+            const std::lock_guard<std::mutex> guard(printLock);
+            printResult(("[" + juce::String(worker) + "] ").toRawUTF8(), input.getFileName(), result);
+        });
+
+        const double wallSeconds = juce::jmax(1.0e-9, (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001);
+        double audioSeconds = 0.0, inputMB = 0.0, busySeconds = 0.0;
+        int failures = 0, stolen = 0;
+
+        for (auto& result : results)
+        {
+            if (! result.ok)
+            {
+                ++failures;
+                continue;
+            }
+
+            audioSeconds += static_cast<double>(result.frames) / result.sampleRate;
+            inputMB += result.inputMB;
+        }
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            busySeconds += scheduler.getBusySeconds(i);
+            stolen += scheduler.getNumStolen(i);
+        }
+
+        std::fprintf(stderr, "%d of %d files, %.1f s of audio in %.2f s, %.1fx real time, %.1f MB/s in, "
+                             "workers %.0f%% busy, %d jobs stolen, peak resident %.1f MB\n",
+                     inputs.size() - failures, inputs.size(), audioSeconds, wallSeconds, audioSeconds / wallSeconds,
+                     inputMB / wallSeconds, 100.0 * busySeconds / (wallSeconds * numWorkers), stolen, getPeakResidentMB());
+
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--list-params"))
+    {
+        StereoImagerAudioProcessor processor;
+        ToolParameters::list(processor);
+        return 0;
+    }
+
+    const bool batch = args.containsOption("--batch") && args.containsOption("--output-dir");
+
+    if (! batch && (! args.containsOption("--input") || ! args.containsOption("--output")))
+    {
+        std::fprintf(stderr, "Usage: StereoImagerRender --input in.wav --output out.wav [--format s16|s24|f32]\n"
+                             "                          [--chunk 65536] [--preset state.xml] [--param id=value ...]\n"
+                             "                          [--automation changes.txt] [--keep-latency]\n"
+                             "       StereoImagerRender --batch dir|list.txt --output-dir out [--threads N] [options as above]\n");
+        return 2;
+    }
+
+    RenderJob::Settings settings;
+    settings.chunk = juce::jlimit(256, 1 << 20, args.containsOption("--chunk") ? args.getValueForOption("--chunk").getIntValue() : 65536);
+    settings.keepLatency = args.containsOption("--keep-latency");
+
+    if (args.containsOption("--format"))
+    {
+        settings.matchInputFormat = false;
+        if (! PcmFormat::parse(args.getValueForOption("--format"), settings.format))
+        {
+            std::fprintf(stderr, "Unknown --format (s16, s24 or f32)\n");
+            return 2;
+        }
+    }
+
+    if (args.containsOption("--automation"))
+    {
+        StereoImagerAudioProcessor processor;
+        if (! ToolParameters::loadAutomation(processor, args.getFileForOption("--automation"), settings.automation))
+            return 2;
+    }
+
+    if (batch)
+        return renderBatch(args, settings);
+
+    auto processor = createProcessor(args);
+    if (processor == nullptr)
+        return 2;
+
+    const auto inputFile = args.getFileForOption("--input");
+    juce::AudioBuffer<float> buffer;
+    const auto result = RenderJob::render(*processor, buffer, inputFile, args.getFileForOption("--output"), settings);
+
+    if (! result.ok)
+    {
+        printResult("", inputFile.getFileName(), result);
+        return 1;
+    }
+
+    std::fprintf(stderr, "StereoImagerRender: %lld frames at %.0f Hz (%s), %s out, %d-frame chunks, latency %d%s\n",
+                 static_cast<long long>(result.frames), result.sampleRate, result.mapped ? "mapped" : "streamed",
+                 PcmFormat::getName(result.format), settings.chunk, result.latency,
+                 result.latency == 0 ? "" : (settings.keepLatency ? " (kept)" : " (compensated)"));
+
+    const double seconds = juce::jmax(1.0e-9, result.seconds);
+    std::fprintf(stderr, "%.2f s, %.1fx real time, %.1f MB/s in, peak resident %.1f MB\n",
+                 seconds, result.getRealtimeFactor(), result.inputMB / seconds, getPeakResidentMB());
+    return 0;
+}
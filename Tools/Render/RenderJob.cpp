@@ -0,0 +1,131 @@
+#include "Render/RenderJob.h"
+#include "Common/MappedAudioFile.h"
+
+namespace RenderJob
+{
+    namespace
+    {
+        constexpr int numChannels = 2;
+
+        PcmFormat::Type getMatchingFormat(const MappedAudioFile::Reader& reader)
+        {
+            if (reader.isFloatingPoint())
+                return PcmFormat::Type::F32;
+
+            return reader.getBitsPerSample() <= 16 ? PcmFormat::Type::S16 : PcmFormat::Type::S24;
+        }
+    }
+
+    juce::int64 getLengthInFrames(const juce::File& input)
+    {
+        // Opening maps nothing until the first read, so this only parses the header
+        MappedAudioFile::Reader reader;
+        return reader.open(input) ? reader.getLengthInFrames() : 0;
+    }
+
+    Result render(StereoImagerAudioProcessor& processor, juce::AudioBuffer<float>& buffer,
+                  const juce::File& input, const juce::File& output, const Settings& settings)
+    {
+        Result result;
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        MappedAudioFile::Reader reader;
+        if (! reader.open(input))
+        {
+            result.error = "can't read " + input.getFullPathName();
+            return result;
+        }
+
+        const int fileChannels = juce::jmin(numChannels, reader.getNumChannels());
+        const auto length = reader.getLengthInFrames();
+        const int chunk = settings.chunk;
+
+        result.sampleRate = reader.getSampleRate();
+        result.frames = length;
+        result.mapped = reader.isMapped();
+        result.format = settings.matchInputFormat ? getMatchingFormat(reader) : settings.format;
+        result.inputMB = static_cast<double>(length) * reader.getNumChannels() * reader.getBitsPerSample() / 8.0 / 1.0e6;
+
+        // Same rate and chunk as the last file: the buffers are reused, only the state clears
+        buffer.setSize(numChannels, chunk, false, false, true);
+        processor.setRateAndBufferSizeDetails(result.sampleRate, chunk);
+        processor.prepareToPlay(result.sampleRate, chunk);
+
+        // The tail still inside the processor is pushed out with silence past the end of
+        // the input; compensating drops the same amount from the start
+        result.latency = processor.getLatencySamples();
+        const auto totalInput = length + result.latency;
+        const auto totalOutput = settings.keepLatency ? totalInput : length;
+        int framesToDrop = settings.keepLatency ? 0 : result.latency;
+
+        MappedAudioFile::Writer writer;
+        if (! writer.create(output, result.sampleRate, numChannels, result.format, totalOutput))
+        {
+            result.error = "can't create " + output.getFullPathName();
+            return result;
+        }
+
+        juce::MidiBuffer midi;
+        juce::int64 outputPosition = 0;
+        size_t nextPoint = 0;
+
+        for (juce::int64 inputPosition = 0; inputPosition < totalInput; inputPosition += chunk)
+        {
+            const int numFrames = static_cast<int>(juce::jmin<juce::int64>(chunk, totalInput - inputPosition));
+
+            if (! reader.read(buffer.getArrayOfWritePointers(), fileChannels, inputPosition, numFrames))
+            {
+                result.error = "read failed at frame " + juce::String(inputPosition);
+                return result;
+            }
+
+            if (fileChannels == 1)
+                buffer.copyFrom(1, 0, buffer, 0, 0, numFrames);
+
+            // Views of the chunk, so the short last chunk doesn't reallocate. Without automation
+            // that's one block; otherwise as few as the event list allows.
+            for (int done = 0; done < numFrames;)
+            {
+                auto& events = processor.getParameterEvents();
+                int end = numFrames;
+
+                for (; nextPoint < settings.automation.size(); ++nextPoint)
+                {
+                    const auto& point = settings.automation[nextPoint];
+                    const auto frame = static_cast<juce::int64>(point.seconds * result.sampleRate + 0.5) - inputPosition;
+
+                    if (frame >= numFrames)
+                        break;
+
+                    if (events.size() == ParameterEvents::capacity)
+                    {
+                        end = juce::jmax(done + 1, static_cast<int>(frame));
+                        break;
+                    }
+
+                    events.add(juce::jmax(0, static_cast<int>(frame) - done), point.parameterIndex, point.value);
+                }
+
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, done, end - done);
+                processor.processBlock(block, midi);
+                done = end;
+            }
+
+            const int skip = juce::jmin(framesToDrop, numFrames);
+            framesToDrop -= skip;
+
+            const float* channels[numChannels] = { buffer.getReadPointer(0, skip), buffer.getReadPointer(1, skip) };
+            if (! writer.write(channels, outputPosition, numFrames - skip))
+            {
+                result.error = "write failed at frame " + juce::String(outputPosition);
+                return result;
+            }
+
+            outputPosition += numFrames - skip;
+        }
+
+        result.seconds = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+        result.ok = true;
+        return result;
+    }
+}
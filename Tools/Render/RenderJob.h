@@ -0,0 +1,43 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "Common/PcmFormat.h"
+#include "Common/ToolParameters.h"
+
+// One file through a processor into a WAV of the same length (see MappedAudioFile.h).
+// The processor is re-prepared for each file, so one instance can be reused across many.
+// Automation points land on the sample they fall on, through the processor's parameter
+// events; a chunk with more changes than the event list holds is rendered in pieces.
+namespace RenderJob
+{
+    struct Settings
+    {
+        bool matchInputFormat = true;
+        PcmFormat::Type format = PcmFormat::Type::F32;      // When not matching the input
+        int chunk = 65536;
+        bool keepLatency = false;
+        std::vector<ToolParameters::AutomationPoint> automation;    // Sorted by time
+    };
+
+    struct Result
+    {
+        bool ok = false;
+        juce::String error;
+        juce::int64 frames = 0;
+        double sampleRate = 0.0;
+        double inputMB = 0.0;
+        double seconds = 0.0;               // Wall time
+        bool mapped = false;
+        int latency = 0;
+        PcmFormat::Type format = PcmFormat::Type::F32;
+
+        double getRealtimeFactor() const { return seconds > 0.0 ? static_cast<double>(frames) / sampleRate / seconds : 0.0; }
+    };
+
+    // Length in frames without rendering anything (0 if unreadable), for scheduling
+    juce::int64 getLengthInFrames(const juce::File& input);
+
+    Result render(StereoImagerAudioProcessor& processor, juce::AudioBuffer<float>& buffer,
+                  const juce::File& input, const juce::File& output, const Settings& settings);
+}
@@ -0,0 +1,216 @@
+// Streaming imager for pipelines.
+//
+// Reads interleaved stereo PCM from stdin, runs it through the plugin's processor and
+// writes the same format to stdout, so it can sit between two ffmpeg processes:
+//
+//   ffmpeg -i in.wav -f s24le -ac 2 - \
+//     | StereoImagerStream --format s24 --rate 48000 --param width=140 --param monoBassFreq=100 \
+//     | ffmpeg -f s24le -ar 48000 -ac 2 -i - out.wav
+//
+//   StereoImagerStream [--format s16|s24|f32] [--rate 48000] [--block 8192]
+//                      [--param id=value ...] [--keep-latency] [--quiet] [--list-params]
+//
+// Parameters take their plain values (Hz, %, dB; choices by index, switches 0/1). The
+// output lines up with the input and has the same length: the processor's latency is
+// dropped from the start and flushed out with silence at the end, unless --keep-latency.
+// Everything is allocated up front; reads and writes go a whole block at a time straight
+// between the pipe and the block buffers. Throughput goes to stderr.
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "Common/PcmFormat.h"
+#include "Common/ToolParameters.h"
+
+#if JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <io.h>
+#endif
+
+namespace
+{
+    struct StreamOptions
+    {
+        PcmFormat::Type format = PcmFormat::Type::F32;
+        double sampleRate = 48000.0;
+        int blockSize = 8192;           // Frames per read
+        bool keepLatency = false;
+        bool quiet = false;
+    };
+
+    constexpr int numChannels = 2;
+
+    // Pipes hand data over in pieces, so keep reading until the block is full or the input ends
+    size_t readFully(char* dest, size_t numBytes)
+    {
+        size_t total = 0;
+
+        while (total < numBytes)
+        {
+            const size_t got = std::fread(dest + total, 1, numBytes - total, stdin);
+            if (got == 0)
+                break;
+
+            total += got;
+        }
+
+        return total;
+    }
+
+    //==============================================================================
+    class ThroughputLog
+    {
+    public:
+        ThroughputLog(double rate, bool periodic) : sampleRate(rate), reportPeriodically(periodic) {}
+
+        void add(size_t numBytes, int numFrames)
+        {
+            bytes += numBytes;
+            frames += numFrames;
+
+            if (reportPeriodically && now() - lastReport >= reportIntervalMs)
+            {
+                report("");
+                lastReport = now();
+            }
+        }
+
+        void report(const char* suffix) const
+        {
+            const double seconds = juce::jmax(1.0e-9, (now() - startMs) * 0.001);
+            std::fprintf(stderr, "%.1f MB in, %.1f MB/s, %.1fx real time%s\n",
+                         static_cast<double>(bytes) / 1.0e6, static_cast<double>(bytes) / 1.0e6 / seconds,
+                         static_cast<double>(frames) / sampleRate / seconds, suffix);
+        }
+
+    private:
+        static double now() { return juce::Time::getMillisecondCounterHiRes(); }
+        static constexpr double reportIntervalMs = 2000.0;
+
+        const double sampleRate;
+        const bool reportPeriodically;
+        const double startMs = now();
+        double lastReport = startMs;
+        juce::uint64 bytes = 0;
+        juce::int64 frames = 0;
+    };
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    StreamOptions options;
+
+    if (args.containsOption("--format") && ! PcmFormat::parse(args.getValueForOption("--format"), options.format))
+    {
+        std::fprintf(stderr, "Unknown --format (s16, s24 or f32)\n");
+        return 2;
+    }
+
+    if (args.containsOption("--rate"))  options.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+    if (args.containsOption("--block")) options.blockSize = args.getValueForOption("--block").getIntValue();
+    options.keepLatency = args.containsOption("--keep-latency");
+    options.quiet = args.containsOption("--quiet");
+
+    options.blockSize = juce::jlimit(16, 1 << 20, options.blockSize);
+
+    if (options.sampleRate <= 0.0)
+    {
+        std::fprintf(stderr, "--rate must be positive\n");
+        return 2;
+    }
+
+    auto processor = std::make_unique<StereoImagerAudioProcessor>();
+
+    if (args.containsOption("--list-params"))
+    {
+        ToolParameters::list(*processor);
+        return 0;
+    }
+
+    if (! ToolParameters::applyArguments(*processor, args))
+        return 2;
+
+   #if JUCE_WINDOWS
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+   #endif
+
+    // Our block buffers are the only buffering: no stdio copy on either side
+    std::setvbuf(stdin, nullptr, _IONBF, 0);
+    std::setvbuf(stdout, nullptr, _IONBF, 0);
+
+    processor->setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+    processor->prepareToPlay(options.sampleRate, options.blockSize);
+
+    const int latency = processor->getLatencySamples();
+    int framesToDrop = options.keepLatency ? 0 : latency;
+    int framesToFlush = framesToDrop;
+
+    if (! options.quiet)
+        std::fprintf(stderr, "StereoImagerStream: %s stereo at %.0f Hz, %d-frame blocks, latency %d samples%s\n",
+                     PcmFormat::getName(options.format), options.sampleRate, options.blockSize, latency,
+                     latency == 0 ? "" : (options.keepLatency ? " (kept)" : " (compensated)"));
+
+    const int frameBytes = numChannels * PcmFormat::getBytesPerSample(options.format);
+    const auto blockBytes = static_cast<size_t>(options.blockSize) * static_cast<size_t>(frameBytes);
+    std::vector<char> inputBytes(blockBytes), outputBytes(blockBytes);
+    juce::AudioBuffer<float> buffer(numChannels, options.blockSize);
+    juce::MidiBuffer midi;
+
+    ThroughputLog log(options.sampleRate, ! options.quiet);
+    bool inputEnded = false;
+
+    for (;;)
+    {
+        int numFrames = 0;
+
+        if (! inputEnded)
+        {
+            const size_t got = readFully(inputBytes.data(), blockBytes);
+            numFrames = static_cast<int>(got / static_cast<size_t>(frameBytes));
+            inputEnded = got < blockBytes;
+
+            if (got % static_cast<size_t>(frameBytes) != 0)
+                std::fprintf(stderr, "Input ended mid-frame, %d bytes dropped\n", static_cast<int>(got % static_cast<size_t>(frameBytes)));
+
+            PcmFormat::deinterleave(options.format, inputBytes.data(), buffer.getArrayOfWritePointers(), numChannels, numFrames);
+            log.add(got, numFrames);
+        }
+
+        if (numFrames == 0)
+        {
+            // Push the tail still inside the processor out with silence
+            if (framesToFlush == 0)
+                break;
+
+            numFrames = juce::jmin(options.blockSize, framesToFlush);
+            framesToFlush -= numFrames;
+            buffer.clear(0, numFrames);
+        }
+
+        // A view of the first numFrames, so a short last block doesn't reallocate
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numFrames);
+        processor->processBlock(block, midi);
+
+        const int skip = juce::jmin(framesToDrop, numFrames);
+        framesToDrop -= skip;
+
+        const float* channels[numChannels] = { buffer.getReadPointer(0, skip), buffer.getReadPointer(1, skip) };
+        const int numOut = numFrames - skip;
+        PcmFormat::interleave(options.format, channels, numChannels, numOut, outputBytes.data());
+
+        const auto outBytes = static_cast<size_t>(numOut) * static_cast<size_t>(frameBytes);
+        if (std::fwrite(outputBytes.data(), 1, outBytes, stdout) != outBytes)
+        {
+            // The reader went away (e.g. ffmpeg stopped early): not an error for a pipeline
+            break;
+        }
+    }
+
+    std::fflush(stdout);
+    log.report(" (total)");
+    return 0;
+}